@@ -40,19 +40,184 @@ gdouble retrieve_json_double(JsonReader* reader, gchar* key) {
  * @param reader A reader pointing to an object in the JSON file.
  * @param key Key within the object.
  * @param destination Character array into which the string value is copied. This character array must have previously been allocated.
+ * @param size Size of `destination`. Longer values are truncated.
  */
-void retrieve_json_string(JsonReader* reader, gchar* key, gchar* destination) {
+void retrieve_json_string(JsonReader* reader, gchar* key, gchar* destination, gsize size) {
 	json_reader_read_member(reader, key);
-	strcpy(destination, json_reader_get_string_value(reader));
+	g_strlcpy(destination, json_reader_get_string_value(reader), size);
 	json_reader_end_member(reader);
 }
 
+/**
+ * Reads the `front` and `back` stanzas of the configuration into a new layout.
+ * @param reader A reader pointing to the `configuration` object in the JSON file.
+ * @return Pointer to the layout, with one reference. Release with slip_layout_unref().
+ */
+static Slip_layout* read_slip_layout(JsonReader* reader) {
+	Slip_layout* layout = slip_layout_new();
+
+	json_reader_read_member(reader, "front");
+	layout->front.checks_other_items_label_x = retrieve_json_int(reader, "checks_other_items_label_x");
+	layout->front.checks_other_items_label_y = retrieve_json_int(reader, "checks_other_items_label_y");
+	layout->front.checks_other_items_font_size = retrieve_json_double(reader, "checks_other_items_font_size");
+
+	layout->front.deposit_label_y = retrieve_json_int(reader, "deposit_label_y");
+	layout->front.deposit_label_font_size = retrieve_json_int(reader, "deposit_label_font_size");
+
+	layout->front.date_name_address_label_x = retrieve_json_int(reader, "date_name_address_label_x");
+	layout->front.date_label_y = retrieve_json_int(reader, "date_label_y");
+	layout->front.name_label_y = retrieve_json_int(reader, "name_label_y");
+	layout->front.date_name_value_x = retrieve_json_int(reader, "date_name_value_x");
+	layout->front.date_value_y = retrieve_json_int(reader, "date_value_y");
+	layout->front.name_value_y = retrieve_json_int(reader, "name_value_y");
+
+	layout->front.date_name_line_x = retrieve_json_int(reader, "date_name_line_x");
+	layout->front.date_name_line_y = retrieve_json_int(reader, "date_name_line_y");
+	layout->front.date_line_length = retrieve_json_int(reader, "date_line_length");
+	layout->front.name_line_length = retrieve_json_int(reader, "name_line_length");
+
+	layout->front.address_label_y = retrieve_json_int(reader, "address_label_y");
+
+	layout->front.address_line_x = retrieve_json_int(reader, "address_line_x");
+	layout->front.date_name_address_label_font_size = retrieve_json_int(reader, "date_name_address_label_font_size");
+	layout->front.date_name_address_value_font_size = retrieve_json_int(reader, "date_name_address_value_font_size");
+
+	layout->front.account_number_label_y = retrieve_json_int(reader, "account_number_label_y");
+	layout->front.account_number_label_font_size = retrieve_json_double(reader, "account_number_label_font_size");
+
+	layout->front.account_number_human_value_x = retrieve_json_int(reader, "account_number_human_value_x");
+	layout->front.account_number_human_font_size = retrieve_json_int(reader, "account_number_human_font_size");
+	layout->front.account_number_human_value_y = retrieve_json_int(reader, "account_number_human_value_y");
+	layout->front.account_number_squares_x = retrieve_json_int(reader, "account_number_squares_x");
+	layout->front.account_number_squares_y = retrieve_json_int(reader, "account_number_squares_y");
+	layout->front.account_number_squares_width = retrieve_json_int(reader, "account_number_squares_width");
+	layout->front.account_number_squares_height = retrieve_json_int(reader, "account_number_squares_height");
+
+	layout->front.micr_routing_number_label_x = retrieve_json_int(reader, "micr_routing_number_label_x");
+	layout->front.micr_routing_number_label_y = retrieve_json_int(reader, "micr_routing_number_label_y");
+	layout->front.micr_account_number_label_x = retrieve_json_int(reader, "micr_account_number_label_x");
+	layout->front.micr_serial_number_label_x = retrieve_json_int(reader, "micr_serial_number_label_x");
+	layout->front.micr_font_size = retrieve_json_int(reader, "micr_font_size");
+
+	layout->front.cash_label_x = retrieve_json_int(reader, "cash_label_x");
+	layout->front.checks_label_x = retrieve_json_int(reader, "checks_label_x");
+	layout->front.checks_label_y = retrieve_json_int(reader, "checks_label_y");
+	layout->front.checks_label_spacing = retrieve_json_int(reader, "checks_label_spacing");
+	layout->front.subtotal_label_y = 0;
+	layout->front.less_cash_label_y = 0;
+	layout->front.net_deposit_label_x = retrieve_json_int(reader, "net_deposit_label_x");
+	layout->front.net_deposit_label_y = 0;
+	layout->front.cash_label_font_size = retrieve_json_int(reader, "cash_label_font_size");
+
+	layout->front.dollar_label_x = retrieve_json_int(reader, "dollar_label_x");
+	layout->front.dollar_label_y = retrieve_json_int(reader, "dollar_label_y");
+
+	layout->front.checks_bracket_right_x = retrieve_json_int(reader, "checks_bracket_right_x");
+	layout->front.checks_bracket_width = retrieve_json_int(reader, "checks_bracket_width");
+	layout->front.checks_bracket_height = retrieve_json_int(reader, "checks_bracket_height");
+	layout->front.checks_bracket_spacing = retrieve_json_int(reader, "checks_bracket_spacing");
+
+	layout->front.amount_boxes_x = retrieve_json_int(reader, "amount_boxes_x");
+	layout->front.amount_boxes_y = retrieve_json_int(reader, "amount_boxes_y");
+	layout->front.amount_boxes_width = retrieve_json_int(reader, "amount_boxes_width");
+	layout->front.amount_boxes_height = retrieve_json_int(reader, "amount_boxes_height");
+	layout->front.amount_boxes_separator_height = retrieve_json_int(reader, "amount_boxes_separator_height");
+
+	layout->front.first_amount_y = retrieve_json_int(reader, "first_amount_y");
+	layout->front.amount_pitch = retrieve_json_int(reader, "amount_pitch");
+	layout->front.subtotal_y = retrieve_json_int(reader, "subtotal_y");
+	layout->front.total_y = retrieve_json_int(reader, "total_y");
+	layout->front.amount_x = retrieve_json_int(reader, "amount_x");
+
+	/*
+		layout->front.date_name_address_label_x = retrieve_json_int(reader,"date_name_address_label_x");
+		layout->front.date_name_value_x = retrieve_json_int(reader,"date_name_value_x");
+		layout->front.name_value_y = retrieve_json_int(reader,"name_value_y");
+		layout->front.date_value_y = retrieve_json_int(reader,"date_value_y");
+		layout->front.micr_account_number_label_y = retrieve_json_int(reader,"micr_account_number_label_y");
+		layout->front.micr_account_number_label_x = retrieve_json_int(reader,"micr_account_number_label_x");
+		layout->front.first_amount_y = retrieve_json_int(reader,"first_amount_y");
+		layout->front.amount_pitch = retrieve_json_int(reader,"amount_pitch");
+		layout->front.subtotal_y = retrieve_json_int(reader,"subtotal_y");
+		layout->front.total_y = retrieve_json_int(reader,"total_y");
+		layout->front.amount_x = retrieve_json_int(reader,"amount_x");*/
+	json_reader_end_member(reader); /* front */
+
+	json_reader_read_member(reader, "back");
+
+	layout->back.currency_count_frame_top_x = retrieve_json_int(reader, "currency_count_frame_top_x");
+	layout->back.currency_count_frame_top_y = retrieve_json_int(reader, "currency_count_frame_top_y");
+	layout->back.currency_count_frame_width = retrieve_json_int(reader, "currency_count_frame_width");
+	layout->back.currency_count_frame_height = retrieve_json_int(reader, "currency_count_frame_height");
+
+	layout->back.currency_count_label_x = retrieve_json_int(reader, "currency_count_label_x");
+	layout->back.currency_count_label_y = retrieve_json_int(reader, "currency_count_label_y");
+	layout->back.currency_count_label_font_size = retrieve_json_int(reader, "currency_count_label_font_size");
+	layout->back.currency_count_top_line_x = retrieve_json_int(reader, "currency_count_top_line_x");
+	layout->back.currency_count_pitch = retrieve_json_int(reader, "currency_count_pitch");
+	layout->back.currency_count_line_left_y = retrieve_json_int(reader, "currency_count_line_left_y");
+	layout->back.currency_count_line_middle_y = retrieve_json_int(reader, "currency_count_line_middle_y");
+	layout->back.currency_count_line_right_y = retrieve_json_int(reader, "currency_count_line_right_y");
+	layout->back.multiplication_sign_x = retrieve_json_int(reader, "multiplication_sign_x");
+	layout->back.multiplication_sign_y = retrieve_json_int(reader, "multiplication_sign_y");
+	layout->back.total_x = retrieve_json_int(reader, "total_x");
+	layout->back.total_y = retrieve_json_int(reader, "total_y");
+	layout->back.total_font_size = retrieve_json_int(reader, "total_font_size");
+	layout->back.dollar_x = retrieve_json_int(reader, "dollar_x");
+	layout->back.denomination_x = retrieve_json_int(reader, "denomination_x");
+
+	layout->back.check_listing_top_x = retrieve_json_int(reader, "check_listing_top_x");
+	layout->back.check_listing_top_y = retrieve_json_int(reader, "check_listing_top_y");
+	layout->back.check_listing_width = retrieve_json_int(reader, "check_listing_width");
+	layout->back.check_listing_height = retrieve_json_int(reader, "check_listing_height");
+	layout->back.check_listing_horizontal_border_width = retrieve_json_int(reader, "check_listing_horizontal_border_width");
+	layout->back.check_listing_separator_length = retrieve_json_int(reader, "check_listing_separator_length");
+	layout->back.check_listing_separator_width = retrieve_json_int(reader, "check_listing_separator_width");
+	layout->back.check_listing_decimal_width = retrieve_json_int(reader, "check_listing_decimal_width");
+	layout->back.check_listing_check_number_line_length = retrieve_json_int(reader, "check_listing_check_number_line_length");
+	layout->back.dollars_cents_offset_x = retrieve_json_int(reader, "dollars_cents_offset_x");
+	layout->back.checks_offset_x = retrieve_json_int(reader, "checks_offset_x");
+	layout->back.list_singly_offset_x = retrieve_json_int(reader, "list_singly_offset_x");
+
+	layout->back.total_offset_x = retrieve_json_int(reader, "total_offset_x");
+	layout->back.must_be_entered_offset_x = retrieve_json_int(reader, "must_be_entered_offset_x");
+	layout->back.on_front_side_offset_x = retrieve_json_int(reader, "on_front_side_offset_x");
+	layout->back.must_be_entered_font_size = retrieve_json_int(reader, "must_be_entered_font_size");
+	json_reader_end_member(reader); /* back */
+	return layout;
+}
+
+/**
+ * Reads the slip's layout again from the configuration file, for example after the file was edited while the application is running.
+ * @return Pointer to the new layout, with one reference, or `NULL` if the file cannot be parsed.
+ */
+Slip_layout* read_slip_layout_file(void) {
+	GError* error = NULL;
+	JsonParser* parser = json_parser_new();
+
+	if (!json_parser_load_from_file(parser, CONFIG_FILE, &error)) {
+		g_print("Unable to parse `%s': %s\n", CONFIG_FILE, error->message);
+		g_error_free(error);
+		g_object_unref(parser);
+		return NULL;
+	}
+
+	JsonReader* reader = json_reader_new(json_parser_get_root(parser));
+	Slip_layout* layout = NULL;
+	if (json_reader_read_member(reader, "configuration")) {
+		layout = read_slip_layout(reader);
+	}
+	json_reader_end_member(reader); /* configuration */
+	g_object_unref(reader);
+	g_object_unref(parser);
+	return layout;
+}
+
 /**
  * Reads configuration from a JSON file whose path is defined in CONFIG_FILE.
  * @param data_passer Pointer to user data.
  */
 void read_configuration_data(Data_passer* data_passer) {
-	GSList* local_struct_list = NULL;
 	JsonParser* parser;
 	GError* error = NULL;
 
@@ -81,6 +246,7 @@ void read_configuration_data(Data_passer* data_passer) {
 
 	json_reader_read_member(reader, "accounts");
 	guint len = json_reader_count_elements(reader);
+	Account_table* accounts = data_passer->account_table; /* Kept for the life of the application; the list stores point into it. */
 
 	/* Would be better to put this in a function json_array_foreach_element */
 	for (int i = 0; i < len; i++) {
@@ -104,21 +270,22 @@ void read_configuration_data(Data_passer* data_passer) {
 
 		json_reader_end_element(reader); /* End reading account element. */
 
-		Account* account_entry = (Account*)g_malloc(sizeof(Account));
-		g_strlcpy(account_entry->number, account, -1);
-		g_strlcpy(account_entry->name, name, -1);
-		g_strlcpy(account_entry->description, description, -1);
-		g_strlcpy(account_entry->routing, routing, -1);
-
-		local_struct_list = g_slist_append(local_struct_list, account_entry);
+		account_table_add(accounts, account, name, description, routing);
 	}
 
 	json_reader_end_member(reader); /* End reading the accounts stanza*/
 
-	/* Place items in the temporary account list into list_builder. */
-	g_slist_foreach(local_struct_list, build_list_store, data_passer->list_store_master);
-	g_slist_foreach(local_struct_list, build_list_store, data_passer->list_store_temporary);
-	g_slist_free_full(local_struct_list, (GDestroyNotify)free_gslist_account);
+	/* Report every account whose account or routing number is malformed. The accounts are still loaded, so they can be corrected in the Accounts tab. */
+	GArray* problems = account_validation_run(accounts);
+	for (guint i = 0; i < problems->len; i++) {
+		Account_problem* problem = &g_array_index(problems, Account_problem, i);
+		g_print("Account %u in `%s': %s\n", problem->row, CONFIG_FILE, account_problem_description(problem->type));
+	}
+	g_array_unref(problems);
+
+	/* Place the accounts in the master and temporary stores. */
+	build_list_store(accounts, data_passer->list_store_master);
+	build_list_store(accounts, data_passer->list_store_temporary);
 
 	/* Read the configuration parameters. */
 	json_reader_read_member(reader, "configuration");
@@ -126,160 +293,30 @@ void read_configuration_data(Data_passer* data_passer) {
 	data_passer->font_size_sans_serif = retrieve_json_int(reader, "font_size_sans_serif");
 	data_passer->font_size_monospace = retrieve_json_int(reader, "font_size_monospace");
 	data_passer->font_size_static_label_scaling = retrieve_json_int(reader, "font_size_static_label_scaling");
-	retrieve_json_string(reader, "font_family_sans", data_passer->font_family_sans);
-	retrieve_json_string(reader, "font_face_micr", data_passer->font_face_micr);
-	retrieve_json_string(reader, "font_family_mono", data_passer->font_family_mono);
-
-	json_reader_read_member(reader, "front");
-	data_passer->front->checks_other_items_label_x = retrieve_json_int(reader, "checks_other_items_label_x");
-	data_passer->front->checks_other_items_label_y = retrieve_json_int(reader, "checks_other_items_label_y");
-	data_passer->front->checks_other_items_font_size = retrieve_json_double(reader, "checks_other_items_font_size");
-
-	data_passer->front->deposit_label_y = retrieve_json_int(reader, "deposit_label_y");
-	data_passer->front->deposit_label_font_size = retrieve_json_int(reader, "deposit_label_font_size");
-
-	data_passer->front->date_name_address_label_x = retrieve_json_int(reader, "date_name_address_label_x");
-	data_passer->front->date_label_y = retrieve_json_int(reader, "date_label_y");
-	data_passer->front->name_label_y = retrieve_json_int(reader, "name_label_y");
-	data_passer->front->date_name_value_x = retrieve_json_int(reader, "date_name_value_x");
-	data_passer->front->date_value_y = retrieve_json_int(reader, "date_value_y");
-	data_passer->front->name_value_y = retrieve_json_int(reader, "name_value_y");
-
-	data_passer->front->date_name_line_x = retrieve_json_int(reader, "date_name_line_x");
-	data_passer->front->date_name_line_y = retrieve_json_int(reader, "date_name_line_y");
-	data_passer->front->date_line_length = retrieve_json_int(reader, "date_line_length");
-	data_passer->front->name_line_length = retrieve_json_int(reader, "name_line_length");
-
-	data_passer->front->address_label_y = retrieve_json_int(reader, "address_label_y");
-
-	data_passer->front->address_line_x = retrieve_json_int(reader, "address_line_x");
-	data_passer->front->date_name_address_label_font_size = retrieve_json_int(reader, "date_name_address_label_font_size");
-	data_passer->front->date_name_address_value_font_size = retrieve_json_int(reader, "date_name_address_value_font_size");
-
-	data_passer->front->account_number_label_y = retrieve_json_int(reader, "account_number_label_y");
-	data_passer->front->account_number_label_font_size = retrieve_json_double(reader, "account_number_label_font_size");
-
-	data_passer->front->account_number_human_value_x = retrieve_json_int(reader, "account_number_human_value_x");
-	data_passer->front->account_number_human_font_size = retrieve_json_int(reader, "account_number_human_font_size");
-	data_passer->front->account_number_human_value_y = retrieve_json_int(reader, "account_number_human_value_y");
-	data_passer->front->account_number_squares_x = retrieve_json_int(reader, "account_number_squares_x");
-	data_passer->front->account_number_squares_y = retrieve_json_int(reader, "account_number_squares_y");
-	data_passer->front->account_number_squares_width = retrieve_json_int(reader, "account_number_squares_width");
-	data_passer->front->account_number_squares_height = retrieve_json_int(reader, "account_number_squares_height");
-
-	data_passer->front->micr_routing_number_label_x = retrieve_json_int(reader, "micr_routing_number_label_x");
-	data_passer->front->micr_routing_number_label_y = retrieve_json_int(reader, "micr_routing_number_label_y");
-	data_passer->front->micr_account_number_label_x = retrieve_json_int(reader, "micr_account_number_label_x");
-	data_passer->front->micr_serial_number_label_x = retrieve_json_int(reader, "micr_serial_number_label_x");
-	data_passer->front->micr_font_size = retrieve_json_int(reader, "micr_font_size");
-
-	data_passer->front->cash_label_x = retrieve_json_int(reader, "cash_label_x");
-	data_passer->front->checks_label_x = retrieve_json_int(reader, "checks_label_x");
-	data_passer->front->checks_label_y = retrieve_json_int(reader, "checks_label_y");
-	data_passer->front->checks_label_spacing = retrieve_json_int(reader, "checks_label_spacing");
-	data_passer->front->subtotal_label_y = 0;
-	data_passer->front->less_cash_label_y = 0;
-	data_passer->front->net_deposit_label_x = retrieve_json_int(reader, "net_deposit_label_x");
-	data_passer->front->net_deposit_label_y = 0;
-	data_passer->front->cash_label_font_size = retrieve_json_int(reader, "cash_label_font_size");
-
-	data_passer->front->dollar_label_x = retrieve_json_int(reader, "dollar_label_x");
-	data_passer->front->dollar_label_y = retrieve_json_int(reader, "dollar_label_y");
-
-	data_passer->front->checks_bracket_right_x = retrieve_json_int(reader, "checks_bracket_right_x");
-	data_passer->front->checks_bracket_width = retrieve_json_int(reader, "checks_bracket_width");
-	data_passer->front->checks_bracket_height = retrieve_json_int(reader, "checks_bracket_height");
-	data_passer->front->checks_bracket_spacing = retrieve_json_int(reader, "checks_bracket_spacing");
-
-	data_passer->front->amount_boxes_x = retrieve_json_int(reader, "amount_boxes_x");
-	data_passer->front->amount_boxes_y = retrieve_json_int(reader, "amount_boxes_y");
-	data_passer->front->amount_boxes_width = retrieve_json_int(reader, "amount_boxes_width");
-	data_passer->front->amount_boxes_height = retrieve_json_int(reader, "amount_boxes_height");
-	data_passer->front->amount_boxes_separator_height = retrieve_json_int(reader, "amount_boxes_separator_height");
-
-	data_passer->front->first_amount_y = retrieve_json_int(reader, "first_amount_y");
-	data_passer->front->amount_pitch = retrieve_json_int(reader, "amount_pitch");
-	data_passer->front->subtotal_y = retrieve_json_int(reader, "subtotal_y");
-	data_passer->front->total_y = retrieve_json_int(reader, "total_y");
-	data_passer->front->amount_x = retrieve_json_int(reader, "amount_x");
+	retrieve_json_string(reader, "font_family_sans", data_passer->font_family_sans, sizeof(data_passer->font_family_sans));
+	retrieve_json_string(reader, "font_face_micr", data_passer->font_face_micr, sizeof(data_passer->font_face_micr));
+	retrieve_json_string(reader, "font_family_mono", data_passer->font_family_mono, sizeof(data_passer->font_family_mono));
 
-	/*
-		data_passer->front->date_name_address_label_x = retrieve_json_int(reader,"date_name_address_label_x");
-		data_passer->front->date_name_value_x = retrieve_json_int(reader,"date_name_value_x");
-		data_passer->front->name_value_y = retrieve_json_int(reader,"name_value_y");
-		data_passer->front->date_value_y = retrieve_json_int(reader,"date_value_y");
-		data_passer->front->micr_account_number_label_y = retrieve_json_int(reader,"micr_account_number_label_y");
-		data_passer->front->micr_account_number_label_x = retrieve_json_int(reader,"micr_account_number_label_x");
-		data_passer->front->first_amount_y = retrieve_json_int(reader,"first_amount_y");
-		data_passer->front->amount_pitch = retrieve_json_int(reader,"amount_pitch");
-		data_passer->front->subtotal_y = retrieve_json_int(reader,"subtotal_y");
-		data_passer->front->total_y = retrieve_json_int(reader,"total_y");
-		data_passer->front->amount_x = retrieve_json_int(reader,"amount_x");*/
-	json_reader_end_member(reader); /* front */
-
-	json_reader_read_member(reader, "back");
-
-	data_passer->back->currency_count_frame_top_x = retrieve_json_int(reader, "currency_count_frame_top_x");
-	data_passer->back->currency_count_frame_top_y = retrieve_json_int(reader, "currency_count_frame_top_y");
-	data_passer->back->currency_count_frame_width = retrieve_json_int(reader, "currency_count_frame_width");
-	data_passer->back->currency_count_frame_height = retrieve_json_int(reader, "currency_count_frame_height");
-
-	data_passer->back->currency_count_label_x = retrieve_json_int(reader, "currency_count_label_x");
-	data_passer->back->currency_count_label_y = retrieve_json_int(reader, "currency_count_label_y");
-	data_passer->back->currency_count_label_font_size = retrieve_json_int(reader, "currency_count_label_font_size");
-	data_passer->back->currency_count_top_line_x = retrieve_json_int(reader, "currency_count_top_line_x");
-	data_passer->back->currency_count_pitch = retrieve_json_int(reader, "currency_count_pitch");
-	data_passer->back->currency_count_line_left_y = retrieve_json_int(reader, "currency_count_line_left_y");
-	data_passer->back->currency_count_line_middle_y = retrieve_json_int(reader, "currency_count_line_middle_y");
-	data_passer->back->currency_count_line_right_y = retrieve_json_int(reader, "currency_count_line_right_y");
-	data_passer->back->multiplication_sign_x = retrieve_json_int(reader, "multiplication_sign_x");
-	data_passer->back->multiplication_sign_y = retrieve_json_int(reader, "multiplication_sign_y");
-	data_passer->back->total_x = retrieve_json_int(reader, "total_x");
-	data_passer->back->total_y = retrieve_json_int(reader, "total_y");
-	data_passer->back->total_font_size = retrieve_json_int(reader, "total_font_size");
-	data_passer->back->dollar_x = retrieve_json_int(reader, "dollar_x");
-	data_passer->back->denomination_x = retrieve_json_int(reader, "denomination_x");
-
-	data_passer->back->check_listing_top_x = retrieve_json_int(reader, "check_listing_top_x");
-	data_passer->back->check_listing_top_y = retrieve_json_int(reader, "check_listing_top_y");
-	data_passer->back->check_listing_width = retrieve_json_int(reader, "check_listing_width");
-	data_passer->back->check_listing_height = retrieve_json_int(reader, "check_listing_height");
-	data_passer->back->check_listing_horizontal_border_width = retrieve_json_int(reader, "check_listing_horizontal_border_width");
-	data_passer->back->check_listing_separator_length = retrieve_json_int(reader, "check_listing_separator_length");
-	data_passer->back->check_listing_separator_width = retrieve_json_int(reader, "check_listing_separator_width");
-	data_passer->back->check_listing_decimal_width = retrieve_json_int(reader, "check_listing_decimal_width");
-	data_passer->back->check_listing_check_number_line_length = retrieve_json_int(reader, "check_listing_check_number_line_length");
-	data_passer->back->dollars_cents_offset_x = retrieve_json_int(reader, "dollars_cents_offset_x");
-	data_passer->back->checks_offset_x = retrieve_json_int(reader, "checks_offset_x");
-	data_passer->back->list_singly_offset_x = retrieve_json_int(reader, "list_singly_offset_x");
-
-	data_passer->back->total_offset_x = retrieve_json_int(reader, "total_offset_x");
-	data_passer->back->must_be_entered_offset_x = retrieve_json_int(reader, "must_be_entered_offset_x");
-	data_passer->back->on_front_side_offset_x = retrieve_json_int(reader, "on_front_side_offset_x");
-	data_passer->back->must_be_entered_font_size = retrieve_json_int(reader, "must_be_entered_font_size");
-	json_reader_end_member(reader); /* back */
+	data_passer->layout = read_slip_layout(reader);
 	json_reader_end_member(reader); /* configuration */
 	g_object_unref(reader);
+	g_object_unref(parser);
 }
 /**
- * Callback fired while iterating over each member of a `GSList` of list of
- * accounts read from disk. The accounts are added to the passed `ListStore`.
- * @param account List of accounts in a `GSList`.
- * @param data The ListStore into which the accounts are copied.
+ * Adds the accounts read from disk to the passed `ListStore`. The store holds the offsets of the accounts' strings in the table,
+ * not copies of them. Each account is added in a single insertion, so the store emits one signal per account.
+ * @param table Table of accounts read from disk.
+ * @param list_store The ListStore into which the accounts are copied.
  */
-void build_list_store(gpointer account, gpointer data) {
-	GtkListStore* list_store = GTK_LIST_STORE(data);
-	GtkTreeIter iter;
-
-	Account* local_account = (Account*)account;
-
-	gtk_list_store_append(list_store, &iter);
-
-	gtk_list_store_set(list_store, &iter,
-					   ACCOUNT_NUMBER, local_account->number,
-					   ACCOUNT_NAME, local_account->name,
-					   DESCRIPTION, local_account->description,
-					   ROUTING_NUMBER, local_account->routing,
-					   CHECKBOX, FALSE,
-					   -1);
+void build_list_store(const Account_table* table, GtkListStore* list_store) {
+	for (guint i = 0; i < table->accounts->len; i++) {
+		const Account* account = &g_array_index(table->accounts, Account, i);
+		gtk_list_store_insert_with_values(list_store, NULL, -1,
+										  ACCOUNT_NUMBER, account->number,
+										  ACCOUNT_NAME, account->name,
+										  DESCRIPTION, account->description,
+										  ROUTING_NUMBER, account->routing,
+										  CHECKBOX, FALSE,
+										  -1);
+	}
 }
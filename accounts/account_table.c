@@ -0,0 +1,176 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file account_table.c
+ * @brief Table of accounts read from the configuration file, with every string interned in one arena.
+ *
+ * Each \ref Account holds four offsets into the table's string arena instead of four fixed-size buffers. A string that appears
+ * more than once, such as a bank's routing number or an account holder's name, is stored once. The table lives as long as the
+ * application, in \ref Data_passer.account_table. The master and temporary list stores hold the same offsets instead of copies of
+ * the strings, and the views read the strings through account_table_column().
+ *
+ * Edits in the Accounts tab add strings to the end of the arena, and deleting or reverting accounts leaves strings no row uses.
+ * After each change the table is rebuilt from the stores with account_table_rebuild(). The master store is interned first, in
+ * row order, so its offsets do not change and only rows of the temporary store after the change are rewritten.
+ */
+
+/** Offset of the empty string, stored first in every arena. */
+#define ACCOUNT_TABLE_EMPTY 0
+
+/**
+ * Creates an empty account table.
+ * @return Pointer to the table. Free with account_table_free().
+ */
+Account_table *account_table_new(void) {
+	Account_table *table = g_new0(Account_table, 1);
+	table->strings_capacity = 4096;
+	table->strings = g_malloc(table->strings_capacity);
+	table->strings[ACCOUNT_TABLE_EMPTY] = '\0';
+	table->strings_length = 1;
+	table->accounts = g_array_new(FALSE, FALSE, sizeof(Account));
+	table->interned = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	return table;
+}
+
+/**
+ * Returns the offset of a string in the arena, copying it into the arena the first time it is seen. Copying may move the arena,
+ * so strings returned earlier by account_table_string() are no longer valid.
+ * @param table Pointer to the table.
+ * @param text String to intern. `NULL` is stored as the empty string.
+ * @return Offset of the string in \ref Account_table.strings.
+ */
+guint32 account_table_intern(Account_table *table, const gchar *text) {
+	if (text == NULL || text[0] == '\0') {
+		return ACCOUNT_TABLE_EMPTY;
+	}
+
+	gpointer offset;
+	if (g_hash_table_lookup_extended(table->interned, text, NULL, &offset)) {
+		return GPOINTER_TO_UINT(offset);
+	}
+
+	gsize length = strlen(text) + 1;
+	if (table->strings_length + length > table->strings_capacity) {
+		table->strings_capacity = MAX(table->strings_capacity * 2, table->strings_length + length);
+		table->strings = g_realloc(table->strings, table->strings_capacity);
+	}
+	guint32 new_offset = table->strings_length;
+	memcpy(table->strings + new_offset, text, length);
+	table->strings_length += length;
+
+	g_hash_table_insert(table->interned, g_strdup(text), GUINT_TO_POINTER(new_offset));
+	return new_offset;
+}
+
+/**
+ * Adds an account to the end of the table.
+ * @param table Pointer to the table.
+ * @param number Account number.
+ * @param name Account holder's name.
+ * @param description Informal description of the account.
+ * @param routing Routing number.
+ */
+void account_table_add(Account_table *table, const gchar *number, const gchar *name, const gchar *description, const gchar *routing) {
+	Account account;
+	account.number = account_table_intern(table, number);
+	account.name = account_table_intern(table, name);
+	account.description = account_table_intern(table, description);
+	account.routing = account_table_intern(table, routing);
+	g_array_append_val(table->accounts, account);
+}
+
+/**
+ * Returns a string in the table.
+ * @param table Pointer to the table.
+ * @param offset Offset of the string, one of the fields of an \ref Account.
+ * @return The string, valid until a string is added to the table or the table is rebuilt.
+ */
+const gchar *account_table_string(const Account_table *table, guint32 offset) {
+	return table->strings + offset;
+}
+
+/**
+ * Returns one of the strings of an account in the master or temporary list store.
+ * @param table Pointer to the table the store's offsets point into.
+ * @param model Pointer to the store.
+ * @param iter Pointer to the account's row.
+ * @param column \ref ACCOUNT_NUMBER, \ref ACCOUNT_NAME, \ref DESCRIPTION, or \ref ROUTING_NUMBER.
+ * @return The string, valid until a string is added to the table or the table is rebuilt.
+ */
+const gchar *account_table_column(const Account_table *table, GtkTreeModel *model, GtkTreeIter *iter, gint column) {
+	guint offset;
+	gtk_tree_model_get(model, iter, column, &offset, -1);
+	return account_table_string(table, offset);
+}
+
+/**
+ * Interns the strings of every row of a store into a new table, and rewrites the rows whose offsets changed.
+ * @param old_table Pointer to the table the store's offsets point into.
+ * @param table Pointer to the new table.
+ * @param store The master or temporary list store.
+ * @param add_accounts Whether to also add the rows to the new table's accounts.
+ */
+static void move_store(const Account_table *old_table, Account_table *table, GtkListStore *store, gboolean add_accounts) {
+	GtkTreeModel *model = GTK_TREE_MODEL(store);
+	GtkTreeIter iter;
+	gboolean valid = gtk_tree_model_get_iter_first(model, &iter);
+
+	while (valid) {
+		Account old_account;
+		gtk_tree_model_get(model, &iter,
+						   ACCOUNT_NUMBER, &old_account.number,
+						   ACCOUNT_NAME, &old_account.name,
+						   DESCRIPTION, &old_account.description,
+						   ROUTING_NUMBER, &old_account.routing,
+						   -1);
+
+		Account account;
+		account.number = account_table_intern(table, account_table_string(old_table, old_account.number));
+		account.name = account_table_intern(table, account_table_string(old_table, old_account.name));
+		account.description = account_table_intern(table, account_table_string(old_table, old_account.description));
+		account.routing = account_table_intern(table, account_table_string(old_table, old_account.routing));
+		if (add_accounts) {
+			g_array_append_val(table->accounts, account);
+		}
+
+		if (memcmp(&account, &old_account, sizeof(Account)) != 0) {
+			gtk_list_store_set(store, &iter,
+							   ACCOUNT_NUMBER, account.number,
+							   ACCOUNT_NAME, account.name,
+							   DESCRIPTION, account.description,
+							   ROUTING_NUMBER, account.routing,
+							   -1);
+		}
+		valid = gtk_tree_model_iter_next(model, &iter);
+	}
+}
+
+/**
+ * Rebuilds \ref Data_passer.account_table from the master and temporary list stores after the Accounts tab changes, so strings
+ * no row uses any more are dropped. The new table's accounts are the rows of the master store.
+ * @param data_passer Pointer to user data.
+ */
+void account_table_rebuild(Data_passer *data_passer) {
+	Account_table *old_table = data_passer->account_table;
+	Account_table *table = account_table_new();
+
+	move_store(old_table, table, data_passer->list_store_master, TRUE);
+	move_store(old_table, table, data_passer->list_store_temporary, FALSE);
+
+	data_passer->account_table = table;
+	account_table_free(old_table);
+}
+
+/**
+ * Frees a table.
+ * @param table Pointer to the table.
+ */
+void account_table_free(Account_table *table) {
+	g_hash_table_destroy(table->interned);
+	g_array_unref(table->accounts);
+	g_free(table->strings);
+	g_free(table);
+}
@@ -0,0 +1,162 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file account_validation.c
+ * @brief Checks the account and routing numbers of imported accounts.
+ *
+ * Validation runs over the whole account table in batches. Digits are checked eight bytes at a time in a 64-bit word, with a
+ * byte-by-byte loop for the remainder. Routing numbers that are nine digits are copied into one column per digit position, and
+ * the ABA checksum is computed down the columns, a loop the compiler can vectorize. Every problem found is reported with the
+ * row it is on.
+ */
+
+/** Number of accounts whose routing numbers are checksummed together. */
+#define VALIDATION_BATCH 256
+
+/** Fewest digits in an account number. */
+#define ACCOUNT_NUMBER_MIN_DIGITS 4
+
+/** Most digits in an account number, the length of the account number field on a check. */
+#define ACCOUNT_NUMBER_MAX_DIGITS 17
+
+/** Digits in a routing number. */
+#define ROUTING_NUMBER_DIGITS 9
+
+/**
+ * Determines whether every byte of text is an ASCII digit. Eight bytes are tested at a time: a byte is a digit if its high
+ * nibble is 3 and adding 6 to it leaves the high nibble at 3.
+ * @param text Text to test.
+ * @param length Number of bytes to test.
+ * @return `TRUE` if all bytes are digits.
+ */
+static gboolean all_digits(const gchar *text, gsize length) {
+	gsize i = 0;
+	for (; i + 8 <= length; i += 8) {
+		guint64 word;
+		memcpy(&word, text + i, sizeof(word));
+		guint64 high_nibbles = word & 0xF0F0F0F0F0F0F0F0ull;
+		guint64 carried = ((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4;
+		if ((high_nibbles | carried) != 0x3333333333333333ull) {
+			return FALSE;
+		}
+	}
+	for (; i < length; i++) {
+		if (!g_ascii_isdigit(text[i])) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Records a problem.
+ * @param problems Array of \ref Account_problem.
+ * @param row Row of the account.
+ * @param type The problem.
+ */
+static void add_problem(GArray *problems, guint row, Account_problem_type type) {
+	Account_problem problem = {row, type};
+	g_array_append_val(problems, problem);
+}
+
+/**
+ * Compares two problems by row, for sorting. Problems on the same row keep the order of \ref Account_problem_type.
+ * @param a Pointer to the first problem.
+ * @param b Pointer to the second problem.
+ * @return Negative, zero, or positive as the first problem comes before, with, or after the second.
+ */
+static gint compare_problems(gconstpointer a, gconstpointer b) {
+	const Account_problem *first = a;
+	const Account_problem *second = b;
+	if (first->row != second->row) {
+		return (first->row > second->row) - (first->row < second->row);
+	}
+	return (gint)first->type - (gint)second->type;
+}
+
+/**
+ * Checks the account numbers and routing numbers of a table of accounts. Placeholder values of new accounts, such as
+ * `(Number)`, are reported like any other text that is not digits.
+ * @param table Pointer to the table of accounts.
+ * @return Array of \ref Account_problem in row order, empty if every account is valid. Free with `g_array_unref()`.
+ */
+GArray *account_validation_run(const Account_table *table) {
+	const Account *accounts = (const Account *)table->accounts->data;
+	gsize n_accounts = table->accounts->len;
+	GArray *problems = g_array_new(FALSE, FALSE, sizeof(Account_problem));
+
+	/* Digits of the batch's routing numbers, one column per digit position. */
+	guint8 digits[ROUTING_NUMBER_DIGITS][VALIDATION_BATCH];
+	/* Row of each routing number in the columns. */
+	guint rows[VALIDATION_BATCH];
+
+	for (gsize batch_start = 0; batch_start < n_accounts; batch_start += VALIDATION_BATCH) {
+		gsize batch_end = MIN(batch_start + VALIDATION_BATCH, n_accounts);
+		gsize n_routing = 0;
+
+		for (gsize row = batch_start; row < batch_end; row++) {
+			const gchar *number = account_table_string(table, accounts[row].number);
+			const gchar *routing = account_table_string(table, accounts[row].routing);
+
+			gsize number_length = strlen(number);
+			if (!all_digits(number, number_length)) {
+				add_problem(problems, row, ACCOUNT_PROBLEM_NUMBER_NOT_DIGITS);
+			} else if (number_length < ACCOUNT_NUMBER_MIN_DIGITS || number_length > ACCOUNT_NUMBER_MAX_DIGITS) {
+				add_problem(problems, row, ACCOUNT_PROBLEM_NUMBER_LENGTH);
+			}
+
+			gsize routing_length = strlen(routing);
+			if (!all_digits(routing, routing_length)) {
+				add_problem(problems, row, ACCOUNT_PROBLEM_ROUTING_NOT_DIGITS);
+			} else if (routing_length != ROUTING_NUMBER_DIGITS) {
+				add_problem(problems, row, ACCOUNT_PROBLEM_ROUTING_LENGTH);
+			} else {
+				for (gint position = 0; position < ROUTING_NUMBER_DIGITS; position++) {
+					digits[position][n_routing] = routing[position] - '0';
+				}
+				rows[n_routing++] = row;
+			}
+		}
+
+		/* ABA checksum down the columns: weights 3, 7, 1 repeated across the nine digits. */
+		guint16 sums[VALIDATION_BATCH];
+		for (gsize i = 0; i < n_routing; i++) {
+			sums[i] = 3 * (digits[0][i] + digits[3][i] + digits[6][i]) +
+					  7 * (digits[1][i] + digits[4][i] + digits[7][i]) +
+					  (digits[2][i] + digits[5][i] + digits[8][i]);
+		}
+		for (gsize i = 0; i < n_routing; i++) {
+			if (sums[i] % 10 != 0) {
+				add_problem(problems, rows[i], ACCOUNT_PROBLEM_ROUTING_CHECKSUM);
+			}
+		}
+	}
+
+	/* Checksum problems are found after the batch's format problems, so restore row order. */
+	g_array_sort(problems, compare_problems);
+	return problems;
+}
+
+/**
+ * Returns a description of a problem, for reporting it.
+ * @param type The problem.
+ * @return Description of the problem.
+ */
+const gchar *account_problem_description(Account_problem_type type) {
+	switch (type) {
+	case ACCOUNT_PROBLEM_NUMBER_NOT_DIGITS:
+		return "account number is not all digits";
+	case ACCOUNT_PROBLEM_NUMBER_LENGTH:
+		return "account number is not 4 to 17 digits";
+	case ACCOUNT_PROBLEM_ROUTING_NOT_DIGITS:
+		return "routing number is not all digits";
+	case ACCOUNT_PROBLEM_ROUTING_LENGTH:
+		return "routing number is not 9 digits";
+	case ACCOUNT_PROBLEM_ROUTING_CHECKSUM:
+		return "routing number fails the checksum";
+	}
+	return "unknown problem";
+}
@@ -13,18 +13,20 @@
 /**
 	Adds a row to the tree model after user clicks the Add button.
 	@param widget Pointer to the clicked Add button.
-	@param data Pointer to the temporary list store.
+	@param data Pointer to the data passer.
 */
 static void add_row(GtkWidget *widget, gpointer data) {
-	GtkListStore *list_store = (GtkListStore *)data;
+	Data_passer *data_passer = (Data_passer *)data;
+	GtkListStore *list_store = data_passer->list_store_temporary;
+	Account_table *table = data_passer->account_table;
 
 	GtkTreeIter iter;
 	gtk_list_store_append(list_store, &iter);
 	gtk_list_store_set(list_store, &iter,
-					   ACCOUNT_NUMBER, NEW_NUMBER,
-					   ACCOUNT_NAME, NEW_NAME,
-					   DESCRIPTION, NEW_DESCRIPTION,
-					   ROUTING_NUMBER, NEW_ROUTING,
+					   ACCOUNT_NUMBER, account_table_intern(table, NEW_NUMBER),
+					   ACCOUNT_NAME, account_table_intern(table, NEW_NAME),
+					   DESCRIPTION, account_table_intern(table, NEW_DESCRIPTION),
+					   ROUTING_NUMBER, account_table_intern(table, NEW_ROUTING),
 					   CHECKBOX, FALSE,
 					   -1);
 	GtkWidget *accounts_buttons_hbox = gtk_widget_get_parent(widget);
@@ -33,30 +35,34 @@ static void add_row(GtkWidget *widget, gpointer data) {
 }
 
 /**
-Deletes a checked row from the model (and reflected in the treeview) after user clicks the Delete button. Inspiration for this loop is from [198. How to iterate through a GtkListStore - Part 2?](https://www.kksou.com/php-gtk2/sample-codes/iterate-through-a-GtkListStore-Part-2.php).
+	Replaces the temporary store with another one. The accounts view is detached while the selection set moves to the new
+	store, and is then attached to the new store, so the view lays itself out once.
+	@param data_passer Pointer to the data passer.
+	@param list_store The new store. The data passer takes over the caller's reference.
+*/
+static void set_temporary_store(Data_passer *data_passer, GtkListStore *list_store) {
+	gtk_tree_view_set_model(GTK_TREE_VIEW(data_passer->accounts_tree_view), NULL);
+
+	selection_set_free(data_passer->account_selection);
+	g_object_unref(data_passer->list_store_temporary);
+
+	data_passer->list_store_temporary = list_store;
+	data_passer->account_selection = selection_set_new(list_store, CHECKBOX, data_passer->btn_accounts_delete);
+
+	gtk_tree_view_set_model(GTK_TREE_VIEW(data_passer->accounts_tree_view), GTK_TREE_MODEL(list_store));
+}
+
+/**
+Deletes the checked rows from the model (and reflected in the treeview) after user clicks the Delete button. The unchecked rows are copied into a new store in one pass, which then replaces the temporary store, so deleting thousands of rows does not emit thousands of `row-deleted` signals. The account table is then rebuilt without the strings only the deleted rows used.
 
 	@param widget Pointer to the clicked Delete button.
-	@param data Pointer to the temporary list store.
+	@param data Pointer to the data passer.
 */
 static void delete_row(GtkWidget *widget, gpointer data) {
-	GtkListStore *list_store = (GtkListStore *)data;
-	GtkTreeIter iter;
-	GValue gvalue = G_VALUE_INIT;
-	gboolean still_in_list = TRUE;
-	gboolean removed_last_row = FALSE;
-	gtk_tree_model_get_iter_first(GTK_TREE_MODEL(data), &iter);
-
-	do {
-		gtk_tree_model_get_value(GTK_TREE_MODEL(data), &iter, CHECKBOX, &gvalue);
-		if (g_value_get_boolean(&gvalue) == TRUE) {
-			removed_last_row = !gtk_list_store_remove(list_store, &iter);
-		}
-		g_value_unset(&gvalue);
-		if (!removed_last_row) {
-			still_in_list = gtk_tree_model_iter_next(GTK_TREE_MODEL(data), &iter);
-		}
+	Data_passer *data_passer = (Data_passer *)data;
 
-	} while (still_in_list && !removed_last_row);
+	set_temporary_store(data_passer, selection_set_copy_unmarked(data_passer->account_selection));
+	account_table_rebuild(data_passer);
 
 	GtkWidget *accounts_buttons_hbox = gtk_widget_get_parent(widget);
 	GtkWidget *account_button_revert = get_child_from_parent(accounts_buttons_hbox, BUTTON_NAME_REVERT);
@@ -68,7 +74,8 @@ static void delete_row(GtkWidget *widget, gpointer data) {
 
 	The listing in the Accounts tab reflects what is in the temporary store. The master store retains
 	the listing that was read from disk or last written to disk. This function clears the temporary
-	store, and then copies the contents of the master store into the temporary store.
+	store, and then copies the contents of the master store into the temporary store. Both stores hold offsets into the account
+	table, so the offsets are copied, and the table is then rebuilt without the strings of the discarded edits.
 	@param widget Pointer to the clicked button.
 	@param data Pointer to the data passer.
 */
@@ -83,11 +90,11 @@ static void revert_listing(GtkWidget *widget, gpointer data) {
 	gboolean found_first_iter_master = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(data_passer->list_store_master), &iter_master);
 
 	if (found_first_iter_master) {
-		/* gchar pointers for reading the entries from the master store */
-		gchar *account_number = NULL;
-		gchar *account_name = NULL;
-		gchar *account_description = NULL;
-		gchar *routing_number = NULL;
+		/* Offsets of the entry's strings in the account table */
+		guint account_number;
+		guint account_name;
+		guint account_description;
+		guint routing_number;
 
 		while (gtk_list_store_iter_is_valid(data_passer->list_store_master, &iter_master)) {
 			gtk_tree_model_get(GTK_TREE_MODEL(data_passer->list_store_master), &iter_master,
@@ -109,15 +116,10 @@ static void revert_listing(GtkWidget *widget, gpointer data) {
 
 			gtk_tree_model_iter_next(GTK_TREE_MODEL(data_passer->list_store_master), &iter_master);
 		}
-		g_free(account_number);
-		g_free(account_name);
-		g_free(account_description);
-		g_free(routing_number);
+		account_table_rebuild(data_passer);
 		GtkWidget *accounts_buttons_hbox = gtk_widget_get_parent(widget);
 		GtkWidget *account_button_revert = get_child_from_parent(accounts_buttons_hbox, BUTTON_NAME_REVERT);
 		gtk_widget_set_sensitive(account_button_revert, FALSE);
-		GtkWidget *account_button_delete = get_child_from_parent(accounts_buttons_hbox, BUTTON_NAME_DELETE);
-		gtk_widget_set_sensitive(account_button_delete, FALSE);
 	} else {
 		g_print("Could not find first iter for reverting the temporary list\n");
 	}
@@ -152,11 +154,14 @@ GtkWidget *make_accounts_buttons_hbox(Data_passer *data_passer) {
 	gtk_widget_set_tooltip_text(account_button_revert, "Revert");
 
 	gtk_widget_set_sensitive(account_button_add, TRUE);
-	gtk_widget_set_sensitive(account_button_delete, FALSE);
 	gtk_widget_set_sensitive(account_button_revert, FALSE);
 
-	g_signal_connect(account_button_add, "clicked", G_CALLBACK(add_row), data_passer->list_store_temporary);
-	g_signal_connect(account_button_delete, "clicked", G_CALLBACK(delete_row), data_passer->list_store_temporary);
+	/* The Delete button is sensitive while at least one account is marked for deletion. Freed in `free_memory()`. */
+	data_passer->btn_accounts_delete = account_button_delete;
+	data_passer->account_selection = selection_set_new(data_passer->list_store_temporary, CHECKBOX, account_button_delete);
+
+	g_signal_connect(account_button_add, "clicked", G_CALLBACK(add_row), data_passer);
+	g_signal_connect(account_button_delete, "clicked", G_CALLBACK(delete_row), data_passer);
 	g_signal_connect(account_button_revert, "clicked", G_CALLBACK(revert_listing), data_passer);
 
 	return local_hbox;
@@ -16,7 +16,7 @@
  * @param renderer Pointer to the account's cell renderer.
  * @param model Pointer to model associated with the tree view.
  * @param iter Pointer to iterator associated with the model.
- * @param user_data Pointer to user data, `NULL` in this case.
+ * @param user_data Pointer to user data.
 */
 void account_column_formatter(GtkTreeViewColumn *col,
 							  GtkCellRenderer *renderer,
@@ -24,11 +24,10 @@ void account_column_formatter(GtkTreeViewColumn *col,
 							  GtkTreeIter *iter,
 							  gpointer user_data) {
 	Data_passer *data_passer = (Data_passer *)user_data;
-	gchararray account_number[500];
-	gtk_tree_model_get(model, iter, ACCOUNT_NUMBER, account_number, -1);
+	const gchar *account_number = account_table_column(data_passer->account_table, model, iter, ACCOUNT_NUMBER);
 
-	g_object_set(renderer, "text", *account_number, NULL);
-	if (strcmp(*account_number, NEW_NUMBER) == 0) {
+	g_object_set(renderer, "text", account_number, NULL);
+	if (strcmp(account_number, NEW_NUMBER) == 0) {
 		g_object_set(renderer, "foreground-rgba", &(data_passer->new_account_foreground), NULL);
 		g_object_set(renderer, "style", PANGO_STYLE_ITALIC, NULL);
 
@@ -45,7 +44,7 @@ void account_column_formatter(GtkTreeViewColumn *col,
  * @param renderer Pointer to the name's cell renderer.
  * @param model Pointer to model associated with the tree view.
  * @param iter Pointer to iterator associated with the model.
- * @param user_data Pointer to user data, `NULL` in this case.
+ * @param user_data Pointer to user data.
 */
 void name_column_formatter(GtkTreeViewColumn *col,
 						   GtkCellRenderer *renderer,
@@ -53,10 +52,9 @@ void name_column_formatter(GtkTreeViewColumn *col,
 						   GtkTreeIter *iter,
 						   gpointer user_data) {
 	Data_passer *data_passer = (Data_passer *)user_data;
-	gchararray name[500];
-	gtk_tree_model_get(model, iter, ACCOUNT_NAME, name, -1);
-	g_object_set(renderer, "text", *name, NULL);
-	if (strcmp(*name, NEW_NAME) == 0) {
+	const gchar *name = account_table_column(data_passer->account_table, model, iter, ACCOUNT_NAME);
+	g_object_set(renderer, "text", name, NULL);
+	if (strcmp(name, NEW_NAME) == 0) {
 		g_object_set(renderer, "foreground-rgba", &(data_passer->new_account_foreground), NULL);
 		g_object_set(renderer, "style", PANGO_STYLE_ITALIC, NULL);
 
@@ -73,7 +71,7 @@ void name_column_formatter(GtkTreeViewColumn *col,
  * @param renderer Pointer to the description's cell renderer.
  * @param model Pointer to model associated with the tree view.
  * @param iter Pointer to iterator associated with the model.
- * @param user_data Pointer to user data, `NULL` in this case.
+ * @param user_data Pointer to user data.
 */
 void description_column_formatter(GtkTreeViewColumn *col,
 								  GtkCellRenderer *renderer,
@@ -81,10 +79,9 @@ void description_column_formatter(GtkTreeViewColumn *col,
 								  GtkTreeIter *iter,
 								  gpointer user_data) {
 	Data_passer *data_passer = (Data_passer *)user_data;
-	gchararray description[500];
-	gtk_tree_model_get(model, iter, DESCRIPTION, description, -1);
-	g_object_set(renderer, "text", *description, NULL);
-	if (strcmp(*description, NEW_DESCRIPTION) == 0) {
+	const gchar *description = account_table_column(data_passer->account_table, model, iter, DESCRIPTION);
+	g_object_set(renderer, "text", description, NULL);
+	if (strcmp(description, NEW_DESCRIPTION) == 0) {
 		g_object_set(renderer, "foreground-rgba", &(data_passer->new_account_foreground), NULL);
 		g_object_set(renderer, "style", PANGO_STYLE_ITALIC, NULL);
 	} else {
@@ -94,13 +91,13 @@ void description_column_formatter(GtkTreeViewColumn *col,
 }
 
 /**
- * Callback fired to format each row in the Description column in the Accounts tab. The callback
- * retrieves the text associated with the passed `iter`. If the text is `(Description)`, the text is formatted in light gray and italic; otherwise the text is formatted as normal and black.
- * @param col Pointer to the description's column.
- * @param renderer Pointer to the description's cell renderer.
+ * Callback fired to format each row in the Routing column in the Accounts tab. The callback
+ * retrieves the text associated with the passed `iter`. If the text is `(Routing No)`, the text is formatted in light gray and italic; if the text is not a valid routing number, it is formatted in red; otherwise the text is formatted as normal and black.
+ * @param col Pointer to the routing number's column.
+ * @param renderer Pointer to the routing number's cell renderer.
  * @param model Pointer to model associated with the tree view.
  * @param iter Pointer to iterator associated with the model.
- * @param user_data Pointer to user data, `NULL` in this case.
+ * @param user_data Pointer to user data.
 */
 void routing_column_formatter(GtkTreeViewColumn *col,
 							  GtkCellRenderer *renderer,
@@ -108,38 +105,73 @@ void routing_column_formatter(GtkTreeViewColumn *col,
 							  GtkTreeIter *iter,
 							  gpointer user_data) {
 	Data_passer *data_passer = (Data_passer *)user_data;
-	gchararray routing[500];
-	gtk_tree_model_get(model, iter, ROUTING_NUMBER, routing, -1);
-	g_object_set(renderer, "text", *routing, NULL);
-	if (strcmp(*routing, NEW_ROUTING) == 0) {
+	const gchar *routing = account_table_column(data_passer->account_table, model, iter, ROUTING_NUMBER);
+	g_object_set(renderer, "text", routing, NULL);
+	if (strcmp(routing, NEW_ROUTING) == 0) {
 		g_object_set(renderer, "foreground-rgba", &(data_passer->new_account_foreground), NULL);
 		g_object_set(renderer, "style", PANGO_STYLE_ITALIC, NULL);
+	} else if (!routing_number_valid(routing)) {
+		g_object_set(renderer, "foreground-rgba", &(data_passer->invalid_routing_foreground), NULL);
+		g_object_set(renderer, "style", PANGO_STYLE_NORMAL, NULL);
 	} else {
 		g_object_set(renderer, "foreground-rgba", &(data_passer->existing_account_foreground), NULL);
 		g_object_set(renderer, "style", PANGO_STYLE_NORMAL, NULL);
 	}
 }
 
+/**
+ * Callback fired to format each row in the Bank column in the Accounts tab. The callback looks up the row's routing number in
+ * the routing directory and shows the bank's name, so the name follows the routing number as soon as it is edited. The column
+ * is empty if the routing number is not in the directory or there is no directory.
+ * @param col Pointer to the bank's column.
+ * @param renderer Pointer to the bank's cell renderer.
+ * @param model Pointer to model associated with the tree view.
+ * @param iter Pointer to iterator associated with the model.
+ * @param user_data Pointer to user data.
+*/
+void bank_column_formatter(GtkTreeViewColumn *col,
+						   GtkCellRenderer *renderer,
+						   GtkTreeModel *model,
+						   GtkTreeIter *iter,
+						   gpointer user_data) {
+	Data_passer *data_passer = (Data_passer *)user_data;
+	const gchar *routing = account_table_column(data_passer->account_table, model, iter, ROUTING_NUMBER);
+	const Routing_entry *entry = routing_directory_lookup(routing);
+	g_object_set(renderer, "text", (entry != NULL) ? entry->bank_name : "", NULL);
+}
+
+/**
+ * Stores the text of an edited cell in the Accounts tab. The text is interned in \ref Data_passer.account_table, the row takes its
+ * offset, and the table is rebuilt so the string the row held before is dropped if no other row uses it.
+ * @param data_passer Pointer to user data.
+ * @param path Pointer to the model's path where the editing took place.
+ * @param column Column edited.
+ * @param text The new text.
+*/
+static void set_account_text(Data_passer *data_passer, const gchar *path, gint column, const gchar *text) {
+	GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(data_passer->accounts_tree_view));
+	GtkTreeIter iter;
+	if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
+		gtk_list_store_set(GTK_LIST_STORE(model), &iter, column, account_table_intern(data_passer->account_table, text), -1);
+		account_table_rebuild(data_passer);
+	}
+}
+
 /**
  * Callback fired after a cell in the account number column is edited. The function
  * replaces the account number in the model with the one passed to the callback.
  * @param renderer Pointer to the number's cell renderer.
  * @param path Pointer to the model's path where the editing took place.
  * @param new_account_number Pointer to the new account number.
- * @param user_data Pointer to the account tree view.
+ * @param user_data Pointer to user data.
 */
 static void number_edited(GtkCellRendererText *renderer,
 						  gchar *path,
 						  gchar *new_account_number,
 						  gpointer user_data) {
-	GtkTreeView *treeview = (GtkTreeView *)user_data;
-	GtkTreeIter iter;
-	GtkTreeModel *model;
+	Data_passer *data_passer = (Data_passer *)user_data;
 	if (g_ascii_strcasecmp(new_account_number, "") != 0) {
-		model = gtk_tree_view_get_model(treeview);
-		if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
-			gtk_list_store_set(GTK_LIST_STORE(model), &iter, ACCOUNT_NUMBER, new_account_number, -1);
-		}
+		set_account_text(data_passer, path, ACCOUNT_NUMBER, new_account_number);
 	}
 }
 
@@ -149,20 +181,15 @@ static void number_edited(GtkCellRendererText *renderer,
  * @param renderer Pointer to the name's cell renderer.
  * @param path Pointer to the model's path where the editing took place.
  * @param new_account_name Pointer to the new account name.
- * @param user_data Pointer to the tree view.
+ * @param user_data Pointer to user data.
 */
 static void name_edited(GtkCellRendererText *renderer,
 						gchar *path,
 						gchar *new_account_name,
 						gpointer user_data) {
-	GtkTreeView *treeview = (GtkTreeView *)user_data;
-	GtkTreeIter iter;
-	GtkTreeModel *model;
+	Data_passer *data_passer = (Data_passer *)user_data;
 	if (g_ascii_strcasecmp(new_account_name, "") != 0) {
-		model = gtk_tree_view_get_model(treeview);
-		if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
-			gtk_list_store_set(GTK_LIST_STORE(model), &iter, ACCOUNT_NAME, new_account_name, -1);
-		}
+		set_account_text(data_passer, path, ACCOUNT_NAME, new_account_name);
 	}
 }
 
@@ -172,69 +199,36 @@ static void name_edited(GtkCellRendererText *renderer,
  * @param renderer Pointer to the description's cell renderer.
  * @param path Pointer to the model's path where the editing took place.
  * @param new_description Pointer to the new account description.
- * @param user_data Pointer to the tree view.
+ * @param user_data Pointer to user data.
 */
 static void description_edited(GtkCellRendererText *renderer,
 							   gchar *path,
 							   gchar *new_description,
 							   gpointer user_data) {
-	GtkTreeView *treeview = (GtkTreeView *)user_data;
-	GtkTreeIter iter;
-	GtkTreeModel *model;
+	Data_passer *data_passer = (Data_passer *)user_data;
 	if (g_ascii_strcasecmp(new_description, "") != 0) {
-		model = gtk_tree_view_get_model(treeview);
-		if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
-			gtk_list_store_set(GTK_LIST_STORE(model), &iter, DESCRIPTION, new_description, -1);
-		}
+		set_account_text(data_passer, path, DESCRIPTION, new_description);
 	}
 }
 
 /**
- * Callback fired after a cell in the name  column is edited. The function
- * replaces the name in the model with the one passed to the callback.
- * @param renderer Pointer to the name's cell renderer.
+ * Callback fired after a cell in the routing column is edited. The function
+ * replaces the routing number in the model with the one passed to the callback, without surrounding spaces. The routing
+ * formatter marks the number if it fails the checksum, and the Bank column shows the bank it belongs to.
+ * @param renderer Pointer to the routing number's cell renderer.
  * @param path Pointer to the model's path where the editing took place.
- * @param new_routing_number Pointer to the new account name.
- * @param user_data Pointer to the tree view.
+ * @param new_routing_number Pointer to the new routing number.
+ * @param user_data Pointer to user data.
 */
 static void routing_edited(GtkCellRendererText *renderer,
 						   gchar *path,
 						   gchar *new_routing_number,
 						   gpointer user_data) {
-	GtkTreeView *treeview = (GtkTreeView *)user_data;
-	GtkTreeIter iter;
-	GtkTreeModel *model;
+	Data_passer *data_passer = (Data_passer *)user_data;
+	g_strstrip(new_routing_number);
 	if (g_ascii_strcasecmp(new_routing_number, "") != 0) {
-		model = gtk_tree_view_get_model(treeview);
-		if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
-			gtk_list_store_set(GTK_LIST_STORE(model), &iter, ROUTING_NUMBER, new_routing_number, -1);
-		}
-	}
-}
-
-/**
- * Callback fired during a `gtk_tree_model_foreach`. The function
- * examines the checkbox in the model's passed iteration, and returns true or false depending
- * if the checkbox is marked.
- * @param model Pointer to the model being iterated.
- * @param path Pointer to the path associated with the current iteration.
- * @param iter Pointer to the iterator associated with the current iteration.
- * @param data Pointer to user data.
- * @return `TRUE` if at least one of the checkboxes in the delete column is checked, `FALSE` otherwise.
- * \sa toggle_clicked()
-*/
-gboolean examine_all_checkboxes(GtkTreeModel *model,
-								GtkTreePath *path,
-								GtkTreeIter *iter,
-								gpointer data) {
-	gboolean value;
-	gboolean *checkbox_checked = (gboolean *)data;
-	gtk_tree_model_get(model, iter, CHECKBOX, &value, -1);
-	if (value == TRUE) {
-		*checkbox_checked = TRUE;
-		return TRUE;
+		set_account_text(data_passer, path, ROUTING_NUMBER, new_routing_number);
 	}
-	return FALSE;
 }
 
 /**
@@ -252,26 +246,11 @@ static void toggle_clicked(GtkCellRendererToggle *renderer,
 	GtkTreeModel *model;
 	gboolean value;
 	model = gtk_tree_view_get_model(treeview);
+	/* Data_passer.account_selection sees the change and sets the Delete button's sensitivity. */
 	if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
 		gtk_tree_model_get(model, &iter, CHECKBOX, &value, -1);
 		gtk_list_store_set(GTK_LIST_STORE(model), &iter, CHECKBOX, !value, -1);
 	}
-
-	/* This boolean is true if at least one of the checkboxes is marked. If it is true,
-	   then several buttons on this UI become sensitive. */
-	gboolean at_least_one_checkbox_set = FALSE;
-
-	gtk_tree_model_foreach(model, examine_all_checkboxes, &at_least_one_checkbox_set);
-
-	GtkWidget *accounts_tab = gtk_widget_get_parent(GTK_WIDGET(treeview));
-	GtkWidget *accounts_hbox = get_child_from_parent(accounts_tab, HBOX_ACCOUNT_BUTTONS);
-	GtkWidget *account_button_delete = get_child_from_parent(accounts_hbox, BUTTON_NAME_DELETE);
-
-	if (at_least_one_checkbox_set == TRUE) {
-		gtk_widget_set_sensitive(account_button_delete, TRUE);
-	} else {
-		gtk_widget_set_sensitive(account_button_delete, FALSE);
-	}
 }
 
 /**
@@ -292,11 +271,10 @@ GtkWidget *make_tree_view(GtkListStore *list_store, Data_passer *data_passer) {
 	rendererAccount = gtk_cell_renderer_text_new();
 	columnAccount = gtk_tree_view_column_new_with_attributes("Account No.",
 															 rendererAccount,
-															 "text", ACCOUNT_NUMBER,
 															 NULL);
 	g_object_set(rendererAccount, "editable", TRUE, "editable-set", TRUE, NULL);
 
-	g_signal_connect(G_OBJECT(rendererAccount), "edited", G_CALLBACK(number_edited), tree);
+	g_signal_connect(G_OBJECT(rendererAccount), "edited", G_CALLBACK(number_edited), data_passer);
 
 	GtkCellRenderer *rendererName;
 	GtkTreeViewColumn *columnName;
@@ -304,11 +282,10 @@ GtkWidget *make_tree_view(GtkListStore *list_store, Data_passer *data_passer) {
 	rendererName = gtk_cell_renderer_text_new();
 	columnName = gtk_tree_view_column_new_with_attributes("Name",
 														  rendererName,
-														  "text", ACCOUNT_NAME,
 														  NULL);
 	g_object_set(rendererName, "editable", TRUE, "editable-set", TRUE, NULL);
 
-	g_signal_connect(G_OBJECT(rendererName), "edited", G_CALLBACK(name_edited), tree);
+	g_signal_connect(G_OBJECT(rendererName), "edited", G_CALLBACK(name_edited), data_passer);
 
 	GtkCellRenderer *rendererDescription;
 	GtkTreeViewColumn *columnDescription;
@@ -316,11 +293,10 @@ GtkWidget *make_tree_view(GtkListStore *list_store, Data_passer *data_passer) {
 	rendererDescription = gtk_cell_renderer_text_new();
 	columnDescription = gtk_tree_view_column_new_with_attributes("Description",
 																 rendererDescription,
-																 "text", DESCRIPTION,
 																 NULL);
 
 	g_object_set(rendererDescription, "editable", TRUE, "editable-set", TRUE, NULL);
-	g_signal_connect(G_OBJECT(rendererDescription), "edited", G_CALLBACK(description_edited), tree);
+	g_signal_connect(G_OBJECT(rendererDescription), "edited", G_CALLBACK(description_edited), data_passer);
 
 	GtkCellRenderer *rendererRouting;
 	GtkTreeViewColumn *columnRouting;
@@ -328,11 +304,18 @@ GtkWidget *make_tree_view(GtkListStore *list_store, Data_passer *data_passer) {
 	rendererRouting = gtk_cell_renderer_text_new();
 	columnRouting = gtk_tree_view_column_new_with_attributes("Routing No.",
 															 rendererRouting,
-															 "text", ROUTING_NUMBER,
 															 NULL);
 	g_object_set(rendererRouting, "editable", TRUE, "editable-set", TRUE, NULL);
 
-	g_signal_connect(G_OBJECT(rendererRouting), "edited", G_CALLBACK(routing_edited), tree);
+	g_signal_connect(G_OBJECT(rendererRouting), "edited", G_CALLBACK(routing_edited), data_passer);
+
+	GtkCellRenderer *rendererBank;
+	GtkTreeViewColumn *columnBank;
+
+	rendererBank = gtk_cell_renderer_text_new();
+	columnBank = gtk_tree_view_column_new_with_attributes("Bank",
+														  rendererBank,
+														  NULL);
 
 	GtkCellRenderer *rendererToggle;
 	GtkTreeViewColumn *columnToggle;
@@ -351,12 +334,14 @@ GtkWidget *make_tree_view(GtkListStore *list_store, Data_passer *data_passer) {
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnName);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnDescription);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnRouting);
+	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnBank);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnToggle);
 
 	gtk_tree_view_column_set_cell_data_func(columnAccount, rendererAccount, account_column_formatter, data_passer, NULL);
 	gtk_tree_view_column_set_cell_data_func(columnName, rendererName, name_column_formatter, data_passer, NULL);
 	gtk_tree_view_column_set_cell_data_func(columnDescription, rendererDescription, description_column_formatter, data_passer, NULL);
 	gtk_tree_view_column_set_cell_data_func(columnRouting, rendererRouting, routing_column_formatter, data_passer, NULL);
+	gtk_tree_view_column_set_cell_data_func(columnBank, rendererBank, bank_column_formatter, data_passer, NULL);
 
 	return tree;
 }
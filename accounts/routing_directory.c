@@ -0,0 +1,261 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file routing_directory.c
+ * @brief Looks up routing numbers in a local copy of the Federal Reserve's ACH participant directory.
+ *
+ * The directory is optional. If the directory file exists, it is compiled into an index file, an array of \ref Routing_entry
+ * sorted by routing number, whenever the index is missing or older than the directory. The index is then
+ * mapped into memory and searched with `bsearch`, so a lookup reads a few cache lines of the file and allocates nothing.
+ */
+
+/** Identifies a routing index file. */
+#define ROUTING_INDEX_MAGIC "DSRI"
+
+/** Version of the index layout. An index with another version is compiled again. */
+#define ROUTING_INDEX_VERSION 1
+
+/** Length of a directory line, used to estimate the number of entries before reading them. */
+#define ROUTING_DIRECTORY_LINE_LENGTH 155
+
+/** Shortest directory line holding the fields read by the compiler, which end with the bank name in columns 36–71. */
+#define ROUTING_DIRECTORY_MIN_LINE 71
+
+/**
+ * Header at the start of a routing index file. The sorted entries follow it.
+ */
+typedef struct Routing_index_header {
+	gchar magic[4]; /**< \ref ROUTING_INDEX_MAGIC. */
+	guint32 version; /**< \ref ROUTING_INDEX_VERSION. */
+	guint32 n_entries; /**< Number of entries following the header. */
+	guint32 entry_size; /**< Size of one entry, `sizeof(Routing_entry)` when the index was written. */
+} Routing_index_header;
+
+/** Mapped index file, or `NULL` if there is no directory. */
+static GMappedFile *index_file = NULL;
+
+/** Sorted entries inside \ref index_file. */
+static const Routing_entry *entries = NULL;
+
+/** Number of entries in \ref entries. */
+static gsize n_entries = 0;
+
+/**
+ * Converts a routing number to an integer.
+ * @param text Text holding the routing number.
+ * @param length Number of characters to read.
+ * @param routing_number Receives the routing number.
+ * @return `TRUE` if the text is exactly `length` digits.
+ */
+static gboolean parse_routing_number(const gchar *text, gsize length, guint32 *routing_number) {
+	guint32 value = 0;
+	for (gsize i = 0; i < length; i++) {
+		if (!g_ascii_isdigit(text[i])) {
+			return FALSE;
+		}
+		value = value * 10 + (text[i] - '0');
+	}
+	*routing_number = value;
+	return TRUE;
+}
+
+/**
+ * Compares two directory entries by routing number, for `qsort` and `bsearch`.
+ * @param a Pointer to the first entry.
+ * @param b Pointer to the second entry.
+ * @return Negative, zero, or positive as the first routing number is less than, equal to, or greater than the second.
+ */
+static gint compare_entries(const void *a, const void *b) {
+	guint32 first = ((const Routing_entry *)a)->routing_number;
+	guint32 second = ((const Routing_entry *)b)->routing_number;
+	return (first > second) - (first < second);
+}
+
+/**
+ * Compiles the directory into the index. Each directory line is fixed width: the routing number is in columns 1–9, the office
+ * code in column 10, the record type in column 20, and the bank name in columns 36–71. Lines that do not hold a valid routing
+ * number are skipped.
+ * @param directory_path Path of the directory.
+ * @param index_path Path of the index to write.
+ * @return `TRUE` if the index was written.
+ */
+static gboolean compile_index(const gchar *directory_path, const gchar *index_path) {
+	gchar *contents = NULL;
+	gsize length = 0;
+	GError *error = NULL;
+
+	if (!g_file_get_contents(directory_path, &contents, &length, &error)) {
+		g_print("Unable to read `%s': %s\n", directory_path, error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	GArray *compiled = g_array_sized_new(FALSE, TRUE, sizeof(Routing_entry), length / ROUTING_DIRECTORY_LINE_LENGTH + 1);
+	gchar *line = contents;
+	while (line < contents + length) {
+		gchar *end = memchr(line, '\n', contents + length - line);
+		if (end == NULL) {
+			end = contents + length;
+		}
+
+		Routing_entry entry = {0};
+		if (end - line >= ROUTING_DIRECTORY_MIN_LINE && parse_routing_number(line, 9, &entry.routing_number) &&
+			routing_number_valid_digits(line)) {
+			entry.office_code = line[9];
+			entry.record_type = line[19];
+			memcpy(entry.bank_name, line + 35, 36);
+			g_strchomp(entry.bank_name);
+			g_array_append_val(compiled, entry);
+		}
+		line = end + 1;
+	}
+	g_free(contents);
+
+	qsort(compiled->data, compiled->len, sizeof(Routing_entry), compare_entries);
+
+	Routing_index_header header;
+	memcpy(header.magic, ROUTING_INDEX_MAGIC, sizeof(header.magic));
+	header.version = ROUTING_INDEX_VERSION;
+	header.n_entries = compiled->len;
+	header.entry_size = sizeof(Routing_entry);
+
+	gsize index_length = sizeof(header) + compiled->len * sizeof(Routing_entry);
+	gchar *index = g_malloc(index_length);
+	memcpy(index, &header, sizeof(header));
+	memcpy(index + sizeof(header), compiled->data, compiled->len * sizeof(Routing_entry));
+
+	gboolean written = g_file_set_contents(index_path, index, index_length, &error);
+	if (!written) {
+		g_print("Unable to write `%s': %s\n", index_path, error->message);
+		g_error_free(error);
+	}
+	g_free(index);
+	g_array_free(compiled, TRUE);
+	return written;
+}
+
+/**
+ * Determines whether the index must be compiled, because it is missing or older than the directory.
+ * @param directory_path Path of the directory.
+ * @param index_path Path of the index.
+ * @return `TRUE` if the index is out of date.
+ */
+static gboolean index_out_of_date(const gchar *directory_path, const gchar *index_path) {
+	GStatBuf directory_stat;
+	GStatBuf index_stat;
+	if (g_stat(index_path, &index_stat) != 0) {
+		return TRUE;
+	}
+	return g_stat(directory_path, &directory_stat) == 0 && directory_stat.st_mtime > index_stat.st_mtime;
+}
+
+/**
+ * Maps the index into memory and checks its header.
+ * @param index_path Path of the index.
+ * @return `TRUE` if the index is usable.
+ */
+static gboolean map_index(const gchar *index_path) {
+	GError *error = NULL;
+	index_file = g_mapped_file_new(index_path, FALSE, &error);
+	if (index_file == NULL) {
+		g_print("Unable to map `%s': %s\n", index_path, error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	const gchar *contents = g_mapped_file_get_contents(index_file);
+	gsize length = g_mapped_file_get_length(index_file);
+	const Routing_index_header *header = (const Routing_index_header *)contents;
+	if (length < sizeof(Routing_index_header) ||
+		memcmp(header->magic, ROUTING_INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != ROUTING_INDEX_VERSION ||
+		header->entry_size != sizeof(Routing_entry) ||
+		length != sizeof(Routing_index_header) + (gsize)header->n_entries * sizeof(Routing_entry)) {
+		g_mapped_file_unref(index_file);
+		index_file = NULL;
+		return FALSE;
+	}
+
+	entries = (const Routing_entry *)(contents + sizeof(Routing_index_header));
+	n_entries = header->n_entries;
+	return TRUE;
+}
+
+/**
+ * Opens the routing directory, compiling its index first if needed. Without a directory file the application runs as before,
+ * and lookups find nothing.
+ * @param directory_path Path of the directory, \ref ROUTING_DIRECTORY_FILE in the application.
+ * @param index_path Path of the index compiled from it, \ref ROUTING_INDEX_FILE in the application.
+ */
+void routing_directory_open(const gchar *directory_path, const gchar *index_path) {
+	if (!g_file_test(directory_path, G_FILE_TEST_EXISTS)) {
+		return;
+	}
+	if (index_out_of_date(directory_path, index_path) && !compile_index(directory_path, index_path)) {
+		return;
+	}
+	if (!map_index(index_path)) {
+		/* The index was written by another version; compile it again. */
+		if (compile_index(directory_path, index_path)) {
+			map_index(index_path);
+		}
+	}
+}
+
+/**
+ * Checks the nine digits of a routing number against the ABA check digit: three times the sum of digits 1, 4, and 7, plus
+ * seven times the sum of digits 2, 5, and 8, plus the sum of digits 3, 6, and 9, is a multiple of ten.
+ * @param digits Pointer to nine ASCII digits.
+ * @return `TRUE` if the check digit matches.
+ */
+gboolean routing_number_valid_digits(const gchar *digits) {
+	static const gint weights[9] = {3, 7, 1, 3, 7, 1, 3, 7, 1};
+	gint sum = 0;
+	for (gint i = 0; i < 9; i++) {
+		sum += weights[i] * (digits[i] - '0');
+	}
+	return sum % 10 == 0;
+}
+
+/**
+ * Determines whether text is a valid routing number: exactly nine digits that pass the ABA checksum.
+ * @param routing_number Text to check.
+ * @return `TRUE` if the routing number is valid.
+ */
+gboolean routing_number_valid(const gchar *routing_number) {
+	guint32 value;
+	return strlen(routing_number) == 9 && parse_routing_number(routing_number, 9, &value) &&
+		   routing_number_valid_digits(routing_number);
+}
+
+/**
+ * Looks up a routing number in the directory.
+ * @param routing_number Text holding the routing number.
+ * @return Pointer to the directory entry, valid until routing_directory_close(), or `NULL` if the routing number is not in
+ * the directory or there is no directory.
+ */
+const Routing_entry *routing_directory_lookup(const gchar *routing_number) {
+	Routing_entry key;
+	if (entries == NULL || strlen(routing_number) != 9 || !parse_routing_number(routing_number, 9, &key.routing_number)) {
+		return NULL;
+	}
+	return bsearch(&key, entries, n_entries, sizeof(Routing_entry), compare_entries);
+}
+
+/**
+ * Unmaps the index. Called from free_memory().
+ */
+void routing_directory_close(void) {
+	if (index_file != NULL) {
+		g_mapped_file_unref(index_file);
+		index_file = NULL;
+	}
+	entries = NULL;
+	n_entries = 0;
+}
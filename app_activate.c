@@ -7,6 +7,36 @@
  * @brief Builds the view.
  */
 
+/**
+ * Callback fired when the user switches notebook pages. The first time the Accounts tab is shown, this function builds its
+ * tree view and buttons, then disconnects itself. Most sessions never open the Accounts tab, so they never pay for it.
+ * @param notebook The application's notebook.
+ * @param page Page being switched to.
+ * @param page_num Index of the page being switched to.
+ * @param data Pointer to user data.
+ */
+static void build_accounts_tab(GtkNotebook *notebook, GtkWidget *page, guint page_num, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+
+	if (g_strcmp0(gtk_widget_get_name(page), "vbox_accounts") != 0) {
+		return;
+	}
+
+	/* Make the view for the Accounts tab. */
+	GtkWidget *accounts_tab_tree = make_tree_view(data_passer->list_store_temporary, data_passer);
+	data_passer->accounts_tree_view = accounts_tab_tree;
+
+	/* Make buttons under the accounts in the Accounts tab. This should be part of make_tree_view. */
+	GtkWidget *accounts_buttons_hbox = make_accounts_buttons_hbox(data_passer);
+
+	/* Place the buttons in the Accounts tab. Again, should be part of make_tree_view. The TRUE parameter ensures the treeview maintains its initial height, even after deleting rows. */
+	gtk_box_pack_start(GTK_BOX(page), accounts_tab_tree, TRUE, FALSE, 0);
+	gtk_box_pack_start(GTK_BOX(page), accounts_buttons_hbox, FALSE, FALSE, 0);
+	gtk_widget_show_all(page);
+
+	g_signal_handlers_disconnect_by_func(notebook, G_CALLBACK(build_accounts_tab), data);
+}
+
 /**
  * Function that starts the GTK loop.
  * @param app Pointer to the GTK application
@@ -18,20 +48,36 @@ void on_app_activate(GApplication *app, gpointer data) {
 
 	data_passer->list_store_master = NULL;
 	data_passer->list_store_temporary = NULL;
-	data_passer->cairo_context = NULL;
+	data_passer->account_table = NULL;
 	data_passer->check_tree_view = NULL;
 	data_passer->front_slip_active = TRUE;
 	data_passer->drawing_area = NULL;
-	data_passer->checks_store = NULL;
-	data_passer->total_deposit = 0;
-	data_passer->total_back_side = 0;
+	data_passer->deposit = NULL;
+	data_passer->session = NULL;
 	data_passer->checks_accounts_treeview = NULL;
 	data_passer->application_window = NULL;
 	data_passer->radio_renderer = NULL;
+	data_passer->btn_checks_add = NULL;
+	data_passer->accounts_tree_view = NULL;
+	data_passer->btn_accounts_delete = NULL;
+	data_passer->account_selection = NULL;
 	data_passer->btn_go_to_first = NULL;
 	data_passer->btn_go_to_last = NULL;
-	data_passer->front = (Front *)g_malloc(sizeof(Front));
-	data_passer->back = (Back *)g_malloc(sizeof(Back));
+	data_passer->layout = NULL;
+	data_passer->layout_pending = NULL;
+	data_passer->layout_holds = 0;
+	data_passer->layout_monitor = NULL;
+	/* Scratch memory for drawing the preview and printing. Freed in `free_memory()`. */
+	data_passer->frame_arena = frame_arena_new(4096);
+	data_passer->slip_front = NULL;
+	data_passer->slip_back = NULL;
+	data_passer->preview_renderer = NULL;
+	data_passer->frame_stats = NULL;
+	data_passer->redraw.dirty = 0;
+	data_passer->redraw.dirty_checks = 0;
+	data_passer->redraw.idle_id = 0;
+	data_passer->history = NULL;
+	data_passer->render_cache = NULL;
 	data_passer->new_account_foreground.red = 0.35; 
 	data_passer->new_account_foreground.green = 0.35; 
 	data_passer->new_account_foreground.blue = 0.35; 
@@ -42,17 +88,23 @@ void on_app_activate(GApplication *app, gpointer data) {
 	data_passer->existing_account_foreground.blue = 0; 
 	data_passer->existing_account_foreground.alpha = 1; 
 
+	data_passer->invalid_routing_foreground.red = 0.8;
+	data_passer->invalid_routing_foreground.green = 0;
+	data_passer->invalid_routing_foreground.blue = 0;
+	data_passer->invalid_routing_foreground.alpha = 1;
+
 
 
 
 
 	data_passer->css_provider = gtk_css_provider_new();
-	gtk_css_provider_load_from_path(data_passer->css_provider, "/home/abba/programming/c_programs/deposit_slips/styles.css", NULL);
+	/* The style sheet and icon are compiled into the executable, so loading them does not touch the file system. */
+	gtk_css_provider_load_from_resource(data_passer->css_provider, RESOURCE_CSS);
 	gtk_style_context_add_provider_for_screen(gdk_screen_get_default(), GTK_STYLE_PROVIDER(data_passer->css_provider), GTK_STYLE_PROVIDER_PRIORITY_USER);
 
 	GtkWidget *window = gtk_application_window_new(GTK_APPLICATION(app));
 	gtk_window_set_resizable(GTK_WINDOW(window), FALSE);
-	data_passer->application_icon = gdk_pixbuf_new_from_file ("/home/abba/.deposit_slip/icon.png", NULL);
+	data_passer->application_icon = gdk_pixbuf_new_from_resource(RESOURCE_ICON, NULL);
 	gtk_window_set_icon (GTK_WINDOW(window), data_passer->application_icon);
 	data_passer->application_window = window;
 
@@ -73,30 +125,37 @@ void on_app_activate(GApplication *app, gpointer data) {
 
 
 	/* This memory is free after application is destroyed in `free_memory()`. */
-	data_passer->list_store_master = gtk_list_store_new(N_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_BOOLEAN);
+	data_passer->list_store_master = gtk_list_store_new(N_COLUMNS, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
 	//   data_passer->list_store_master = list_store_master;
 	/* This memory is free after application is destroyed in `free_memory()`. */
-	data_passer->list_store_temporary = gtk_list_store_new(N_COLUMNS, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_STRING, G_TYPE_BOOLEAN);
+	data_passer->list_store_temporary = gtk_list_store_new(N_COLUMNS, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
 	//   data_passer->list_store_temporary = list_store_temporary;
+	/* Strings of the accounts in both stores, which hold offsets into it. Freed in `free_memory()`. */
+	data_passer->account_table = account_table_new();
 
 	/* Read configuration data from disk. */
 	read_configuration_data(data_passer);
-
-	/* Make the view for the Accounts tab. */
-	GtkWidget *accounts_tab_tree = make_tree_view(data_passer->list_store_temporary, data_passer);
-	/* Make the view for the Slip  tab. */
+	if (data_passer->layout == NULL) {
+		data_passer->layout = slip_layout_new(); /* The configuration could not be parsed. */
+	}
+	/* Open the routing directory, if there is one. Closed in `free_memory()`. */
+	routing_directory_open(ROUTING_DIRECTORY_FILE, ROUTING_INDEX_FILE);
+	/* Open the history of printed deposits. Closed in `free_memory()`. */
+	data_passer->history = history_store_open(HISTORY_DIRECTORY);
+	/* Open the cache of rendered slips. Closed in `free_memory()`. */
+	data_passer->render_cache = render_cache_open(RENDER_CACHE_DIRECTORY, RENDER_CACHE_MAXIMUM_BYTES);
+
+	/* Make the view for the Slip  tab. The Accounts tab is built the first time the user opens it; see build_accounts_tab(). */
 	GtkWidget *slips_tab_tree = make_slip_view(data_passer);
 
 	/* Upon destroying the application, free memory in data structures in pointer_passer. */
 	g_signal_connect(window, "destroy", G_CALLBACK(free_memory), data_passer);
+	/* F12 shows or hides the preview's timing overlay. */
+	g_signal_connect(window, "key-press-event", G_CALLBACK(frame_stats_key_pressed), data_passer);
 
-	/* Make buttons under the accounts in the Accounts tab. This should be part of make_tree_view. */
-	GtkWidget *accounts_buttons_hbox = make_accounts_buttons_hbox(data_passer);
+	/* Build the Accounts tab on first use. */
+	g_signal_connect(notebook, "switch-page", G_CALLBACK(build_accounts_tab), data_passer);
 
-	/* Place the buttons in the Accounts tab. Again, should be part of make_tree_view. The TRUE parameter ensures the treeview maintains its initial height, even after deleting rows. */
-	gtk_box_pack_start(GTK_BOX(vbox_accounts), accounts_tab_tree, TRUE, FALSE, 0);
-	gtk_box_pack_start(GTK_BOX(vbox_accounts), accounts_buttons_hbox, FALSE, FALSE, 0);
-	
 	/* Place the slip view in the Slip tab. */
 	gtk_box_pack_start(GTK_BOX(vbox_slip), slips_tab_tree, FALSE, FALSE, 0);
 
@@ -112,6 +171,10 @@ void on_app_activate(GApplication *app, gpointer data) {
 	/* Emit row-activated signal on the account tree in the slips tab to populate the description correctly.  */
 	g_signal_emit_by_name(G_OBJECT(data_passer->checks_accounts_treeview), "row-activated", NULL);
 
-	/* Draw the preview. */
-	gtk_widget_queue_draw(data_passer->drawing_area);
+	/* Compile the slip's display lists, then draw the preview. */
+	slip_compile(data_passer);
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_PREVIEW, REDRAW_SOURCE_APP);
+
+	/* Compile the slip again whenever its layout is edited in the configuration file. */
+	slip_layout_watch(data_passer);
 }
@@ -28,6 +28,18 @@ static const char BUTTON_CHECK_ADD[] = "btnChecksAdd";
 static const char BUTTON_CHECK_DELETE[] = "btnChecksDelete";  
 /** Name for the Print Slip button. */
 static const char BUTTON_SLIP_PRINT[] = "btnSlipPrint"; 
+/** Name for the Print All button. */
+static const char BUTTON_SLIP_PRINT_ALL[] = "btnSlipPrintAll";
+/** Name for the Export Slip button. */
+static const char BUTTON_SLIP_EXPORT[] = "btnSlipExport";
+/** Name for the Save Deposit button. */
+static const char BUTTON_SLIP_SAVE[] = "btnSlipSave";
+/** Name for the Open Deposit button. */
+static const char BUTTON_SLIP_OPEN[] = "btnSlipOpen";
+/** Name for the Open All Deposits button. */
+static const char BUTTON_SLIP_OPEN_ALL[] = "btnSlipOpenAll";
+/** Name for the Reprint button. */
+static const char BUTTON_SLIP_REPRINT[] = "btnSlipReprint";
 /** Name for the account description label. */ 
 static const char LABEL_ACCOUNT_DESCRIPTION[] = "lblAccountDescription"; 
 /** Dummy amount string for the new check row. */
@@ -36,14 +48,41 @@ static const char NEW_AMOUNT[] = "0.00";
 /** Amount to adjust vertical position for two-line label. */
 static const int line_spacer = 3;
 
-/** Right-margin of the deposit slip on the screen */
-#define RIGHT_MARGIN_SCREEN 485
+/** Width of the deposit slip in points (6 inches). */
+#define SLIP_WIDTH 432
+
+/** Height of the deposit slip in points (2.75 inches). */
+#define SLIP_HEIGHT 198
+
+/** Resource path of the style sheet compiled into the executable. See resources/deposit_slips.gresource.xml. */
+#define RESOURCE_CSS "/net/lautman/DepositSlips/styles.css"
+/** Resource path of the application icon compiled into the executable. */
+#define RESOURCE_ICON "/net/lautman/DepositSlips/icon.png"
 
 /** Path to configuration file */
 #define CONFIG_FILE "/home/abba/.deposit_slip/deposit_slips.json"
 /** Path to backup configuration file. See free_memory(). */
 #define CONFIG_FILE_BACKUP "/home/abba/.deposit_slip/deposit_slips_backup.json"
 
+/** Path to the optional routing directory, in the fixed-width format of the Federal Reserve's ACH participant directory. See routing_directory.c. */
+#define ROUTING_DIRECTORY_FILE "/home/abba/.deposit_slip/FedACHdir.txt"
+/** Path to the index compiled from the routing directory. */
+#define ROUTING_INDEX_FILE "/home/abba/.deposit_slip/routing_index.bin"
+
+/** Directory holding saved deposits, one `.dslip` file per account. See deposit_file.c. */
+#define DEPOSITS_DIRECTORY "/home/abba/.deposit_slip/deposits"
+
+/** Directory holding the history of printed deposits. See history_store.c. */
+#define HISTORY_DIRECTORY "/home/abba/.deposit_slip/history"
+
+/** Directory holding rendered deposit slips. See render_cache.c. */
+#define RENDER_CACHE_DIRECTORY "/home/abba/.deposit_slip/render_cache"
+/** Largest total size of the rendered deposit slips kept in \ref RENDER_CACHE_DIRECTORY. */
+#define RENDER_CACHE_MAXIMUM_BYTES (16 * 1024 * 1024)
+
+/** Environment variable that shows the preview's timing overlay at startup when set. See frame_stats.c. */
+#define FRAME_STATS_ENVIRONMENT "DEPOSIT_SLIPS_FRAME_STATS"
+
 /** Character corresponding to the `transit` character in MICR. This character can change depending on the MICR font. */
 #define MICR_TRANSIT "A"
 /** Character corresponding to the `on-us` character in MICR.  This character can change depending on the MICR font. */
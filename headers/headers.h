@@ -1,5 +1,6 @@
 #include <gtk/gtk.h>
 #include <json-glib/json-glib.h>
+#include <stdio.h>
 
 /**
  * @file headers.h
@@ -7,7 +8,7 @@
  */
 
 /**
- * Enum for declaring a list store of accounts.
+ * Enum for declaring a list store of accounts. The first four columns are offsets into \ref Data_passer.account_table.
  */
 enum {
 	ACCOUNT_NUMBER, /**< 0 */
@@ -24,20 +25,33 @@ enum {
 enum {
 	CHECK_AMOUNT, /**< 0 */
 	CHECK_RADIO, /**< 1 */
-	SLIP_COLUMNS /**< 2 */
+	CHECK_CENTS, /**< 2 */
+	SLIP_COLUMNS /**< 3 */
 };
 
 /**
- * Structure of an account record.
+ * Structure of an account record. Each field is an offset into the string arena of the \ref Account_table holding the
+ * account; see account_table_string().
  */
 typedef struct Accounts {
 	/** Account number */
-	gchar number[100];
-	gchar name[100]; /**< Name of account holder */
-	gchar description[500]; /**< Informal description of account */
-	gchar routing[100]; /**< Routing number associated with bank account */
+	guint32 number;
+	guint32 name; /**< Name of account holder */
+	guint32 description; /**< Informal description of account */
+	guint32 routing; /**< Routing number associated with bank account */
 } Account;
 
+/**
+ * Strings of the accounts in the master and temporary list stores, interned in one arena. See account_table.c.
+ */
+typedef struct Account_table {
+	gchar* strings; /**< Arena of NUL-terminated strings, starting with the empty string. */
+	gsize strings_length; /**< Bytes used in `strings`. */
+	gsize strings_capacity; /**< Bytes allocated for `strings`. */
+	GArray* accounts; /**< Array of \ref Account, the rows of the master list store. */
+	GHashTable* interned; /**< Offset of each string in `strings`, keyed by the string. */
+} Account_table;
+
 /**
  * Structure holding printing coordinates on the front side of the deposit slip. Corresponds to the `front` stanza in the configuration file.
  */
@@ -157,6 +171,355 @@ typedef struct Back {
 	gdouble must_be_entered_font_size; /**< Offset from check listing table to the ON FRONT SIDE label. */
 } Back;
 
+/**
+ * Immutable layout of both sides of the deposit slip, shared by reference. See slip_layout.c.
+ */
+typedef struct Slip_layout {
+	gatomicrefcount ref_count; /**< Number of references. */
+	Front front; /**< Coordinates on the front side. */
+	Back back; /**< Coordinates on the back side. */
+} Slip_layout;
+
+/** Size of a buffer large enough for any amount formatted by amount_format_cents() or amount_format_digits(). */
+#define AMOUNT_BUFFER_SIZE 32
+
+/**
+ * Separators used when formatting and parsing amounts. See amount_format.c.
+ */
+typedef struct Amount_separators {
+	gchar grouping; /**< Thousands separator, or `'\0'` for no grouping. */
+	gchar decimal; /**< Decimal point. */
+} Amount_separators;
+
+/**
+ * Bump allocator for scratch memory that lives for a single preview frame or printed page. See frame_arena.c.
+ */
+typedef struct Frame_arena {
+	gchar* block; /**< Block from which scratch memory is handed out. */
+	gsize capacity; /**< Size of the block in bytes. */
+	gsize used; /**< Bytes handed out since the last reset. */
+	gsize high_water; /**< Largest number of bytes used by a single frame. */
+	GSList* overflow; /**< Heap blocks handed out after the block filled up during the current frame. */
+	guint heap_allocations; /**< Number of heap allocations the arena has made since it was created. */
+	guint heap_allocations_at_reset; /**< Value of `heap_allocations` at the last reset. */
+} Frame_arena;
+
+/** Largest number of checks on one deposit slip: two on the front and thirteen on the back. */
+#define MAXIMUM_CHECKS 15
+
+/** Size of the text buffer in each \ref Slip_op. Longer text is truncated at the last whole UTF-8 character that fits. */
+#define SLIP_OP_TEXT_SIZE 104
+
+/** Number of text operations reserved for each amount field, enough for every digit of a `gint64` and a sign. */
+#define SLIP_AMOUNT_FIELD_OPS 20
+
+/** Number of text operations reserved for the account number printed in boxes. */
+#define SLIP_ACCOUNT_NUMBER_FIELD_OPS 24
+
+/**
+ * Types of drawing operations in a slip display list. See display_list.c.
+ */
+typedef enum {
+	SLIP_OP_STROKE, /**< Stroked open path of up to four points. */
+	SLIP_OP_STROKE_RECTANGLE, /**< Stroked rectangle; `points` holds x, y, width, height. */
+	SLIP_OP_FILL, /**< Filled closed path, such as a triangle. */
+	SLIP_OP_DOT, /**< Filled circle; `points` holds the center and radius. */
+	SLIP_OP_TEXT, /**< Text at a point. */
+	SLIP_OP_ROTATED_TEXT, /**< Text rotated 90 degrees counterclockwise; the point is in the rotated space. */
+	SLIP_OP_STROKE_BATCH /**< Strokes sharing a line width and gray level, stroked together; `batch` indexes \ref Slip_display_list.batches. */
+} Slip_op_type;
+
+/**
+ * Fonts used on the deposit slip.
+ */
+typedef enum {
+	SLIP_FONT_SANS, /**< \ref Data_passer.font_family_sans, normal weight. */
+	SLIP_FONT_MONO_BOLD, /**< \ref Data_passer.font_family_mono, bold. */
+	SLIP_FONT_MICR, /**< \ref Data_passer.font_face_micr, normal weight. */
+	SLIP_FONT_COUNT /**< Number of fonts. */
+} Slip_font;
+
+/**
+ * Variable fields of a slip: runs of text operations that are rewritten when the account or the checks change.
+ */
+typedef enum {
+	SLIP_FIELD_DATE, /**< Today's date on the front. */
+	SLIP_FIELD_NAME, /**< Account holder's name on the front. */
+	SLIP_FIELD_ACCOUNT_NUMBER, /**< Account number printed in boxes on the front. */
+	SLIP_FIELD_MICR, /**< MICR routing and account numbers on the front. */
+	SLIP_FIELD_OTHER_SIDE_TOTAL, /**< Total of the back side, printed on the front. */
+	SLIP_FIELD_SUBTOTAL, /**< Subtotal on the front. */
+	SLIP_FIELD_NET_DEPOSIT, /**< Net deposit on the front. */
+	SLIP_FIELD_BACK_SUBTOTAL, /**< Total at the end of the check listing on the back. */
+	SLIP_FIELD_CHECK_FIRST, /**< Amount of the first check. The amount of check `n` is in field `SLIP_FIELD_CHECK_FIRST + n`. */
+	SLIP_FIELD_COUNT = SLIP_FIELD_CHECK_FIRST + MAXIMUM_CHECKS /**< Number of fields. */
+} Slip_field;
+
+/**
+ * A single drawing operation in a slip display list.
+ */
+typedef struct Slip_op {
+	Slip_op_type type; /**< Type of operation. */
+	guint n_points; /**< Number of x, y pairs used in `points`. */
+	gdouble points[8]; /**< Coordinates of the operation, in points, as x, y pairs. */
+	gdouble line_width; /**< Line width of stroked operations. */
+	gdouble gray; /**< Gray level, where 0 is black and 1 is white. */
+	Slip_font font; /**< Font of text operations. */
+	gdouble font_size; /**< Font size of text operations. */
+	guint batch; /**< Index of the batch drawn by a \ref SLIP_OP_STROKE_BATCH operation. */
+	gchar text[SLIP_OP_TEXT_SIZE]; /**< Text of text operations. An empty string draws nothing. */
+} Slip_op;
+
+/**
+ * Retained list of drawing operations for one side of the deposit slip. See display_list.c.
+ */
+typedef struct Slip_display_list {
+	GArray* ops; /**< Array of \ref Slip_op. */
+	GPtrArray* batches; /**< Arrays of \ref SLIP_OP_STROKE and \ref SLIP_OP_STROKE_RECTANGLE operations grouped by slip_display_list_batch_strokes(). */
+	gint field_first_op[SLIP_FIELD_COUNT]; /**< Index of each field's first operation, or -1 if the field is not on this side. */
+	gint field_op_count[SLIP_FIELD_COUNT]; /**< Number of operations in each field. */
+	gchar font_families[SLIP_FONT_COUNT][100]; /**< Family name of each font. */
+} Slip_display_list;
+
+/**
+ * One cell of a \ref Job_queue.
+ */
+typedef struct Job_queue_cell {
+	gint sequence; /**< Position the cell is free for, or one past the position of the job it holds. */
+	gpointer job; /**< The job, valid while the cell is full. */
+} Job_queue_cell;
+
+/**
+ * Bounded queue of jobs that any number of threads can push to and pop from without a lock. See job_queue.c.
+ */
+typedef struct Job_queue {
+	Job_queue_cell* cells; /**< Ring of cells. */
+	guint mask; /**< Number of cells minus one; the number of cells is a power of two. */
+	gint head; /**< Position of the next job to pop. */
+	gint tail; /**< Position of the next job to push. */
+	gint parked; /**< Number of consumers sleeping in job_queue_pop_wait(). */
+	gint closed; /**< Set by job_queue_close(). */
+	GMutex park_mutex; /**< Held by consumers while they park. */
+	GCond park_cond; /**< Signalled when a job is pushed while consumers are parked. */
+} Job_queue;
+
+/**
+ * Main loop source that dispatches while a \ref Job_queue holds jobs. See job_queue_source_new().
+ */
+typedef struct Job_queue_source {
+	GSource source; /**< Parent source. */
+	Job_queue* queue; /**< Queue drained by the source's callback. */
+	gint wake_pending; /**< Set once the main loop has been woken for the current batch. */
+} Job_queue_source;
+
+/** Number of preview draws kept by \ref Frame_stats. */
+#define FRAME_STATS_SAMPLES 120
+
+/**
+ * What asked for a redraw of the preview, as counted by \ref Frame_stats.
+ */
+typedef enum {
+	REDRAW_SOURCE_GTK, /**< GTK itself, for example when the window is exposed or resized. */
+	REDRAW_SOURCE_APP, /**< The application: switching accounts, adding or deleting rows, switching sides, reloading the layout, or F12. */
+	REDRAW_SOURCE_EDIT, /**< An edited amount. */
+	REDRAW_SOURCE_COUNT /**< Number of sources. */
+} Redraw_source;
+
+/**
+ * Durations of the latest preview draws, shown in a debugging overlay. See frame_stats.c.
+ */
+typedef struct Frame_stats {
+	gint64 durations[FRAME_STATS_SAMPLES]; /**< Ring of draw durations, in microseconds. */
+	gint64 starts[FRAME_STATS_SAMPLES]; /**< When each draw in `durations` started, from `g_get_monotonic_time()`. */
+	guint next; /**< Slot of the ring the next draw is recorded in. */
+	guint n_samples; /**< Number of slots of the ring filled. */
+	gint64 last_render_usec; /**< Time the render thread took for the image on screen, in microseconds. */
+	guint redraws[REDRAW_SOURCE_COUNT]; /**< Number of redraws asked for by each \ref Redraw_source. */
+	Redraw_source pending_source; /**< Source of the next redraw: the most specific source noted since the last redraw. */
+	gboolean visible; /**< Whether the overlay is shown. */
+} Frame_stats;
+
+/**
+ * Parts of the slip that changed since the display lists were last brought up to date. See redraw_scheduler.c.
+ */
+typedef enum {
+	SLIP_DIRTY_PREVIEW = 1 << 0, /**< The display lists changed, for example after they are compiled again. */
+	SLIP_DIRTY_ACCOUNT = 1 << 1, /**< The date, name, account number, and MICR fields. */
+	SLIP_DIRTY_ALL_CHECKS = 1 << 2, /**< Every check's fields and the totals. */
+	SLIP_DIRTY_SIDE = 1 << 3 /**< The preview switched sides; nothing on the slip changed. */
+} Slip_dirty;
+
+/**
+ * Changes to the slip waiting to be applied. See redraw_scheduler.c.
+ */
+typedef struct Slip_redraw {
+	guint dirty; /**< Combination of \ref Slip_dirty flags. */
+	guint32 dirty_checks; /**< One bit per check row whose fields changed. */
+	guint idle_id; /**< Source that applies the changes, or 0 if none is scheduled. */
+} Slip_redraw;
+
+/** Number of preview jobs allocated up front: one in flight, one waiting, and one replacing the one waiting. */
+#define PREVIEW_JOBS 3
+
+/**
+ * Request to rasterize one snapshot of the slip for the preview. See preview_renderer.c.
+ */
+typedef struct Preview_job {
+	Slip_display_list* snapshot; /**< Copy of the display list to draw, one of `sides`. */
+	Slip_display_list* sides[2]; /**< Copies of the back and the front, kept with the job and copied over when it is reused, so each only ever holds lists of one side. */
+	gint width; /**< Width of the preview area. */
+	gint height; /**< Height of the slip in the preview area. */
+	gint scale_factor; /**< Scale factor of the preview area. */
+	gint target; /**< Index of the surface in \ref Preview_renderer.buffers to draw into. */
+	gboolean front; /**< Whether the snapshot is of the front of the slip. */
+	gboolean speculative; /**< Whether the job renders the side not shown, ahead of the user switching to it. */
+	guint generation; /**< Value of \ref Preview_renderer.generation when the job was made. */
+	gint64 render_usec; /**< Time the render thread took to draw the snapshot, in microseconds. */
+} Preview_job;
+
+/**
+ * Thread that rasterizes the preview into one of two image surfaces. See preview_renderer.c.
+ */
+typedef struct Preview_renderer {
+	GThread* thread; /**< The render thread. */
+	Job_queue* requests; /**< Jobs sent to the render thread. */
+	Job_queue* completions; /**< Jobs handed back by the render thread. */
+	GSource* completion_source; /**< Source draining `completions` on the main loop. */
+	cairo_surface_t* buffers[3]; /**< The two image surfaces of the side shown, then the image of the side not shown. The render thread draws into a surface that is not `completed`. */
+	gint completed; /**< Index of the surface on screen, or -1 before the first render. */
+	gboolean hidden_valid; /**< Whether `buffers[2]` holds an up-to-date image of the side not shown. */
+	gboolean hidden_front; /**< Whether `buffers[2]` is an image of the front. */
+	guint generation; /**< Incremented whenever the slip changes, so an image of the side not shown rendered before the change is dropped. */
+	guint speculate_id; /**< Idle source that renders the side not shown, or 0. */
+	struct Data_passer* data_passer; /**< Pointer to user data, read by the idle source. */
+	gboolean in_flight; /**< Whether a job is with the render thread. */
+	Preview_job* next; /**< Job waiting for the one in flight to come back, or `NULL`. */
+	GtkWidget* drawing_area; /**< The preview area. */
+	Frame_stats* frame_stats; /**< Statistics receiving the time each image took to render. */
+	Preview_job* spare_jobs[PREVIEW_JOBS]; /**< Jobs not in use, with their snapshots' arrays kept for reuse. */
+	gint n_spare_jobs; /**< Number of jobs in `spare_jobs`. */
+	guint heap_allocations; /**< Heap allocations made to snapshot the slip since the renderer was created, counted as in slip_display_list_copy_into(). */
+	gint width; /**< Width of the preview area when last drawn. */
+	gint height; /**< Height of the slip in the preview area when last drawn. */
+	gint scale_factor; /**< Scale factor of the preview area when last drawn. */
+} Preview_renderer;
+
+/**
+ * Deposit file mapped into memory. See deposit_file.c.
+ */
+typedef struct Deposit_file {
+	GMappedFile* mapped; /**< The mapped file. */
+	const gchar* account_number; /**< Account number of the deposit, inside the mapping. */
+	guint32 date; /**< Date the deposit was saved, as `yyyymmdd`. */
+	guint32 n_checks; /**< Number of checks. */
+	const gint64* cents; /**< Amount of each check in cents, inside the mapping. */
+} Deposit_file;
+
+/**
+ * One printed deposit in the history. See history_store.c.
+ */
+typedef struct History_record {
+	guint32 date; /**< Date the deposit was printed, as `yyyymmdd`. */
+	guint32 n_checks; /**< Number of checks. */
+	gint64 total_cents; /**< Total of the deposit in cents. */
+	gchar account_number[32]; /**< Account number, padded with zeros. */
+	gint64 cents[MAXIMUM_CHECKS]; /**< Amount of each check in cents; unused entries are zero. */
+} History_record;
+
+/**
+ * Append-only history of printed deposits. See history_store.c.
+ */
+typedef struct History_store {
+	gchar* directory; /**< Directory holding the segments. */
+	GPtrArray* segments; /**< Sealed segments, oldest first. */
+	guint active_number; /**< Number of the segment being appended to. */
+	FILE* active_file; /**< Segment being appended to. */
+	GArray* active; /**< Records of the segment being appended to. */
+} History_store;
+
+/**
+ * On-disk cache of rendered deposit slips, keyed by a hash of their display lists. See render_cache.c.
+ */
+typedef struct Render_cache {
+	gchar* directory; /**< Directory holding the cached files. */
+	gsize maximum_bytes; /**< Largest total size of the cached files. */
+	gsize total_bytes; /**< Total size of the cached files. */
+	GHashTable* entries; /**< Entry of each cached file, keyed by the file's key. */
+} Render_cache;
+
+/**
+ * Running totals of a checks store, kept up to date from the store's signals. See totals_tracker.c.
+ */
+typedef struct Totals_tracker {
+	GtkListStore* store; /**< Store being tracked. */
+	gint64 row_cents[MAXIMUM_CHECKS]; /**< Amount of each row in cents, mirrored from the store. */
+	gint n_rows; /**< Number of rows mirrored. */
+	gint64 front_side; /**< Sum of the checks on the front of the slip (the first two rows). */
+	gint64 back_side; /**< Sum of the checks on the back of the slip. */
+	gint64 total; /**< Sum of all checks deposited. */
+} Totals_tracker;
+
+/**
+ * Rows whose Delete checkbox is marked, kept up to date from the store's signals. See selection_set.c.
+ */
+typedef struct Selection_set {
+	GtkListStore* store; /**< Tracked store. */
+	gint column; /**< Boolean column holding the Delete checkbox. */
+	guint32* words; /**< One bit per row, set if the row is marked. */
+	gint n_words; /**< Number of words allocated in `words`. */
+	gint n_rows; /**< Number of rows in the store. */
+	gint count; /**< Number of marked rows. */
+	GtkWidget* button; /**< Delete button, sensitive while `count` is above zero, or `NULL` while another set drives it. */
+} Selection_set;
+
+/**
+ * Problems found when validating imported accounts. See account_validation.c.
+ */
+typedef enum {
+	ACCOUNT_PROBLEM_NUMBER_NOT_DIGITS, /**< The account number has characters other than digits. */
+	ACCOUNT_PROBLEM_NUMBER_LENGTH, /**< The account number is too short or too long. */
+	ACCOUNT_PROBLEM_ROUTING_NOT_DIGITS, /**< The routing number has characters other than digits. */
+	ACCOUNT_PROBLEM_ROUTING_LENGTH, /**< The routing number is not nine digits. */
+	ACCOUNT_PROBLEM_ROUTING_CHECKSUM /**< The routing number fails the ABA checksum. */
+} Account_problem_type;
+
+/**
+ * A problem found in one account.
+ */
+typedef struct Account_problem {
+	guint row; /**< Row of the account in the imported table. */
+	Account_problem_type type; /**< The problem. */
+} Account_problem;
+
+/**
+ * A deposit being prepared for one account. See deposit_session.c.
+ */
+typedef struct Deposit {
+	GtkTreeRowReference* account; /**< Row of the account in the Slip tab's accounts list, or `NULL` before any account is selected. */
+	GtkListStore* checks_store; /**< Checks being deposited. */
+	Totals_tracker* totals; /**< Running totals of `checks_store`, in cents. */
+	Selection_set* check_selection; /**< Checks marked for deletion in `checks_store`. */
+	gboolean modified; /**< Whether checks were added, edited, deleted, or loaded from a file since the deposit was created. */
+} Deposit;
+
+/**
+ * All deposits prepared in this session, one per account.
+ */
+typedef struct Deposit_session {
+	GHashTable* by_account; /**< Deposits keyed by account number. */
+	GPtrArray* deposits; /**< Deposits in the order they were started. Owns the deposits. */
+} Deposit_session;
+
+/**
+ * One bank in the routing directory, as stored in the compiled index. See routing_directory.c.
+ */
+typedef struct Routing_entry {
+	guint32 routing_number; /**< Routing number as an integer. */
+	gchar office_code; /**< `O` for a main office, `B` for a branch. */
+	gchar record_type; /**< `0` if the bank is its own servicer, `1` or `2` if another routing number services it. */
+	gchar bank_name[38]; /**< Bank name, without trailing spaces. */
+} Routing_entry;
+
 /**
  * Structure for passing data between functions.
  */
@@ -165,28 +528,34 @@ typedef struct Data_passer {
 	GtkListStore* list_store_master;
 	/** Pointer to temporary list store of checking accounts. */
 	GtkListStore* list_store_temporary;
-	/** Pointer to cairo context for previewing and printing checks. */
-	cairo_t* cairo_context;
+	/** Strings of the accounts in both list stores, whose account columns hold offsets into it. */
+	Account_table* account_table;
 	/** Pointer to checks tree view. */
 	GtkWidget* check_tree_view;
 	/** Indicates currently drawing the front of the slip. */
 	gboolean front_slip_active;
 	/** Pointer to drawing area for slip. */
 	GtkWidget* drawing_area;
-	/** Pointer to list store of the checks.  */
-	GtkListStore* checks_store;
-	/** Sum of all checks deposited.  */
-	gfloat total_deposit;
-	/** Sum of all checks listed on back of slip.  */
-	gfloat total_back_side;
+	/** Deposit of the account selected in the Slip tab. Its checks are shown in \ref Data_passer.check_tree_view.  */
+	Deposit* deposit;
+	/** Deposits prepared in this session.  */
+	Deposit_session* session;
 	/** Pointer to tree view of accounts in the deposit slip tab.  */
 	GtkWidget* checks_accounts_treeview;
 	/** Pointer to the application window.  */
 	GtkWidget* application_window;
 	/** Pointer to the renderer for radio buttons.  */
 	GtkCellRenderer* radio_renderer;
+	/** Pointer to the add button in the checks view.  */
+	GtkWidget* btn_checks_add;
 	/** Pointer to the delete button in the checks view.  */
 	GtkWidget* btn_checks_delete;
+	/** Pointer to the tree view in the Accounts tab. `NULL` until the tab is built.  */
+	GtkWidget* accounts_tree_view;
+	/** Pointer to the delete button in the Accounts tab. `NULL` until the tab is built.  */
+	GtkWidget* btn_accounts_delete;
+	/** Accounts marked for deletion in \ref Data_passer.list_store_temporary. `NULL` until the Accounts tab is built.  */
+	Selection_set* account_selection;
 	/** Pointer to the go_to_first button in the checks view.  */
 	GtkWidget* btn_go_to_first;
 	/** Pointer to the go_to_last button in the checks view.  */
@@ -207,59 +576,192 @@ typedef struct Data_passer {
 	gpointer btn_font_monospace;
 	/** Scaling for font size, applied to the static Name and Account labels. */
 	gdouble font_size_static_label_scaling;
-	/** Structure containing printing coordinates on the front side of the deposit slip. See Front.*/
-	Front* front;
-	/** Structure containing printing coordinates on the back side of the deposit slip. See Back.*/
-	Back* back;
+	/** Current layout of the deposit slip, swapped when the configuration file changes. See slip_layout.c. */
+	Slip_layout* layout;
+	/** Layout read while a print job held the current one, published when the job releases it, or `NULL`. */
+	Slip_layout* layout_pending;
+	/** Number of print jobs holding \ref Data_passer.layout. */
+	guint layout_holds;
+	/** Monitor of the configuration file, for reloading the layout. */
+	GFileMonitor* layout_monitor;
 	/** Object containing the CSS definitions.*/
 	GtkCssProvider* css_provider;
 	/** Soft gray text color for rendering the new account row. */
 	GdkRGBA new_account_foreground;
+	/** Red text color for rendering routing numbers that fail the checksum. */
+	GdkRGBA invalid_routing_foreground;
 	/** Black text color for rendering the new account row. */
 	GdkRGBA existing_account_foreground;
 	/** Pointer to application icon. */
 	GdkPixbuf *application_icon;
+	/** Scratch memory for the preview frame or printed page currently being drawn. */
+	Frame_arena* frame_arena;
+	/** Display list of the front of the slip, replayed by the preview and the printer. */
+	Slip_display_list* slip_front;
+	/** Display list of the back of the slip, replayed by the preview and the printer. */
+	Slip_display_list* slip_back;
+	/** History of printed deposits. */
+	History_store* history;
+	/** Rendered slips, reused when printing or exporting a slip that has not changed. */
+	Render_cache* render_cache;
+	/** Renders the preview off the UI thread. */
+	Preview_renderer* preview_renderer;
+	/** Timings of the preview, shown with F12. */
+	Frame_stats* frame_stats;
+	/** Changes to the slip waiting to be applied. */
+	Slip_redraw redraw;
 } Data_passer;
 
-/**
- * Current UI state of a selected check.
- */
-typedef struct CheckSelections {
-	GtkTreePath* path; /**< Path to selected check. */
-	gboolean at_least_one_check_selected; /**< Indicates at least one check is selected */
-} CheckSelection;
-
 void on_app_activate(GApplication* app, gpointer data);
-void build_list_store(gpointer account, gpointer list_builder_struct);
+void build_list_store(const Account_table* table, GtkListStore* list_store);
 
 GtkWidget* make_tree_view(GtkListStore* list_store, Data_passer* data_passer);
 
 GtkWidget* get_child_from_parent(GtkWidget* parent, const gchar* child_name);
 void read_configuration_data(Data_passer* data_passer);
+Slip_layout* read_slip_layout_file(void);
+Slip_layout* slip_layout_new(void);
+Slip_layout* slip_layout_ref(Slip_layout* layout);
+void slip_layout_unref(Slip_layout* layout);
+void slip_layout_publish(Data_passer* data_passer, Slip_layout* layout);
+Slip_layout* slip_layout_hold(Data_passer* data_passer);
+void slip_layout_release(Data_passer* data_passer, Slip_layout* layout);
+void slip_layout_watch(Data_passer* data_passer);
 GtkWidget* make_accounts_buttons_hbox(Data_passer* data_passer);
 void free_memory(GtkWidget* window, gpointer user_data);
 
-gboolean preview_deposit_amounts_front(GtkTreeModel* model,
-									   GtkTreePath* path,
-									   GtkTreeIter* iter,
-									   gpointer data);
+void print_deposit_slip(GtkButton* self, gpointer data);
+void draw_slip_pages(Data_passer* data_passer, cairo_t* cr, gboolean with_back, gdouble page_width);
+void export_deposit_slip(GtkButton* self, gpointer data);
+void print_all_deposit_slips(GtkButton* self, gpointer data);
+void save_deposit(GtkButton* self, gpointer data);
+void open_deposit(GtkButton* self, gpointer data);
+void open_all_deposits(GtkButton* self, gpointer data);
+void reprint_last_deposit(GtkButton* self, gpointer data);
+gchar* deposit_file_path(const gchar* account_number);
+gboolean deposit_file_save(const gchar* path, const gchar* account_number, GtkTreeModel* checks);
+Deposit_file* deposit_file_open(const gchar* path);
+void deposit_file_close(Deposit_file* file);
+GPtrArray* deposit_file_open_directory(const gchar* directory);
+GtkListStore* checks_store_from_cents(const gint64* cents, guint n_checks);
+GtkListStore* deposit_file_checks_store(const Deposit_file* file);
+const gchar* formatted_date(Frame_arena* arena);
 
-gboolean preview_deposit_amounts_back(GtkTreeModel* model,
-									  GtkTreePath* path,
-									  GtkTreeIter* iter,
-									  gpointer data);
+Slip_display_list* slip_display_list_new(void);
+Slip_display_list* slip_display_list_copy(const Slip_display_list* list);
+guint slip_display_list_copy_into(Slip_display_list* copy, const Slip_display_list* list);
+void slip_display_list_clear(Slip_display_list* list);
+void slip_display_list_free(Slip_display_list* list);
+void slip_display_list_set_fonts(Slip_display_list* list, Data_passer* data_passer);
+void slip_text_extents(Slip_display_list* list, Slip_font font, gdouble font_size, const gchar* text, cairo_text_extents_t* extents);
+void slip_add_line(Slip_display_list* list, gdouble x0, gdouble y0, gdouble x1, gdouble y1, gdouble line_width, gdouble gray);
+void slip_add_polyline(Slip_display_list* list, const gdouble* points, guint n_points, gdouble line_width, gdouble gray);
+void slip_add_rectangle(Slip_display_list* list, gdouble x, gdouble y, gdouble width, gdouble height, gdouble line_width, gdouble gray);
+void slip_add_triangle(Slip_display_list* list, const gdouble* points, gdouble gray);
+void slip_add_dot(Slip_display_list* list, gdouble x, gdouble y, gdouble radius, gdouble gray);
+void slip_set_text_op(Slip_op* op, gboolean rotated, Slip_font font, gdouble font_size, gdouble x, gdouble y, const gchar* text, gdouble gray);
+void slip_add_text(Slip_display_list* list, Slip_font font, gdouble font_size, gdouble x, gdouble y, const gchar* text, gdouble gray);
+void slip_add_rotated_text(Slip_display_list* list, Slip_font font, gdouble font_size, gdouble x, gdouble y, const gchar* text, gdouble gray);
+void slip_display_list_batch_strokes(Slip_display_list* list);
+void slip_reserve_field(Slip_display_list* list, Slip_field field, gint op_count);
+Slip_op* slip_field_op(Slip_display_list* list, Slip_field field, gint index);
+void slip_clear_field(Slip_display_list* list, Slip_field field);
+void slip_display_list_replay(const Slip_display_list* list, cairo_t* cr);
+void slip_display_list_checksum(const Slip_display_list* list, GChecksum* checksum);
 
-void print_deposit_slip(GtkButton* self, gpointer data);
-gchar* comma_formatted_amount(gfloat amount);
+void text_metrics_extents(const gchar* family, cairo_font_weight_t weight, gdouble font_size, const gchar* text, cairo_text_extents_t* extents);
+void text_metrics_clear(void);
+void text_metrics_free(void);
+
+Totals_tracker* totals_tracker_new(GtkListStore* store);
+void totals_tracker_free(Totals_tracker* tracker);
+Selection_set* selection_set_new(GtkListStore* store, gint column, GtkWidget* button);
+GtkListStore* selection_set_copy_unmarked(const Selection_set* set);
+void selection_set_bind_button(Selection_set* set, GtkWidget* button);
+void routing_directory_open(const gchar* directory_path, const gchar* index_path);
+gboolean routing_number_valid_digits(const gchar* digits);
+gboolean routing_number_valid(const gchar* routing_number);
+const Routing_entry* routing_directory_lookup(const gchar* routing_number);
+void routing_directory_close(void);
+Deposit_session* deposit_session_new(void);
+void deposit_session_free(Deposit_session* session);
+void deposit_session_select(Data_passer* data_passer);
+void deposit_set_checks_store(Deposit* deposit, GtkListStore* checks_store);
+gchar* deposit_account_number(const Data_passer* data_passer, const Deposit* deposit);
+History_store* history_store_open(const gchar* directory);
+gboolean history_store_append(History_store* store, const History_record* record);
+GArray* history_store_find_account(History_store* store, const gchar* account_number, guint32 first_date, guint32 last_date);
+GArray* history_store_find_amount(History_store* store, gint64 minimum_cents, gint64 maximum_cents);
+gboolean history_record_from_deposit(const Deposit* deposit, const gchar* account_number, History_record* record);
+void history_record_deposit(Data_passer* data_passer, const Deposit* deposit);
+void history_store_close(History_store* store);
+Render_cache* render_cache_open(const gchar* directory, gsize maximum_bytes);
+gchar* render_cache_key(const Slip_display_list* front, const Slip_display_list* back, gdouble page_width, gdouble page_height);
+gchar* render_cache_lookup_path(Render_cache* cache, const gchar* key);
+gboolean render_cache_store(Render_cache* cache, const gchar* key, GBytes* output);
+void render_cache_close(Render_cache* cache);
+Frame_stats* frame_stats_new(void);
+void frame_stats_note_source(Frame_stats* stats, Redraw_source source);
+void frame_stats_record_render(Frame_stats* stats, gint64 usec);
+void frame_stats_record_draw(Frame_stats* stats, gint64 start, gint64 usec);
+void frame_stats_paint(Frame_stats* stats, cairo_t* cr);
+gboolean frame_stats_key_pressed(GtkWidget* widget, GdkEventKey* event, gpointer data);
+void slip_redraw_schedule(Data_passer* data_passer, guint dirty, Redraw_source source);
+void slip_redraw_schedule_check(Data_passer* data_passer, gint row, Redraw_source source);
+void slip_redraw_flush(Data_passer* data_passer);
+void slip_redraw_cancel(Data_passer* data_passer);
+GArray* account_validation_run(const Account_table* table);
+Account_table* account_table_new(void);
+void account_table_add(Account_table* table, const gchar* number, const gchar* name, const gchar* description, const gchar* routing);
+const gchar* account_table_string(const Account_table* table, guint32 offset);
+guint32 account_table_intern(Account_table* table, const gchar* text);
+const gchar* account_table_column(const Account_table* table, GtkTreeModel* model, GtkTreeIter* iter, gint column);
+void account_table_rebuild(Data_passer* data_passer);
+void account_table_free(Account_table* table);
+const gchar* account_problem_description(Account_problem_type type);
+void selection_set_free(Selection_set* set);
+
+void slip_compile(Data_passer* data_passer);
+void slip_update_account(Data_passer* data_passer);
+void slip_update_check(Data_passer* data_passer, gint row);
+void slip_update_all_checks(Data_passer* data_passer);
+void slip_account_changed(GtkTreeSelection* tree_selection, gpointer data);
+
+Frame_arena* frame_arena_new(gsize initial_capacity);
+gpointer frame_arena_alloc(Frame_arena* arena, gsize size);
+gchar* frame_arena_strdup(Frame_arena* arena, const gchar* text);
+gchar* frame_arena_strconcat(Frame_arena* arena, const gchar* first, ...) G_GNUC_NULL_TERMINATED;
+gchar* frame_arena_printf(Frame_arena* arena, const gchar* format, ...) G_GNUC_PRINTF(2, 3);
+void frame_arena_reset(Frame_arena* arena);
+void frame_arena_free(Frame_arena* arena);
+
+extern const Amount_separators AMOUNT_SEPARATORS_PLAIN;
+gsize amount_format_cents(gint64 cents, const Amount_separators* separators, gchar* buffer);
+gsize amount_format_digits(gint64 cents, gsize minimum_width, gchar* buffer);
+gboolean amount_parse_cents(const gchar* text, const Amount_separators* separators, gint64* cents);
 
-void free_gslist_account(gpointer data);
 
 GtkWidget* make_slip_view(Data_passer* data_passer);
-void update_label(GtkTreeView* tree_view, gpointer user_data);
+void update_label(GtkTreeView* tree_view, GtkTreePath* path, GtkTreeViewColumn* column, gpointer user_data);
 void deposit_amount_edited(GtkCellRendererText* self, gchar* path, gchar* new_text, gpointer data);
 void check_toggle_clicked(GtkCellRendererToggle* renderer, gchar* path, gpointer data);
 void toggle_slip_view(GtkWidget* widget, gpointer data);
 void add_check_row(GtkWidget* widget, gpointer data);
 void delete_check_rows(GtkWidget* widget, gpointer data);
 void draw_preview(GtkWidget* widget, cairo_t* cr, gpointer data);
+Job_queue* job_queue_new(guint capacity);
+void job_queue_free(Job_queue* queue);
+gboolean job_queue_push(Job_queue* queue, gpointer job);
+gpointer job_queue_pop(Job_queue* queue);
+gpointer job_queue_pop_wait(Job_queue* queue);
+void job_queue_close(Job_queue* queue);
+gboolean job_queue_is_empty(Job_queue* queue);
+GSource* job_queue_source_new(Job_queue* queue, GSourceFunc callback, gpointer data);
+gboolean job_queue_source_push(GSource* source, gpointer job);
+Preview_renderer* preview_renderer_new(Data_passer* data_passer);
+void preview_renderer_discard_hidden(Preview_renderer* renderer);
+gboolean preview_renderer_flip(Data_passer* data_passer);
+void preview_renderer_free(Preview_renderer* renderer);
+void preview_renderer_invalidate(Data_passer* data_passer);
+void preview_renderer_paint(Data_passer* data_passer, cairo_t* cr, gint width, gint height, gint scale_factor);
 gint number_of_checks(Data_passer* data_passer);
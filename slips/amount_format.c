@@ -0,0 +1,214 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file amount_format.c
+ * @brief Formats and parses amounts held as integer cents.
+ *
+ * All functions work on `gint64` cents over the full 64-bit range and write into buffers supplied by the caller, so
+ * nothing here allocates or depends on floating-point rounding.
+ */
+
+/**
+ * The two-digit strings `00` through `99` laid end to end. Converting a number two digits at a time through this table halves
+ * the number of divisions compared to one digit at a time.
+ */
+static const gchar digit_pairs[201] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+/**
+ * Separators for amounts stored in the checks model and typed by the user. These do not change with the locale because
+ * number_formatter() only lets the user type a period.
+ */
+const Amount_separators AMOUNT_SEPARATORS_PLAIN = {'\0', '.'};
+
+/**
+ * Writes the decimal digits of an unsigned number, right-aligned, ending just before `end`.
+ * @param value Number to convert.
+ * @param end Pointer one past the last digit to write.
+ * @return Pointer to the first digit written.
+ */
+static gchar *write_digits_backwards(guint64 value, gchar *end) {
+	while (value >= 100) {
+		guint pair = (value % 100) * 2;
+		value /= 100;
+		*--end = digit_pairs[pair + 1];
+		*--end = digit_pairs[pair];
+	}
+	if (value >= 10) {
+		guint pair = value * 2;
+		*--end = digit_pairs[pair + 1];
+		*--end = digit_pairs[pair];
+	} else {
+		*--end = '0' + value;
+	}
+	return end;
+}
+
+/**
+ * Returns the magnitude of a number of cents without overflowing on `G_MININT64`.
+ * @param cents Amount in cents.
+ * @return The absolute value as an unsigned number.
+ */
+static guint64 cents_magnitude(gint64 cents) {
+	return cents < 0 ? (guint64)(-(cents + 1)) + 1 : (guint64)cents;
+}
+
+/**
+ * Formats an amount into a familiar currency value. For example, takes 5100372 cents and formats it into `51,003.72`.
+ * Every group of three dollar digits is separated, up to the largest `gint64`.
+ * @param cents Amount in cents.
+ * @param separators Grouping and decimal separators. A grouping separator of `'\0'` writes the dollars without grouping.
+ * @param buffer Buffer of at least \ref AMOUNT_BUFFER_SIZE bytes receiving the formatted amount.
+ * @return Length of the formatted amount, not counting the terminating `'\0'`.
+ */
+gsize amount_format_cents(gint64 cents, const Amount_separators *separators, gchar *buffer) {
+	gchar digits[AMOUNT_BUFFER_SIZE];
+	gchar *digits_end = digits + sizeof(digits);
+	guint64 magnitude = cents_magnitude(cents);
+
+	gchar *dollars = write_digits_backwards(magnitude / 100, digits_end);
+	gsize dollar_digits = digits_end - dollars;
+	guint cents_pair = (magnitude % 100) * 2;
+
+	gchar *out = buffer;
+	if (cents < 0) {
+		*out++ = '-';
+	}
+
+	/* Copy the dollars, inserting a separator before each group of three digits after the first group. */
+	gsize first_group = dollar_digits % 3;
+	if (first_group == 0) {
+		first_group = 3;
+	}
+	memcpy(out, dollars, first_group);
+	out += first_group;
+	for (gsize i = first_group; i < dollar_digits; i += 3) {
+		if (separators->grouping != '\0') {
+			*out++ = separators->grouping;
+		}
+		memcpy(out, dollars + i, 3);
+		out += 3;
+	}
+
+	*out++ = separators->decimal;
+	*out++ = digit_pairs[cents_pair];
+	*out++ = digit_pairs[cents_pair + 1];
+	*out = '\0';
+
+	return out - buffer;
+}
+
+/**
+ * Writes the digits of an amount in cents with no separators or decimal point, as printed one digit per box on the slip.
+ * For example, 5100372 cents is written as `5100372`.
+ * @param cents Amount in cents.
+ * @param minimum_width The result is padded on the left with spaces to at least this many characters.
+ * @param buffer Buffer of at least \ref AMOUNT_BUFFER_SIZE bytes receiving the digits.
+ * @return Length of the digits, not counting the terminating `'\0'`.
+ */
+gsize amount_format_digits(gint64 cents, gsize minimum_width, gchar *buffer) {
+	gchar digits[AMOUNT_BUFFER_SIZE];
+	gchar *digits_end = digits + sizeof(digits);
+	gchar *first = write_digits_backwards(cents_magnitude(cents), digits_end);
+	if (cents < 0) {
+		*--first = '-';
+	}
+	gsize length = digits_end - first;
+
+	gchar *out = buffer;
+	minimum_width = MIN(minimum_width, (gsize)AMOUNT_BUFFER_SIZE - 1);
+	for (gsize i = length; i < minimum_width; i++) {
+		*out++ = ' ';
+	}
+	memcpy(out, first, length);
+	out += length;
+	*out = '\0';
+
+	return out - buffer;
+}
+
+/**
+ * Parses an amount such as `1,234.56`, `-12.5`, or `7` into cents. Grouping separators are skipped wherever they appear, and
+ * leading and trailing spaces are ignored. Fractions of a cent are rounded half away from zero.
+ * @param text Text to parse.
+ * @param separators Grouping and decimal separators expected in `text`.
+ * @param cents Receives the amount in cents if parsing succeeds.
+ * @return `TRUE` if `text` holds an amount that fits in a `gint64`, `FALSE` otherwise. `cents` is unchanged on failure.
+ */
+gboolean amount_parse_cents(const gchar *text, const Amount_separators *separators, gint64 *cents) {
+	const gchar *current = text;
+	gboolean negative = FALSE;
+	gboolean seen_digit = FALSE;
+	guint64 dollars = 0;
+	guint64 fraction = 0;
+
+	while (*current == ' ') {
+		current++;
+	}
+	if (*current == '-') {
+		negative = TRUE;
+		current++;
+	}
+
+	/* Dollars. */
+	for (; *current != '\0'; current++) {
+		if (*current >= '0' && *current <= '9') {
+			guint digit = *current - '0';
+			if (dollars > (G_MAXUINT64 - digit) / 10) {
+				return FALSE;
+			}
+			dollars = dollars * 10 + digit;
+			seen_digit = TRUE;
+		} else if (separators->grouping != '\0' && *current == separators->grouping) {
+			continue;
+		} else {
+			break;
+		}
+	}
+
+	/* Cents, plus one more digit for rounding. Further digits are checked but ignored. */
+	if (*current == separators->decimal) {
+		current++;
+		gint fraction_digits = 0;
+		for (; *current >= '0' && *current <= '9'; current++) {
+			if (fraction_digits < 3) {
+				fraction = fraction * 10 + (*current - '0');
+			}
+			fraction_digits++;
+			seen_digit = TRUE;
+		}
+		for (; fraction_digits < 3; fraction_digits++) {
+			fraction *= 10;
+		}
+		fraction = (fraction + 5) / 10;
+	}
+
+	while (*current == ' ') {
+		current++;
+	}
+	if (*current != '\0' || !seen_digit) {
+		return FALSE;
+	}
+
+	/* The magnitude of G_MININT64 is one more than G_MAXINT64. */
+	guint64 limit = negative ? (guint64)G_MAXINT64 + 1 : (guint64)G_MAXINT64;
+	if (dollars > limit / 100 || dollars * 100 > limit - fraction) {
+		return FALSE;
+	}
+	guint64 magnitude = dollars * 100 + fraction;
+
+	*cents = negative ? (gint64)(~magnitude + 1) : (gint64)magnitude;
+	return TRUE;
+}
@@ -0,0 +1,229 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file deposit_file.c
+ * @brief Saves deposits in progress to `.dslip` files and maps them back into memory.
+ *
+ * A `.dslip` file is a \ref Deposit_file_header followed by the amount of each check in cents, as 64-bit integers in the
+ * machine's byte order. Files are written with `g_file_set_contents()`, which replaces the old file only once the new one is
+ * complete. Opening a file maps it and checks the header; the amounts are read in place, with nothing to parse.
+ */
+
+/** Identifies a deposit file. */
+#define DEPOSIT_FILE_MAGIC "DSLP"
+
+/** Version of the file layout. Files with another version are not opened. */
+#define DEPOSIT_FILE_VERSION 1
+
+/** Extension of deposit files. */
+#define DEPOSIT_FILE_EXTENSION ".dslip"
+
+/**
+ * Header at the start of a deposit file. Its size is a multiple of eight, so the amounts that follow are aligned.
+ */
+typedef struct Deposit_file_header {
+	gchar magic[4]; /**< \ref DEPOSIT_FILE_MAGIC. */
+	guint32 version; /**< \ref DEPOSIT_FILE_VERSION. */
+	guint32 date; /**< Date the deposit was saved, as `yyyymmdd`. */
+	guint32 n_checks; /**< Number of amounts following the header. */
+	gchar account_number[32]; /**< Account number, padded with zeros. */
+} Deposit_file_header;
+
+/**
+ * Determines whether an account number can name a deposit file and fit in its header: one or more digits and nothing else, so
+ * the file name cannot leave \ref DEPOSITS_DIRECTORY.
+ * @param account_number Account number.
+ * @return `TRUE` if the account number is valid.
+ */
+static gboolean account_number_is_valid(const gchar *account_number) {
+	gsize length = strlen(account_number);
+
+	if (length == 0 || length >= sizeof(((Deposit_file_header *)NULL)->account_number)) {
+		return FALSE;
+	}
+	for (gsize i = 0; i < length; i++) {
+		if (!g_ascii_isdigit(account_number[i])) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Returns the path of the file a deposit for an account is saved in.
+ * @param account_number Account number.
+ * @return The path, or `NULL` if the account number is not all digits. Free with `g_free()`.
+ */
+gchar *deposit_file_path(const gchar *account_number) {
+	if (!account_number_is_valid(account_number)) {
+		g_print("Account number `%s' cannot name a deposit file\n", account_number);
+		return NULL;
+	}
+	gchar *name = g_strconcat(account_number, DEPOSIT_FILE_EXTENSION, NULL);
+	gchar *path = g_build_filename(DEPOSITS_DIRECTORY, name, NULL);
+	g_free(name);
+	return path;
+}
+
+/**
+ * Saves the checks of a deposit. Deposits that deposit_file_open() would refuse, with no checks or an account number that is
+ * not all digits, are not saved.
+ * @param path Path of the file, replaced if it exists.
+ * @param account_number Account number of the deposit.
+ * @param checks Checks store of the deposit.
+ * @return `TRUE` if the file was written.
+ */
+gboolean deposit_file_save(const gchar *path, const gchar *account_number, GtkTreeModel *checks) {
+	Deposit_file_header header = {0};
+	gint n_checks = gtk_tree_model_iter_n_children(checks, NULL);
+
+	if (!account_number_is_valid(account_number)) {
+		g_print("Account number `%s' cannot be saved\n", account_number);
+		return FALSE;
+	}
+	if (n_checks == 0 || n_checks > MAXIMUM_CHECKS) {
+		g_print("A deposit of %d checks cannot be saved\n", n_checks);
+		return FALSE;
+	}
+
+	GDateTime *now = g_date_time_new_now_local();
+	memcpy(header.magic, DEPOSIT_FILE_MAGIC, sizeof(header.magic));
+	header.version = DEPOSIT_FILE_VERSION;
+	header.date = g_date_time_get_year(now) * 10000 + g_date_time_get_month(now) * 100 + g_date_time_get_day_of_month(now);
+	header.n_checks = n_checks;
+	g_strlcpy(header.account_number, account_number, sizeof(header.account_number));
+	g_date_time_unref(now);
+
+	gsize length = sizeof(header) + n_checks * sizeof(gint64);
+	gchar *contents = g_malloc(length);
+	memcpy(contents, &header, sizeof(header));
+	gint64 *cents = (gint64 *)(contents + sizeof(header));
+
+	GtkTreeIter iter;
+	gboolean valid = gtk_tree_model_get_iter_first(checks, &iter);
+	for (gint i = 0; valid; i++) {
+		gtk_tree_model_get(checks, &iter, CHECK_CENTS, &cents[i], -1);
+		valid = gtk_tree_model_iter_next(checks, &iter);
+	}
+
+	GError *error = NULL;
+	g_mkdir_with_parents(DEPOSITS_DIRECTORY, 0700);
+	gboolean written = g_file_set_contents(path, contents, length, &error);
+	if (!written) {
+		g_print("Unable to write `%s': %s\n", path, error->message);
+		g_error_free(error);
+	}
+	g_free(contents);
+	return written;
+}
+
+/**
+ * Maps a deposit file into memory and checks its header.
+ * @param path Path of the file.
+ * @return Pointer to the opened file, or `NULL` if it cannot be read or is not a deposit file. Free with deposit_file_close().
+ */
+Deposit_file *deposit_file_open(const gchar *path) {
+	GError *error = NULL;
+	GMappedFile *mapped = g_mapped_file_new(path, FALSE, &error);
+	if (mapped == NULL) {
+		g_print("Unable to map `%s': %s\n", path, error->message);
+		g_error_free(error);
+		return NULL;
+	}
+
+	const gchar *contents = g_mapped_file_get_contents(mapped);
+	gsize length = g_mapped_file_get_length(mapped);
+	const Deposit_file_header *header = (const Deposit_file_header *)contents;
+	if (length < sizeof(Deposit_file_header) ||
+		memcmp(header->magic, DEPOSIT_FILE_MAGIC, sizeof(header->magic)) != 0 ||
+		header->version != DEPOSIT_FILE_VERSION ||
+		header->n_checks == 0 || header->n_checks > MAXIMUM_CHECKS ||
+		length != sizeof(Deposit_file_header) + header->n_checks * sizeof(gint64) ||
+		memchr(header->account_number, '\0', sizeof(header->account_number)) == NULL ||
+		!account_number_is_valid(header->account_number)) {
+		g_print("`%s' is not a deposit file\n", path);
+		g_mapped_file_unref(mapped);
+		return NULL;
+	}
+
+	Deposit_file *file = g_new(Deposit_file, 1);
+	file->mapped = mapped;
+	file->account_number = header->account_number;
+	file->date = header->date;
+	file->n_checks = header->n_checks;
+	file->cents = (const gint64 *)(contents + sizeof(Deposit_file_header));
+	return file;
+}
+
+/**
+ * Unmaps a deposit file.
+ * @param file Pointer to the file.
+ */
+void deposit_file_close(Deposit_file *file) {
+	g_mapped_file_unref(file->mapped);
+	g_free(file);
+}
+
+/**
+ * Opens every deposit file in a directory.
+ * @param directory Path of the directory.
+ * @return Array of \ref Deposit_file, in no particular order, empty if the directory cannot be read. Free with
+ * `g_ptr_array_unref()`, which closes the files.
+ */
+GPtrArray *deposit_file_open_directory(const gchar *directory) {
+	GPtrArray *files = g_ptr_array_new_with_free_func((GDestroyNotify)deposit_file_close);
+	GDir *dir = g_dir_open(directory, 0, NULL);
+	if (dir == NULL) {
+		return files;
+	}
+
+	const gchar *name;
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		if (!g_str_has_suffix(name, DEPOSIT_FILE_EXTENSION)) {
+			continue;
+		}
+		gchar *path = g_build_filename(directory, name, NULL);
+		Deposit_file *file = deposit_file_open(path);
+		if (file != NULL) {
+			g_ptr_array_add(files, file);
+		}
+		g_free(path);
+	}
+	g_dir_close(dir);
+	return files;
+}
+
+/**
+ * Creates a checks store holding a list of amounts, one check per amount.
+ * @param cents Amount of each check in cents.
+ * @param n_checks Number of checks.
+ * @return The store, with a reference owned by the caller.
+ */
+GtkListStore *checks_store_from_cents(const gint64 *cents, guint n_checks) {
+	GtkListStore *checks_store = gtk_list_store_new(SLIP_COLUMNS, G_TYPE_STRING, G_TYPE_BOOLEAN, G_TYPE_INT64);
+	gchar formatted_amount[AMOUNT_BUFFER_SIZE];
+
+	for (guint i = 0; i < n_checks; i++) {
+		amount_format_cents(cents[i], &AMOUNT_SEPARATORS_PLAIN, formatted_amount);
+		gtk_list_store_insert_with_values(checks_store, NULL, -1,
+										  CHECK_AMOUNT, formatted_amount,
+										  CHECK_RADIO, FALSE,
+										  CHECK_CENTS, cents[i],
+										  -1);
+	}
+	return checks_store;
+}
+
+/**
+ * Creates a checks store holding the amounts of a deposit file.
+ * @param file Pointer to the file.
+ * @return The store, with a reference owned by the caller.
+ */
+GtkListStore *deposit_file_checks_store(const Deposit_file *file) {
+	return checks_store_from_cents(file->cents, file->n_checks);
+}
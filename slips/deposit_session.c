@@ -0,0 +1,357 @@
+#include <gtk/gtk.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file deposit_session.c
+ * @brief Keeps one deposit in progress for each account selected in the Slip tab.
+ *
+ * Each \ref Deposit has its own checks store, with the totals tracker and selection set that follow it. Selecting an account
+ * looks up its deposit in a hash table and points the checks view at the deposit's store, so the checks entered for one
+ * customer are still there after serving another, and switching takes the same time however many deposits are open. Deposits
+ * are saved to and loaded from the files in deposit_file.c.
+ */
+
+/**
+ * Creates a deposit with the same single check as a new Slip tab.
+ * @param account Row of the account in the Slip tab's accounts list, or `NULL` for the deposit used before any account is
+ * selected.
+ * @return Pointer to the deposit. Freed with the session.
+ */
+static Deposit *deposit_new(GtkTreeRowReference *account) {
+	Deposit *deposit = g_new0(Deposit, 1);
+	deposit->account = account;
+
+	GtkListStore *checks_store = gtk_list_store_new(SLIP_COLUMNS, G_TYPE_STRING, G_TYPE_BOOLEAN, G_TYPE_INT64);
+	gtk_list_store_insert_with_values(checks_store, NULL, -1,
+									  CHECK_AMOUNT, "1.00",
+									  CHECK_RADIO, FALSE,
+									  CHECK_CENTS, (gint64)100,
+									  -1);
+
+	deposit->checks_store = checks_store;
+	/* Keep the totals current as checks are added, edited, and deleted. */
+	deposit->totals = totals_tracker_new(checks_store);
+	/* The Delete button is bound to the set when the deposit becomes current, in deposit_session_select(). */
+	deposit->check_selection = selection_set_new(checks_store, CHECK_RADIO, NULL);
+	return deposit;
+}
+
+/**
+ * Frees a deposit. Used as the free function of \ref Deposit_session.deposits.
+ * @param data Pointer to the deposit.
+ */
+static void deposit_free(gpointer data) {
+	Deposit *deposit = (Deposit *)data;
+	selection_set_free(deposit->check_selection);
+	totals_tracker_free(deposit->totals);
+	g_object_unref(deposit->checks_store);
+	if (deposit->account != NULL) {
+		gtk_tree_row_reference_free(deposit->account);
+	}
+	g_free(deposit);
+}
+
+/**
+ * Replaces a deposit's checks store, moving the totals tracker and selection set to the new store. The new set keeps the Delete
+ * button if the old one held it. The caller attaches the new store to the checks view if the deposit is the current one.
+ * @param deposit Pointer to the deposit.
+ * @param checks_store The new store. The deposit takes over the caller's reference.
+ */
+void deposit_set_checks_store(Deposit *deposit, GtkListStore *checks_store) {
+	GtkWidget *button = deposit->check_selection->button;
+	selection_set_free(deposit->check_selection);
+	totals_tracker_free(deposit->totals);
+	g_object_unref(deposit->checks_store);
+
+	deposit->checks_store = checks_store;
+	deposit->totals = totals_tracker_new(checks_store);
+	deposit->check_selection = selection_set_new(checks_store, CHECK_RADIO, button);
+}
+
+/**
+ * Creates an empty session.
+ * @return Pointer to the session. Free with deposit_session_free().
+ */
+Deposit_session *deposit_session_new(void) {
+	Deposit_session *session = g_new(Deposit_session, 1);
+	session->by_account = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	session->deposits = g_ptr_array_new_with_free_func(deposit_free);
+	return session;
+}
+
+/**
+ * Frees a session and all of its deposits. Called from free_memory().
+ * @param session Pointer to the session.
+ */
+void deposit_session_free(Deposit_session *session) {
+	g_hash_table_destroy(session->by_account);
+	g_ptr_array_unref(session->deposits);
+	g_free(session);
+}
+
+/**
+ * Sets the controls of the checks view from the current deposit: the Add button, the Delete checkboxes, and the first and last
+ * page buttons. The Delete button follows the deposit's selection set, which holds it while the deposit is current. The preview
+ * shows the front of the slip.
+ * @param data_passer Pointer to user data.
+ */
+static void refresh_check_controls(Data_passer *data_passer) {
+	gint checks = number_of_checks(data_passer);
+
+	gtk_widget_set_sensitive(data_passer->btn_checks_add, checks < MAXIMUM_CHECKS);
+	g_object_set(data_passer->radio_renderer, "activatable", checks > 1, NULL);
+
+	data_passer->front_slip_active = TRUE;
+	if (checks > 2) {
+		gtk_widget_show(data_passer->btn_go_to_first);
+		gtk_widget_show(data_passer->btn_go_to_last);
+		gtk_widget_set_sensitive(data_passer->btn_go_to_first, FALSE);
+		gtk_widget_set_sensitive(data_passer->btn_go_to_last, TRUE);
+	} else {
+		gtk_widget_hide(data_passer->btn_go_to_first);
+		gtk_widget_hide(data_passer->btn_go_to_last);
+	}
+}
+
+/**
+ * Looks up the deposit of an account, creating it the first time the account is seen.
+ * @param data_passer Pointer to user data.
+ * @param account_number Account number, or `""` for the deposit used before any account is selected. The session takes it over.
+ * @param account Row of the account in the Slip tab's accounts list, or `NULL`. The session takes it over.
+ * @return Pointer to the deposit.
+ */
+static Deposit *deposit_for_account(Data_passer *data_passer, gchar *account_number, GtkTreeRowReference *account) {
+	Deposit_session *session = data_passer->session;
+	Deposit *deposit = g_hash_table_lookup(session->by_account, account_number);
+
+	if (deposit == NULL) {
+		deposit = deposit_new(account);
+		g_ptr_array_add(session->deposits, deposit);
+		g_hash_table_insert(session->by_account, account_number, deposit); /* The table owns account_number. */
+	} else {
+		if (account != NULL) {
+			gtk_tree_row_reference_free(account);
+		}
+		g_free(account_number);
+	}
+	return deposit;
+}
+
+/**
+ * Makes the deposit of the account selected in the Slip tab current, creating it the first time the account is selected.
+ * The checks view is pointed at the deposit's store; no checks are copied. Does nothing once the session has been freed.
+ * @param data_passer Pointer to user data.
+ * \sa slip_account_changed()
+ */
+void deposit_session_select(Data_passer *data_passer) {
+	GtkTreeModel *model;
+	GtkTreeIter iter;
+	gchar *account_number = NULL;
+	GtkTreeRowReference *account = NULL;
+
+	if (data_passer->session == NULL) {
+		return;
+	}
+	GtkTreeSelection *tree_selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(data_passer->checks_accounts_treeview));
+	if (gtk_tree_selection_get_selected(tree_selection, &model, &iter)) {
+		account_number = g_strdup(account_table_column(data_passer->account_table, model, &iter, ACCOUNT_NUMBER));
+		GtkTreePath *path = gtk_tree_model_get_path(model, &iter);
+		account = gtk_tree_row_reference_new(model, path);
+		gtk_tree_path_free(path);
+	} else {
+		account_number = g_strdup("");
+	}
+
+	Deposit *deposit = deposit_for_account(data_passer, account_number, account);
+	if (deposit == data_passer->deposit) {
+		return;
+	}
+	/* Only the deposit shown in the checks view drives the Delete button. */
+	if (data_passer->deposit != NULL) {
+		selection_set_bind_button(data_passer->deposit->check_selection, NULL);
+	}
+	selection_set_bind_button(deposit->check_selection, data_passer->btn_checks_delete);
+	data_passer->deposit = deposit;
+	gtk_tree_view_set_model(GTK_TREE_VIEW(data_passer->check_tree_view), GTK_TREE_MODEL(deposit->checks_store));
+	refresh_check_controls(data_passer);
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_ALL_CHECKS, REDRAW_SOURCE_APP);
+}
+
+/**
+ * Replaces the checks of a deposit with checks loaded from elsewhere, and shows them if the deposit is the current one.
+ * @param data_passer Pointer to user data.
+ * @param deposit Pointer to the deposit.
+ * @param checks_store The loaded checks. The deposit takes over the caller's reference.
+ */
+static void replace_checks(Data_passer *data_passer, Deposit *deposit, GtkListStore *checks_store) {
+	deposit_set_checks_store(deposit, checks_store);
+	deposit->modified = TRUE;
+	if (deposit == data_passer->deposit) {
+		gtk_tree_view_set_model(GTK_TREE_VIEW(data_passer->check_tree_view), GTK_TREE_MODEL(deposit->checks_store));
+		refresh_check_controls(data_passer);
+		slip_redraw_schedule(data_passer, SLIP_DIRTY_ALL_CHECKS, REDRAW_SOURCE_APP);
+	}
+}
+
+/**
+ * Indexes the rows of the Slip tab's accounts list by account number, so loading thousands of saved deposits does not walk
+ * the list for each one.
+ * @param data_passer Pointer to user data.
+ * @return Hash table from account number to row number plus one. The keys point into the account table. Free with
+ * `g_hash_table_destroy()` before the account table changes.
+ */
+static GHashTable *index_account_rows(Data_passer *data_passer) {
+	GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(data_passer->checks_accounts_treeview));
+	GHashTable *rows = g_hash_table_new(g_str_hash, g_str_equal);
+	GtkTreeIter iter;
+	gint row = 0;
+	gboolean valid = gtk_tree_model_get_iter_first(model, &iter);
+
+	while (valid) {
+		const gchar *account_number = account_table_column(data_passer->account_table, model, &iter, ACCOUNT_NUMBER);
+		g_hash_table_insert(rows, (gpointer)account_number, GINT_TO_POINTER(++row));
+		valid = gtk_tree_model_iter_next(model, &iter);
+	}
+	return rows;
+}
+
+/**
+ * Replaces the checks of an account's deposit with those in a deposit file. Files for accounts that are not in the Slip tab's
+ * accounts list are skipped.
+ * @param data_passer Pointer to user data.
+ * @param rows Index of the accounts list made by index_account_rows().
+ * @param file Pointer to the opened file.
+ * @return `TRUE` if the deposit was loaded.
+ */
+static gboolean load_deposit(Data_passer *data_passer, GHashTable *rows, const Deposit_file *file) {
+	gint row = GPOINTER_TO_INT(g_hash_table_lookup(rows, file->account_number));
+	if (row == 0) {
+		g_print("No account `%s' for its saved deposit\n", file->account_number);
+		return FALSE;
+	}
+
+	GtkTreeModel *model = gtk_tree_view_get_model(GTK_TREE_VIEW(data_passer->checks_accounts_treeview));
+	GtkTreePath *path = gtk_tree_path_new_from_indices(row - 1, -1);
+	Deposit *deposit = deposit_for_account(data_passer, g_strdup(file->account_number), gtk_tree_row_reference_new(model, path));
+	gtk_tree_path_free(path);
+
+	replace_checks(data_passer, deposit, deposit_file_checks_store(file));
+	return TRUE;
+}
+
+/**
+ * Returns the account number of a deposit.
+ * @param data_passer Pointer to user data.
+ * @param deposit Pointer to the deposit.
+ * @return The account number, or `NULL` for the deposit used before any account is selected or if the account was deleted.
+ * Free with `g_free()`.
+ */
+gchar *deposit_account_number(const Data_passer *data_passer, const Deposit *deposit) {
+	GtkTreeRowReference *account = deposit->account;
+	if (account == NULL || !gtk_tree_row_reference_valid(account)) {
+		return NULL;
+	}
+
+	GtkTreeModel *model = gtk_tree_row_reference_get_model(account);
+	GtkTreePath *path = gtk_tree_row_reference_get_path(account);
+	GtkTreeIter iter;
+	gchar *account_number = NULL;
+	if (gtk_tree_model_get_iter(model, &iter, path)) {
+		account_number = g_strdup(account_table_column(data_passer->account_table, model, &iter, ACCOUNT_NUMBER));
+	}
+	gtk_tree_path_free(path);
+	return account_number;
+}
+
+/**
+ * Callback fired when the user clicks the Save button. Saves the current deposit in \ref DEPOSITS_DIRECTORY, replacing the
+ * account's earlier save.
+ * @param self Pointer to the clicked button.
+ * @param data Pointer to user data.
+ */
+void save_deposit(GtkButton *self, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+	gchar *account_number = deposit_account_number(data_passer, data_passer->deposit);
+	if (account_number == NULL) {
+		return;
+	}
+
+	gchar *path = deposit_file_path(account_number);
+	if (path != NULL) {
+		deposit_file_save(path, account_number, GTK_TREE_MODEL(data_passer->deposit->checks_store));
+		g_free(path);
+	}
+	g_free(account_number);
+}
+
+/**
+ * Callback fired when the user clicks the Open button. Replaces the checks of the current deposit with the account's saved
+ * deposit, if there is one.
+ * @param self Pointer to the clicked button.
+ * @param data Pointer to user data.
+ */
+void open_deposit(GtkButton *self, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+	gchar *account_number = deposit_account_number(data_passer, data_passer->deposit);
+	if (account_number == NULL) {
+		return;
+	}
+
+	gchar *path = deposit_file_path(account_number);
+	if (path != NULL && g_file_test(path, G_FILE_TEST_EXISTS)) {
+		Deposit_file *file = deposit_file_open(path);
+		if (file != NULL) {
+			GHashTable *rows = index_account_rows(data_passer);
+			load_deposit(data_passer, rows, file);
+			g_hash_table_destroy(rows);
+			deposit_file_close(file);
+		}
+	}
+	g_free(path);
+	g_free(account_number);
+}
+
+/**
+ * Callback fired when the user clicks the Open All button. Loads every deposit saved in \ref DEPOSITS_DIRECTORY into the
+ * session, ready for print_all_deposit_slips().
+ * @param self Pointer to the clicked button.
+ * @param data Pointer to user data.
+ */
+void open_all_deposits(GtkButton *self, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+	GPtrArray *files = deposit_file_open_directory(DEPOSITS_DIRECTORY);
+	GHashTable *rows = index_account_rows(data_passer);
+
+	for (guint i = 0; i < files->len; i++) {
+		load_deposit(data_passer, rows, g_ptr_array_index(files, i));
+	}
+	g_hash_table_destroy(rows);
+	g_ptr_array_unref(files);
+}
+
+/**
+ * Callback fired when the user clicks the Reprint button. Replaces the checks of the current deposit with those of the
+ * account's most recently printed deposit in the history, ready to be printed again. Does nothing if the account has never been
+ * printed.
+ * @param self Pointer to the clicked button.
+ * @param data Pointer to user data.
+ */
+void reprint_last_deposit(GtkButton *self, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+	gchar *account_number = deposit_account_number(data_passer, data_passer->deposit);
+	if (account_number == NULL || data_passer->history == NULL) {
+		g_free(account_number);
+		return;
+	}
+
+	GArray *printed = history_store_find_account(data_passer->history, account_number, 0, G_MAXUINT32);
+	if (printed->len > 0) {
+		/* Records are sorted from oldest to newest. */
+		const History_record *last = &g_array_index(printed, History_record, printed->len - 1);
+		replace_checks(data_passer, data_passer->deposit, checks_store_from_cents(last->cents, MIN(last->n_checks, MAXIMUM_CHECKS)));
+	}
+	g_array_unref(printed);
+	g_free(account_number);
+}
@@ -0,0 +1,515 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file display_list.c
+ * @brief Retained list of drawing operations for one side of the deposit slip.
+ *
+ * The layout and the data of a slip compile into an array of \ref Slip_op. The same array is replayed onto the preview (scaled to the
+ * drawing area) and onto the printer, so the two always agree. Variable data, such as check amounts and the account's name, live in
+ * fields: runs of operations reserved at compile time that can be rewritten in place without touching the rest of the list.
+ */
+
+/**
+ * Creates an empty display list.
+ * @return Pointer to the new list. Free with slip_display_list_free().
+ */
+Slip_display_list *slip_display_list_new(void) {
+	Slip_display_list *list = g_new0(Slip_display_list, 1);
+	list->ops = g_array_new(FALSE, TRUE, sizeof(Slip_op));
+	list->batches = g_ptr_array_new_with_free_func((GDestroyNotify)g_array_unref);
+	slip_display_list_clear(list);
+	return list;
+}
+
+/**
+ * Copies a list, for example to hand to the preview's render thread. The copy shares nothing with the original, so the
+ * original can be rewritten while the copy is replayed.
+ * @param list Pointer to the list.
+ * @return Pointer to the copy. Free with slip_display_list_free().
+ */
+Slip_display_list *slip_display_list_copy(const Slip_display_list *list) {
+	Slip_display_list *copy = slip_display_list_new();
+	slip_display_list_copy_into(copy, list);
+	return copy;
+}
+
+/**
+ * Copies a list over an earlier copy, reusing the earlier copy's arrays. Once the arrays have held a list as large as this one,
+ * copying allocates nothing, so the preview can snapshot the slip on every edit without going to the heap.
+ * @param copy Pointer to the list receiving the copy.
+ * @param list Pointer to the list copied.
+ * @return Number of arrays that grew past the length they last had. An array is only reallocated when it grows, so this is at
+ * least the number of heap allocations made, and 0 means none were.
+ */
+guint slip_display_list_copy_into(Slip_display_list *copy, const Slip_display_list *list) {
+	guint grown = (list->ops->len > copy->ops->len) + (list->batches->len > copy->batches->len);
+
+	g_array_set_size(copy->ops, list->ops->len);
+	memcpy(copy->ops->data, list->ops->data, list->ops->len * sizeof(Slip_op));
+
+	/* Extra batches of a larger earlier copy are freed. */
+	if (copy->batches->len > list->batches->len) {
+		g_ptr_array_set_size(copy->batches, list->batches->len);
+	}
+	for (guint i = 0; i < list->batches->len; i++) {
+		GArray *batch = g_ptr_array_index(list->batches, i);
+		if (i == copy->batches->len) {
+			g_ptr_array_add(copy->batches, g_array_sized_new(FALSE, FALSE, sizeof(Slip_op), batch->len));
+			grown++;
+		} else {
+			grown += batch->len > ((GArray *)g_ptr_array_index(copy->batches, i))->len;
+		}
+		GArray *copy_batch = g_ptr_array_index(copy->batches, i);
+		g_array_set_size(copy_batch, batch->len);
+		memcpy(copy_batch->data, batch->data, batch->len * sizeof(Slip_op));
+	}
+
+	memcpy(copy->field_first_op, list->field_first_op, sizeof(list->field_first_op));
+	memcpy(copy->field_op_count, list->field_op_count, sizeof(list->field_op_count));
+	memcpy(copy->font_families, list->font_families, sizeof(list->font_families));
+	return grown;
+}
+
+/**
+ * Removes all operations and fields from a list.
+ * @param list Pointer to the list.
+ */
+void slip_display_list_clear(Slip_display_list *list) {
+	g_array_set_size(list->ops, 0);
+	g_ptr_array_set_size(list->batches, 0);
+	for (gint i = 0; i < SLIP_FIELD_COUNT; i++) {
+		list->field_first_op[i] = -1;
+		list->field_op_count[i] = 0;
+	}
+}
+
+/**
+ * Frees a display list.
+ * @param list Pointer to the list.
+ */
+void slip_display_list_free(Slip_display_list *list) {
+	g_array_free(list->ops, TRUE);
+	g_ptr_array_free(list->batches, TRUE);
+	g_free(list);
+}
+
+/**
+ * Sets the font families the list's text operations refer to. Call this before adding any text.
+ * @param list Pointer to the list.
+ * @param data_passer Pointer to user data holding the configured font families.
+ */
+void slip_display_list_set_fonts(Slip_display_list *list, Data_passer *data_passer) {
+	g_strlcpy(list->font_families[SLIP_FONT_SANS], data_passer->font_family_sans, sizeof(list->font_families[0]));
+	g_strlcpy(list->font_families[SLIP_FONT_MONO_BOLD], data_passer->font_family_mono, sizeof(list->font_families[0]));
+	g_strlcpy(list->font_families[SLIP_FONT_MICR], data_passer->font_face_micr, sizeof(list->font_families[0]));
+}
+
+/**
+ * Returns the cairo weight of one of the list's fonts.
+ * @param font Font in the list.
+ * @return The font's weight.
+ */
+static cairo_font_weight_t slip_font_weight(Slip_font font) {
+	return font == SLIP_FONT_MONO_BOLD ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL;
+}
+
+/**
+ * Measures text in one of the list's fonts. Measurements come from the cache in text_metrics.c, so each string is measured once per font and size.
+ * @param list Pointer to the list.
+ * @param font Font in which the text is drawn.
+ * @param font_size Font size in points.
+ * @param text Text to measure.
+ * @param extents Receives the text's extents in points.
+ */
+void slip_text_extents(Slip_display_list *list, Slip_font font, gdouble font_size, const gchar *text, cairo_text_extents_t *extents) {
+	text_metrics_extents(list->font_families[font], slip_font_weight(font), font_size, text, extents);
+}
+
+/**
+ * Appends a blank operation to a list.
+ * @param list Pointer to the list.
+ * @param type Type of the operation.
+ * @param gray Gray level of the operation, where 0 is black and 1 is white.
+ * @return Pointer to the new operation, valid until the next operation is appended.
+ */
+static Slip_op *slip_append_op(Slip_display_list *list, Slip_op_type type, gdouble gray) {
+	g_array_set_size(list->ops, list->ops->len + 1);
+	Slip_op *op = &g_array_index(list->ops, Slip_op, list->ops->len - 1);
+	op->type = type;
+	op->gray = gray;
+	return op;
+}
+
+/**
+ * Appends a stroked line.
+ * @param list Pointer to the list.
+ * @param x0 x position of the start of the line.
+ * @param y0 y position of the start of the line.
+ * @param x1 x position of the end of the line.
+ * @param y1 y position of the end of the line.
+ * @param line_width Width of the line.
+ * @param gray Gray level of the line.
+ */
+void slip_add_line(Slip_display_list *list, gdouble x0, gdouble y0, gdouble x1, gdouble y1, gdouble line_width, gdouble gray) {
+	Slip_op *op = slip_append_op(list, SLIP_OP_STROKE, gray);
+	op->points[0] = x0;
+	op->points[1] = y0;
+	op->points[2] = x1;
+	op->points[3] = y1;
+	op->n_points = 2;
+	op->line_width = line_width;
+}
+
+/**
+ * Appends a stroked open path of up to four points, such as the brackets on the front of the slip.
+ * @param list Pointer to the list.
+ * @param points Coordinates of the points as x, y pairs.
+ * @param n_points Number of points, at most four.
+ * @param line_width Width of the line.
+ * @param gray Gray level of the line.
+ */
+void slip_add_polyline(Slip_display_list *list, const gdouble *points, guint n_points, gdouble line_width, gdouble gray) {
+	Slip_op *op = slip_append_op(list, SLIP_OP_STROKE, gray);
+	memcpy(op->points, points, n_points * 2 * sizeof(gdouble));
+	op->n_points = n_points;
+	op->line_width = line_width;
+}
+
+/**
+ * Appends a stroked rectangle.
+ * @param list Pointer to the list.
+ * @param x x position of the top-left corner.
+ * @param y y position of the top-left corner.
+ * @param width Width of the rectangle.
+ * @param height Height of the rectangle.
+ * @param line_width Width of the line.
+ * @param gray Gray level of the line.
+ */
+void slip_add_rectangle(Slip_display_list *list, gdouble x, gdouble y, gdouble width, gdouble height, gdouble line_width, gdouble gray) {
+	Slip_op *op = slip_append_op(list, SLIP_OP_STROKE_RECTANGLE, gray);
+	op->points[0] = x;
+	op->points[1] = y;
+	op->points[2] = width;
+	op->points[3] = height;
+	op->n_points = 2;
+	op->line_width = line_width;
+}
+
+/**
+ * Appends a filled triangle.
+ * @param list Pointer to the list.
+ * @param points Coordinates of the three vertices as x, y pairs.
+ * @param gray Gray level of the triangle.
+ */
+void slip_add_triangle(Slip_display_list *list, const gdouble *points, gdouble gray) {
+	Slip_op *op = slip_append_op(list, SLIP_OP_FILL, gray);
+	memcpy(op->points, points, 6 * sizeof(gdouble));
+	op->n_points = 3;
+}
+
+/**
+ * Appends a filled dot, such as the decimal point in the net deposit row.
+ * @param list Pointer to the list.
+ * @param x x position of the center.
+ * @param y y position of the center.
+ * @param radius Radius of the dot.
+ * @param gray Gray level of the dot.
+ */
+void slip_add_dot(Slip_display_list *list, gdouble x, gdouble y, gdouble radius, gdouble gray) {
+	Slip_op *op = slip_append_op(list, SLIP_OP_DOT, gray);
+	op->points[0] = x;
+	op->points[1] = y;
+	op->points[2] = radius;
+	op->n_points = 1;
+}
+
+/**
+ * Fills in a text operation.
+ * @param op Operation to fill in.
+ * @param rotated `TRUE` if the text is drawn rotated 90 degrees counterclockwise, in which case `x` and `y` are in the rotated space.
+ * @param font Font of the text.
+ * @param font_size Font size in points.
+ * @param x x position of the text's origin.
+ * @param y y position of the text's origin.
+ * @param text Text to draw. Text longer than \ref SLIP_OP_TEXT_SIZE is truncated at the last whole character that fits.
+ * @param gray Gray level of the text.
+ */
+void slip_set_text_op(Slip_op *op, gboolean rotated, Slip_font font, gdouble font_size, gdouble x, gdouble y, const gchar *text, gdouble gray) {
+	op->type = rotated ? SLIP_OP_ROTATED_TEXT : SLIP_OP_TEXT;
+	op->font = font;
+	op->font_size = font_size;
+	op->points[0] = x;
+	op->points[1] = y;
+	op->n_points = 1;
+	op->gray = gray;
+
+	const gchar *source = (text != NULL) ? text : "";
+	gsize length = strlen(source);
+	if (length >= sizeof(op->text)) {
+		/* Half a UTF-8 sequence would put cairo in an error state and stop everything drawn after it. */
+		const gchar *last = g_utf8_find_prev_char(source, source + sizeof(op->text));
+		length = (last != NULL) ? (gsize)(last - source) : 0;
+	}
+	memcpy(op->text, source, length);
+	op->text[length] = '\0';
+}
+
+/**
+ * Appends text.
+ * @param list Pointer to the list.
+ * @param font Font of the text.
+ * @param font_size Font size in points.
+ * @param x x position of the text's origin.
+ * @param y y position of the text's origin.
+ * @param text Text to draw.
+ * @param gray Gray level of the text.
+ */
+void slip_add_text(Slip_display_list *list, Slip_font font, gdouble font_size, gdouble x, gdouble y, const gchar *text, gdouble gray) {
+	slip_set_text_op(slip_append_op(list, SLIP_OP_TEXT, gray), FALSE, font, font_size, x, y, text, gray);
+}
+
+/**
+ * Appends text rotated 90 degrees counterclockwise.
+ * @param list Pointer to the list.
+ * @param font Font of the text.
+ * @param font_size Font size in points.
+ * @param x x position of the text's origin in the rotated space.
+ * @param y y position of the text's origin in the rotated space.
+ * @param text Text to draw.
+ * @param gray Gray level of the text.
+ */
+void slip_add_rotated_text(Slip_display_list *list, Slip_font font, gdouble font_size, gdouble x, gdouble y, const gchar *text, gdouble gray) {
+	slip_set_text_op(slip_append_op(list, SLIP_OP_ROTATED_TEXT, gray), TRUE, font, font_size, x, y, text, gray);
+}
+
+/**
+ * Groups all strokes sharing a line width and gray level into batches, so that replaying the list strokes each group once instead
+ * of once per line. Each batch is drawn at the position of its first stroke; other operations keep their order. The static grid
+ * of the slip has hundreds of lines but only a few combinations of width and gray, so this cuts the number of strokes to a handful
+ * and makes the PostScript sent to the printer much smaller.
+ *
+ * Call this after adding the static parts of the slip and before reserving fields, because it renumbers the operations.
+ * @param list Pointer to the list.
+ */
+void slip_display_list_batch_strokes(Slip_display_list *list) {
+	GArray *batched_ops = g_array_sized_new(FALSE, TRUE, sizeof(Slip_op), list->ops->len);
+
+	for (guint i = 0; i < list->ops->len; i++) {
+		const Slip_op *op = &g_array_index(list->ops, Slip_op, i);
+
+		if (op->type != SLIP_OP_STROKE && op->type != SLIP_OP_STROKE_RECTANGLE) {
+			g_array_append_val(batched_ops, *op);
+			continue;
+		}
+
+		/* Look for a batch with the same line width and gray level. There are only a few, so a linear search is enough. */
+		GArray *batch = NULL;
+		for (guint j = 0; j < list->batches->len; j++) {
+			GArray *candidate = g_ptr_array_index(list->batches, j);
+			const Slip_op *first = &g_array_index(candidate, Slip_op, 0);
+			if (first->line_width == op->line_width && first->gray == op->gray) {
+				batch = candidate;
+				break;
+			}
+		}
+
+		if (batch == NULL) {
+			batch = g_array_new(FALSE, FALSE, sizeof(Slip_op));
+			Slip_op batch_op = {0};
+			batch_op.type = SLIP_OP_STROKE_BATCH;
+			batch_op.line_width = op->line_width;
+			batch_op.gray = op->gray;
+			batch_op.batch = list->batches->len;
+			g_ptr_array_add(list->batches, batch);
+			g_array_append_val(batched_ops, batch_op);
+		}
+		g_array_append_val(batch, *op);
+	}
+
+	g_array_free(list->ops, TRUE);
+	list->ops = batched_ops;
+}
+
+/**
+ * Adds the path of a stroke operation to the current path, without stroking it.
+ * @param cr Cairo context.
+ * @param op A \ref SLIP_OP_STROKE or \ref SLIP_OP_STROKE_RECTANGLE operation.
+ */
+static void append_stroke_path(cairo_t *cr, const Slip_op *op) {
+	const gdouble *p = op->points;
+
+	if (op->type == SLIP_OP_STROKE_RECTANGLE) {
+		cairo_rectangle(cr, p[0], p[1], p[2], p[3]);
+		return;
+	}
+	cairo_move_to(cr, p[0], p[1]);
+	for (guint j = 1; j < op->n_points; j++) {
+		cairo_line_to(cr, p[2 * j], p[2 * j + 1]);
+	}
+}
+
+/**
+ * Reserves a run of empty text operations for a variable field. The operations draw nothing until the field is written with
+ * slip_field_op().
+ * @param list Pointer to the list.
+ * @param field Field to reserve.
+ * @param op_count Number of operations in the field.
+ */
+void slip_reserve_field(Slip_display_list *list, Slip_field field, gint op_count) {
+	list->field_first_op[field] = list->ops->len;
+	list->field_op_count[field] = op_count;
+	for (gint i = 0; i < op_count; i++) {
+		slip_append_op(list, SLIP_OP_TEXT, 0)->text[0] = '\0';
+	}
+}
+
+/**
+ * Returns one of the operations in a field so it can be rewritten in place.
+ * @param list Pointer to the list.
+ * @param field Field in the list.
+ * @param index Index of the operation within the field.
+ * @return Pointer to the operation, or `NULL` if the list does not have that field or the index is past the end of the field.
+ */
+Slip_op *slip_field_op(Slip_display_list *list, Slip_field field, gint index) {
+	if (list->field_first_op[field] < 0 || index >= list->field_op_count[field]) {
+		return NULL;
+	}
+	return &g_array_index(list->ops, Slip_op, list->field_first_op[field] + index);
+}
+
+/**
+ * Blanks every operation in a field.
+ * @param list Pointer to the list.
+ * @param field Field in the list.
+ */
+void slip_clear_field(Slip_display_list *list, Slip_field field) {
+	for (gint i = 0; i < list->field_op_count[field]; i++) {
+		Slip_op *op = slip_field_op(list, field, i);
+		op->type = SLIP_OP_TEXT;
+		op->text[0] = '\0';
+	}
+}
+
+/**
+ * Adds one operation to a checksum, field by field, so the stale bytes after a text's terminating zero do not change the sum.
+ * @param checksum Checksum being computed.
+ * @param op The operation.
+ */
+static void checksum_op(GChecksum *checksum, const Slip_op *op) {
+	g_checksum_update(checksum, (const guchar *)&op->type, sizeof(op->type));
+	g_checksum_update(checksum, (const guchar *)op->points, sizeof(op->points));
+	g_checksum_update(checksum, (const guchar *)&op->line_width, sizeof(op->line_width));
+	g_checksum_update(checksum, (const guchar *)&op->gray, sizeof(op->gray));
+	g_checksum_update(checksum, (const guchar *)&op->font, sizeof(op->font));
+	g_checksum_update(checksum, (const guchar *)&op->font_size, sizeof(op->font_size));
+	g_checksum_update(checksum, (const guchar *)&op->batch, sizeof(op->batch));
+	g_checksum_update(checksum, (const guchar *)op->text, strlen(op->text) + 1);
+}
+
+/**
+ * Adds everything a list draws to a checksum: its fonts, operations, and batches. Two lists with the same checksum draw the
+ * same page, so the checksum can key a cache of rendered output.
+ * @param list Pointer to the list.
+ * @param checksum Checksum being computed.
+ */
+void slip_display_list_checksum(const Slip_display_list *list, GChecksum *checksum) {
+	for (gint font = 0; font < SLIP_FONT_COUNT; font++) {
+		g_checksum_update(checksum, (const guchar *)list->font_families[font], strlen(list->font_families[font]) + 1);
+	}
+	for (guint i = 0; i < list->ops->len; i++) {
+		checksum_op(checksum, &g_array_index(list->ops, Slip_op, i));
+	}
+	for (guint i = 0; i < list->batches->len; i++) {
+		GArray *batch = g_ptr_array_index(list->batches, i);
+		for (guint j = 0; j < batch->len; j++) {
+			checksum_op(checksum, &g_array_index(batch, Slip_op, j));
+		}
+	}
+}
+
+/**
+ * Draws a list onto a cairo context. The caller sets up any translation or scaling; the list is drawn in points with the
+ * slip's top-left corner at the origin.
+ * @param list Pointer to the list.
+ * @param cr Cairo context of the preview, printer, or PDF surface.
+ */
+void slip_display_list_replay(const Slip_display_list *list, cairo_t *cr) {
+	gint current_font = -1;
+	gdouble current_font_size = -1;
+
+	cairo_save(cr);
+	cairo_new_path(cr);
+
+	for (guint i = 0; i < list->ops->len; i++) {
+		const Slip_op *op = &g_array_index(list->ops, Slip_op, i);
+		const gdouble *p = op->points;
+
+		if ((op->type == SLIP_OP_TEXT || op->type == SLIP_OP_ROTATED_TEXT) && op->text[0] == '\0') {
+			continue; /* Unused slot in a field. */
+		}
+
+		cairo_set_source_rgb(cr, op->gray, op->gray, op->gray);
+
+		switch (op->type) {
+			case SLIP_OP_STROKE:
+			case SLIP_OP_STROKE_RECTANGLE:
+				cairo_set_line_width(cr, op->line_width);
+				append_stroke_path(cr, op);
+				cairo_stroke(cr);
+				break;
+
+			case SLIP_OP_STROKE_BATCH: {
+				GArray *batch = g_ptr_array_index(list->batches, op->batch);
+				cairo_set_line_width(cr, op->line_width);
+				for (guint j = 0; j < batch->len; j++) {
+					append_stroke_path(cr, &g_array_index(batch, Slip_op, j));
+				}
+				cairo_stroke(cr);
+				break;
+			}
+
+			case SLIP_OP_FILL:
+				cairo_move_to(cr, p[0], p[1]);
+				for (guint j = 1; j < op->n_points; j++) {
+					cairo_line_to(cr, p[2 * j], p[2 * j + 1]);
+				}
+				cairo_close_path(cr);
+				cairo_fill(cr);
+				break;
+
+			case SLIP_OP_DOT:
+				cairo_arc(cr, p[0], p[1], p[2], 0, 2 * G_PI);
+				cairo_fill(cr);
+				break;
+
+			case SLIP_OP_TEXT:
+			case SLIP_OP_ROTATED_TEXT:
+				if (current_font != (gint)op->font) {
+					cairo_select_font_face(cr, list->font_families[op->font], CAIRO_FONT_SLANT_NORMAL, slip_font_weight(op->font));
+					current_font = op->font;
+				}
+				if (current_font_size != op->font_size) {
+					cairo_set_font_size(cr, op->font_size);
+					current_font_size = op->font_size;
+				}
+				if (op->type == SLIP_OP_ROTATED_TEXT) {
+					cairo_save(cr);
+					cairo_rotate(cr, -G_PI_2);
+					cairo_move_to(cr, p[0], p[1]);
+					cairo_show_text(cr, op->text);
+					cairo_restore(cr);
+				} else {
+					cairo_move_to(cr, p[0], p[1]);
+					cairo_show_text(cr, op->text);
+				}
+				cairo_new_path(cr);
+				break;
+		}
+	}
+
+	cairo_restore(cr);
+}
@@ -0,0 +1,171 @@
+#include <gtk/gtk.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file frame_arena.c
+ * @brief Bump allocator for scratch memory used while drawing a single preview frame or printed page.
+ */
+
+/**
+ * Alignment of every block returned from the arena.
+ */
+#define FRAME_ARENA_ALIGNMENT 8
+
+/**
+ * Creates a frame arena. The arena's memory is freed in free_memory().
+ * @param initial_capacity Size in bytes of the first block. The arena grows at the end of any frame that overflows it.
+ * @return Pointer to a new arena.
+ */
+Frame_arena *frame_arena_new(gsize initial_capacity) {
+	Frame_arena *arena = g_new(Frame_arena, 1);
+	arena->capacity = initial_capacity;
+	arena->block = g_malloc(initial_capacity);
+	arena->used = 0;
+	arena->high_water = 0;
+	arena->overflow = NULL;
+	arena->heap_allocations = 1;
+	arena->heap_allocations_at_reset = arena->heap_allocations;
+	return arena;
+}
+
+/**
+ * Returns a block of scratch memory that stays valid until the next call to frame_arena_reset(). If the current block is full, the
+ * memory comes from the heap and is tracked in \ref Frame_arena.overflow, so the caller never needs to free anything.
+ * @param arena Pointer to the arena.
+ * @param size Number of bytes requested.
+ * @return Pointer to at least `size` bytes aligned on an 8-byte boundary.
+ */
+gpointer frame_arena_alloc(Frame_arena *arena, gsize size) {
+	gsize aligned_size = (size + FRAME_ARENA_ALIGNMENT - 1) & ~((gsize)FRAME_ARENA_ALIGNMENT - 1);
+
+	if (arena->used + aligned_size > arena->capacity) {
+		/* Current block is full. Keep the frame going from the heap, and remember how much we wanted so the
+		next reset can size the block to fit the whole frame. */
+		gpointer overflow_block = g_malloc(aligned_size);
+		arena->overflow = g_slist_prepend(arena->overflow, overflow_block);
+		arena->heap_allocations++;
+		arena->used += aligned_size;
+		return overflow_block;
+	}
+
+	gpointer memory = arena->block + arena->used;
+	arena->used += aligned_size;
+	return memory;
+}
+
+/**
+ * Copies a string into the arena.
+ * @param arena Pointer to the arena.
+ * @param text String to copy. Can be `NULL`.
+ * @return The copy, valid until the next frame_arena_reset(), or `NULL` if `text` is `NULL`.
+ */
+gchar *frame_arena_strdup(Frame_arena *arena, const gchar *text) {
+	if (text == NULL) {
+		return NULL;
+	}
+	gsize length = strlen(text) + 1;
+	gchar *copy = frame_arena_alloc(arena, length);
+	memcpy(copy, text, length);
+	return copy;
+}
+
+/**
+ * Concatenates a `NULL`-terminated list of strings into the arena. This is the arena equivalent of `g_strconcat`.
+ * @param arena Pointer to the arena.
+ * @param first First string in the list.
+ * @return The concatenated string, valid until the next frame_arena_reset().
+ */
+gchar *frame_arena_strconcat(Frame_arena *arena, const gchar *first, ...) {
+	va_list args;
+	gsize length = 1;
+	const gchar *current;
+
+	va_start(args, first);
+	for (current = first; current != NULL; current = va_arg(args, const gchar *)) {
+		length += strlen(current);
+	}
+	va_end(args);
+
+	gchar *result = frame_arena_alloc(arena, length);
+	gchar *end = result;
+
+	va_start(args, first);
+	for (current = first; current != NULL; current = va_arg(args, const gchar *)) {
+		gsize current_length = strlen(current);
+		memcpy(end, current, current_length);
+		end += current_length;
+	}
+	va_end(args);
+	*end = '\0';
+
+	return result;
+}
+
+/**
+ * Formats a string into the arena. This is the arena equivalent of `g_strdup_printf`.
+ * @param arena Pointer to the arena.
+ * @param format A `printf`-style format string.
+ * @return The formatted string, valid until the next frame_arena_reset().
+ */
+gchar *frame_arena_printf(Frame_arena *arena, const gchar *format, ...) {
+	va_list args;
+	va_list args_copy;
+
+	va_start(args, format);
+	va_copy(args_copy, args);
+	gint length = g_vsnprintf(NULL, 0, format, args_copy);
+	va_end(args_copy);
+
+	gchar *result = frame_arena_alloc(arena, length + 1);
+	g_vsnprintf(result, length + 1, format, args);
+	va_end(args);
+
+	return result;
+}
+
+/**
+ * Releases everything handed out since the previous reset. Call this at the end of each preview frame and printed page.
+ * If the frame overflowed the block, the overflow memory is freed and the block is replaced by one large enough for the
+ * whole frame, so the following frames run without going to the heap.
+ *
+ * The number of heap allocations made during the frame is written with `g_debug`, so running the application with
+ * `G_MESSAGES_DEBUG=all` shows whether steady-state redraws allocate.
+ * @param arena Pointer to the arena.
+ */
+void frame_arena_reset(Frame_arena *arena) {
+	if (arena->used > arena->high_water) {
+		arena->high_water = arena->used;
+	}
+
+	if (arena->overflow != NULL) {
+		g_slist_free_full(arena->overflow, g_free);
+		arena->overflow = NULL;
+
+		while (arena->capacity < arena->high_water) {
+			arena->capacity *= 2;
+		}
+		g_free(arena->block);
+		arena->block = g_malloc(arena->capacity);
+		arena->heap_allocations++;
+	}
+
+	guint frame_allocations = arena->heap_allocations - arena->heap_allocations_at_reset;
+	if (frame_allocations > 0) {
+		g_debug("Frame arena: %u heap allocations this frame, capacity now %" G_GSIZE_FORMAT " bytes", frame_allocations, arena->capacity);
+	}
+	arena->heap_allocations_at_reset = arena->heap_allocations;
+	arena->used = 0;
+}
+
+/**
+ * Frees the arena and all memory it holds. Called from free_memory().
+ * @param arena Pointer to the arena.
+ */
+void frame_arena_free(Frame_arena *arena) {
+	g_slist_free_full(arena->overflow, g_free);
+	g_free(arena->block);
+	g_free(arena);
+}
@@ -0,0 +1,175 @@
+#include <gtk/gtk.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file frame_stats.c
+ * @brief Measures how long the preview takes to draw, and shows the numbers over the preview.
+ *
+ * Every call of draw_preview() is timed and kept in a ring of the last \ref FRAME_STATS_SAMPLES durations, along with the time
+ * the render thread took to rasterize the image being painted. The overlay, shown with F12 or by starting the application with
+ * \ref FRAME_STATS_ENVIRONMENT set, draws the ring as a bar chart with its 50th, 95th, and 99th percentiles, the number of redraws
+ * in the last second, and how many redraws followed an edited amount, a change made by the application, such as switching
+ * accounts or sides, and an invalidation from GTK itself.
+ */
+
+/** Height of the bar chart in the overlay, in pixels. */
+#define OVERLAY_CHART_HEIGHT 40
+
+/** Duration shown at the top of the bar chart, in microseconds. Longer draws are clipped. */
+#define OVERLAY_CHART_MAXIMUM_USEC 16667
+
+/**
+ * Creates the statistics. The overlay starts hidden unless \ref FRAME_STATS_ENVIRONMENT is set.
+ * @return Pointer to the statistics. Free with `g_free()`.
+ */
+Frame_stats *frame_stats_new(void) {
+	Frame_stats *stats = g_new0(Frame_stats, 1);
+	stats->visible = (g_getenv(FRAME_STATS_ENVIRONMENT) != NULL);
+	return stats;
+}
+
+/**
+ * Notes what is about to ask for a redraw, so the next redraw is counted under it. If several sources are noted before the
+ * redraw, it is counted under the most specific: an edit, then the application, then GTK.
+ * @param stats Pointer to the statistics.
+ * @param source What changed the slip.
+ */
+void frame_stats_note_source(Frame_stats *stats, Redraw_source source) {
+	stats->pending_source = MAX(stats->pending_source, source);
+}
+
+/**
+ * Records how long the render thread took to rasterize the image now on screen.
+ * @param stats Pointer to the statistics.
+ * @param usec Duration in microseconds.
+ */
+void frame_stats_record_render(Frame_stats *stats, gint64 usec) {
+	stats->last_render_usec = usec;
+}
+
+/**
+ * Records one call of draw_preview().
+ * @param stats Pointer to the statistics.
+ * @param start When the call started, from `g_get_monotonic_time()`.
+ * @param usec How long the call took, in microseconds.
+ */
+void frame_stats_record_draw(Frame_stats *stats, gint64 start, gint64 usec) {
+	stats->durations[stats->next] = usec;
+	stats->starts[stats->next] = start;
+	stats->next = (stats->next + 1) % FRAME_STATS_SAMPLES;
+	if (stats->n_samples < FRAME_STATS_SAMPLES) {
+		stats->n_samples++;
+	}
+
+	stats->redraws[stats->pending_source]++;
+	stats->pending_source = REDRAW_SOURCE_GTK;
+}
+
+/**
+ * Compares two durations for `qsort()`.
+ * @param a Pointer to the first duration.
+ * @param b Pointer to the second duration.
+ * @return Negative, zero, or positive as the first is shorter than, equal to, or longer than the second.
+ */
+static gint compare_durations(const void *a, const void *b) {
+	gint64 first = *(const gint64 *)a;
+	gint64 second = *(const gint64 *)b;
+	return (first > second) - (first < second);
+}
+
+/**
+ * Returns a percentile of sorted durations.
+ * @param sorted Durations, shortest first.
+ * @param n Number of durations, at least one.
+ * @param percent Percentile to return.
+ * @return The duration in milliseconds.
+ */
+static gdouble percentile_ms(const gint64 *sorted, guint n, guint percent) {
+	guint index = (n * percent + 99) / 100;
+	return sorted[index > 0 ? index - 1 : 0] / 1000.0;
+}
+
+/**
+ * Draws the overlay in the top left corner of the preview, if it is shown.
+ * @param stats Pointer to the statistics.
+ * @param cr Cairo context of the preview area.
+ */
+void frame_stats_paint(Frame_stats *stats, cairo_t *cr) {
+	if (!stats->visible || stats->n_samples == 0) {
+		return;
+	}
+
+	gint64 sorted[FRAME_STATS_SAMPLES];
+	memcpy(sorted, stats->durations, stats->n_samples * sizeof(gint64));
+	qsort(sorted, stats->n_samples, sizeof(gint64), compare_durations);
+
+	/* Redraws that started within the last second. */
+	gint64 now = g_get_monotonic_time();
+	guint per_second = 0;
+	for (guint i = 0; i < stats->n_samples; i++) {
+		if (now - stats->starts[i] <= G_USEC_PER_SEC) {
+			per_second++;
+		}
+	}
+
+	gchar lines[4][64];
+	g_snprintf(lines[0], sizeof(lines[0]), "draw p50 %.2f  p95 %.2f  p99 %.2f ms",
+			   percentile_ms(sorted, stats->n_samples, 50),
+			   percentile_ms(sorted, stats->n_samples, 95),
+			   percentile_ms(sorted, stats->n_samples, 99));
+	g_snprintf(lines[1], sizeof(lines[1]), "render %.2f ms", stats->last_render_usec / 1000.0);
+	g_snprintf(lines[2], sizeof(lines[2]), "%u redraws/s", per_second);
+	g_snprintf(lines[3], sizeof(lines[3]), "edits %u  app %u  gtk %u", stats->redraws[REDRAW_SOURCE_EDIT],
+			   stats->redraws[REDRAW_SOURCE_APP], stats->redraws[REDRAW_SOURCE_GTK]);
+
+	gdouble line_height = 12;
+	gdouble width = FRAME_STATS_SAMPLES * 2 + 8;
+	gdouble height = OVERLAY_CHART_HEIGHT + 4 * line_height + 12;
+
+	cairo_save(cr);
+	cairo_set_source_rgba(cr, 0, 0, 0, 0.7);
+	cairo_rectangle(cr, 0, 0, width, height);
+	cairo_fill(cr);
+
+	/* One bar per draw, oldest on the left. */
+	cairo_set_source_rgb(cr, 0.3, 0.9, 0.3);
+	guint oldest = (stats->n_samples < FRAME_STATS_SAMPLES) ? 0 : stats->next;
+	for (guint i = 0; i < stats->n_samples; i++) {
+		gint64 usec = MIN(stats->durations[(oldest + i) % FRAME_STATS_SAMPLES], OVERLAY_CHART_MAXIMUM_USEC);
+		gdouble bar = (gdouble)usec * OVERLAY_CHART_HEIGHT / OVERLAY_CHART_MAXIMUM_USEC;
+		cairo_rectangle(cr, 4 + i * 2, 4 + OVERLAY_CHART_HEIGHT - bar, 1, bar);
+	}
+	cairo_fill(cr);
+
+	cairo_set_source_rgb(cr, 1, 1, 1);
+	cairo_select_font_face(cr, "monospace", CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+	cairo_set_font_size(cr, 10);
+	for (gint i = 0; i < 4; i++) {
+		cairo_move_to(cr, 4, OVERLAY_CHART_HEIGHT + 4 + (i + 1) * line_height);
+		cairo_show_text(cr, lines[i]);
+	}
+	cairo_restore(cr);
+}
+
+/**
+ * Callback fired when a key is pressed in the application window. F12 shows or hides the overlay.
+ * @param widget The application window.
+ * @param event The key event.
+ * @param data Pointer to user data.
+ * @return `TRUE` if the key was F12, so no other handler sees it.
+ */
+gboolean frame_stats_key_pressed(GtkWidget *widget, GdkEventKey *event, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+
+	if (event->keyval != GDK_KEY_F12 || data_passer->frame_stats == NULL) {
+		return FALSE;
+	}
+	data_passer->frame_stats->visible = !data_passer->frame_stats->visible;
+	frame_stats_note_source(data_passer->frame_stats, REDRAW_SOURCE_APP);
+	gtk_widget_queue_draw(data_passer->drawing_area);
+	return TRUE;
+}
@@ -0,0 +1,560 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file history_store.c
+ * @brief Keeps a record of every printed deposit in append-only files.
+ *
+ * Records are appended to numbered segment files of at most \ref HISTORY_SEGMENT_RECORDS fixed-size \ref History_record. When a
+ * segment fills up it is sealed: two index files are written next to it, one sorted by account number and date, the other by
+ * total amount, and a new segment is started. Queries map each sealed segment's index, binary-search it for the start of the
+ * range, and read only the matching records from the mapped segment. The records of the segment being appended to are also
+ * kept in memory and scanned directly. The Reprint button of the Slip tab looks up an account's last printed deposit here; see
+ * reprint_last_deposit().
+ */
+
+/** Number of records in a full segment. */
+#define HISTORY_SEGMENT_RECORDS 65536
+
+/** Extension of segment files. */
+#define HISTORY_RECORDS_EXTENSION ".records"
+
+/** Extension of the index of a segment by account number and date. */
+#define HISTORY_BY_ACCOUNT_EXTENSION ".by_account"
+
+/** Extension of the index of a segment by total amount. */
+#define HISTORY_BY_AMOUNT_EXTENSION ".by_amount"
+
+/**
+ * Entry of the index by account number and date.
+ */
+typedef struct History_account_key {
+	gchar account_number[32]; /**< Account number, padded with zeros. */
+	guint32 date; /**< Date, as `yyyymmdd`. */
+	guint32 record; /**< Index of the record in its segment. */
+} History_account_key;
+
+/**
+ * Entry of the index by total amount.
+ */
+typedef struct History_amount_key {
+	gint64 total_cents; /**< Total of the deposit in cents. */
+	guint32 record; /**< Index of the record in its segment. */
+	guint32 padding; /**< Keeps entries a multiple of eight bytes. */
+} History_amount_key;
+
+/**
+ * Sealed segment, mapped when first queried.
+ */
+typedef struct History_segment {
+	guint number; /**< Number in the segment's file names. */
+	GMappedFile *records; /**< Mapped records, or `NULL` until the segment is first queried. */
+	GMappedFile *by_account; /**< Mapped index by account number and date. */
+	GMappedFile *by_amount; /**< Mapped index by total amount. */
+} History_segment;
+
+/**
+ * Returns the path of one of a segment's files.
+ * @param store Pointer to the store.
+ * @param number Number of the segment.
+ * @param extension One of \ref HISTORY_RECORDS_EXTENSION, \ref HISTORY_BY_ACCOUNT_EXTENSION, or \ref HISTORY_BY_AMOUNT_EXTENSION.
+ * @return The path. Free with `g_free()`.
+ */
+static gchar *segment_path(const History_store *store, guint number, const gchar *extension) {
+	gchar *name = g_strdup_printf("%06u%s", number, extension);
+	gchar *path = g_build_filename(store->directory, name, NULL);
+	g_free(name);
+	return path;
+}
+
+/**
+ * Compares two entries of the index by account number and date, for `qsort`.
+ * @param a Pointer to the first entry.
+ * @param b Pointer to the second entry.
+ * @return Negative, zero, or positive as the first entry sorts before, with, or after the second.
+ */
+static gint compare_account_keys(const void *a, const void *b) {
+	const History_account_key *first = a;
+	const History_account_key *second = b;
+	gint order = strcmp(first->account_number, second->account_number);
+	if (order != 0) {
+		return order;
+	}
+	return (first->date > second->date) - (first->date < second->date);
+}
+
+/**
+ * Compares two entries of the index by total amount, for `qsort`.
+ * @param a Pointer to the first entry.
+ * @param b Pointer to the second entry.
+ * @return Negative, zero, or positive as the first total is less than, equal to, or greater than the second.
+ */
+static gint compare_amount_keys(const void *a, const void *b) {
+	gint64 first = ((const History_amount_key *)a)->total_cents;
+	gint64 second = ((const History_amount_key *)b)->total_cents;
+	return (first > second) - (first < second);
+}
+
+/**
+ * Compares two records by date, for sorting query results.
+ * @param a Pointer to the first record.
+ * @param b Pointer to the second record.
+ * @return Negative, zero, or positive as the first record is older than, as old as, or newer than the second.
+ */
+static gint compare_record_dates(gconstpointer a, gconstpointer b) {
+	guint32 first = ((const History_record *)a)->date;
+	guint32 second = ((const History_record *)b)->date;
+	return (first > second) - (first < second);
+}
+
+/**
+ * Writes both indexes of a full segment.
+ * @param store Pointer to the store.
+ * @param number Number of the segment.
+ * @param records The segment's records.
+ * @param n_records Number of records.
+ * @return `TRUE` if both indexes were written.
+ */
+static gboolean write_indexes(const History_store *store, guint number, const History_record *records, gsize n_records) {
+	History_account_key *by_account = g_new0(History_account_key, n_records);
+	History_amount_key *by_amount = g_new0(History_amount_key, n_records);
+
+	for (gsize i = 0; i < n_records; i++) {
+		memcpy(by_account[i].account_number, records[i].account_number, sizeof(by_account[i].account_number));
+		by_account[i].account_number[sizeof(by_account[i].account_number) - 1] = '\0';
+		by_account[i].date = records[i].date;
+		by_account[i].record = i;
+		by_amount[i].total_cents = records[i].total_cents;
+		by_amount[i].record = i;
+	}
+	qsort(by_account, n_records, sizeof(History_account_key), compare_account_keys);
+	qsort(by_amount, n_records, sizeof(History_amount_key), compare_amount_keys);
+
+	GError *error = NULL;
+	gchar *account_path = segment_path(store, number, HISTORY_BY_ACCOUNT_EXTENSION);
+	gchar *amount_path = segment_path(store, number, HISTORY_BY_AMOUNT_EXTENSION);
+	gboolean written = g_file_set_contents(account_path, (const gchar *)by_account, n_records * sizeof(History_account_key), &error) &&
+					   g_file_set_contents(amount_path, (const gchar *)by_amount, n_records * sizeof(History_amount_key), &error);
+	if (!written) {
+		g_print("Unable to index history segment %u: %s\n", number, error->message);
+		g_error_free(error);
+	}
+
+	g_free(account_path);
+	g_free(amount_path);
+	g_free(by_account);
+	g_free(by_amount);
+	return written;
+}
+
+/**
+ * Writes both indexes of a sealed segment from its records file.
+ * @param store Pointer to the store.
+ * @param number Number of the segment.
+ */
+static void index_segment(const History_store *store, guint number) {
+	gchar *records_path = segment_path(store, number, HISTORY_RECORDS_EXTENSION);
+	gchar *contents;
+	gsize length;
+	if (g_file_get_contents(records_path, &contents, &length, NULL)) {
+		write_indexes(store, number, (const History_record *)contents, length / sizeof(History_record));
+		g_free(contents);
+	}
+	g_free(records_path);
+}
+
+/**
+ * Seals a full segment that has no indexes yet, such as one filled just before the application stopped.
+ * @param store Pointer to the store.
+ * @param number Number of the segment.
+ */
+static void index_segment_if_needed(const History_store *store, guint number) {
+	gchar *account_path = segment_path(store, number, HISTORY_BY_ACCOUNT_EXTENSION);
+	gchar *amount_path = segment_path(store, number, HISTORY_BY_AMOUNT_EXTENSION);
+	gboolean indexed = g_file_test(account_path, G_FILE_TEST_EXISTS) && g_file_test(amount_path, G_FILE_TEST_EXISTS);
+	g_free(account_path);
+	g_free(amount_path);
+	if (!indexed) {
+		index_segment(store, number);
+	}
+}
+
+/**
+ * Opens the active segment for appending, loading its records. A partial record left by an interrupted write is dropped.
+ * @param store Pointer to the store.
+ * @return `TRUE` if the segment is open.
+ */
+static gboolean open_active_segment(History_store *store) {
+	gchar *path = segment_path(store, store->active_number, HISTORY_RECORDS_EXTENSION);
+	gchar *contents = NULL;
+	gsize length = 0;
+
+	g_array_set_size(store->active, 0);
+	if (g_file_get_contents(path, &contents, &length, NULL)) {
+		gsize n_records = length / sizeof(History_record);
+		g_array_append_vals(store->active, contents, n_records);
+		if (n_records * sizeof(History_record) != length) {
+			g_file_set_contents(path, contents, n_records * sizeof(History_record), NULL);
+		}
+		g_free(contents);
+	}
+
+	store->active_file = g_fopen(path, "ab");
+	if (store->active_file == NULL) {
+		g_print("Unable to open `%s' for appending\n", path);
+	}
+	g_free(path);
+	return store->active_file != NULL;
+}
+
+/**
+ * Frees a sealed segment, used as the free function of \ref History_store.segments.
+ * @param data Pointer to the segment.
+ */
+static void segment_free(gpointer data) {
+	History_segment *segment = (History_segment *)data;
+	if (segment->records != NULL) {
+		g_mapped_file_unref(segment->records);
+		g_mapped_file_unref(segment->by_account);
+		g_mapped_file_unref(segment->by_amount);
+	}
+	g_free(segment);
+}
+
+/**
+ * Compares two segment numbers, for sorting.
+ * @param a Pointer to the first number.
+ * @param b Pointer to the second number.
+ * @return Negative, zero, or positive as the first number is less than, equal to, or greater than the second.
+ */
+static gint compare_numbers(gconstpointer a, gconstpointer b) {
+	guint first = *(const guint *)a;
+	guint second = *(const guint *)b;
+	return (first > second) - (first < second);
+}
+
+/**
+ * Seals the active segment and starts the next one.
+ * @param store Pointer to the store.
+ */
+static void seal_active_segment(History_store *store) {
+	fclose(store->active_file);
+	store->active_file = NULL;
+	write_indexes(store, store->active_number, (const History_record *)store->active->data, store->active->len);
+
+	History_segment *segment = g_new0(History_segment, 1);
+	segment->number = store->active_number;
+	g_ptr_array_add(store->segments, segment);
+
+	store->active_number++;
+	open_active_segment(store);
+}
+
+/**
+ * Opens the history store, creating its directory if needed. Full segments without indexes are indexed here.
+ * @param directory Directory holding the segments.
+ * @return Pointer to the store. Close with history_store_close().
+ */
+History_store *history_store_open(const gchar *directory) {
+	History_store *store = g_new0(History_store, 1);
+	store->directory = g_strdup(directory);
+	store->segments = g_ptr_array_new_with_free_func(segment_free);
+	store->active = g_array_new(FALSE, FALSE, sizeof(History_record));
+
+	g_mkdir_with_parents(directory, 0700);
+	GArray *numbers = g_array_new(FALSE, FALSE, sizeof(guint));
+	GDir *dir = g_dir_open(directory, 0, NULL);
+	if (dir != NULL) {
+		const gchar *name;
+		while ((name = g_dir_read_name(dir)) != NULL) {
+			if (g_str_has_suffix(name, HISTORY_RECORDS_EXTENSION)) {
+				guint number = (guint)g_ascii_strtoull(name, NULL, 10);
+				g_array_append_val(numbers, number);
+			}
+		}
+		g_dir_close(dir);
+	}
+	g_array_sort(numbers, compare_numbers);
+
+	/* Every segment but the last is full. */
+	for (guint i = 0; i + 1 < numbers->len; i++) {
+		History_segment *segment = g_new0(History_segment, 1);
+		segment->number = g_array_index(numbers, guint, i);
+		index_segment_if_needed(store, segment->number);
+		g_ptr_array_add(store->segments, segment);
+	}
+	store->active_number = numbers->len > 0 ? g_array_index(numbers, guint, numbers->len - 1) : 1;
+	g_array_unref(numbers);
+
+	/* A segment filled just before the application stopped is sealed now. */
+	if (open_active_segment(store) && store->active->len >= HISTORY_SEGMENT_RECORDS) {
+		seal_active_segment(store);
+	}
+	return store;
+}
+
+/**
+ * Appends a record to the store. The record is flushed to disk before returning.
+ * @param store Pointer to the store.
+ * @param record The record.
+ * @return `TRUE` if the record was written.
+ */
+gboolean history_store_append(History_store *store, const History_record *record) {
+	if (store->active_file == NULL) {
+		return FALSE;
+	}
+	if (fwrite(record, sizeof(History_record), 1, store->active_file) != 1 || fflush(store->active_file) != 0) {
+		g_print("Unable to append to the deposit history\n");
+		return FALSE;
+	}
+	g_array_append_val(store->active, *record);
+
+	if (store->active->len >= HISTORY_SEGMENT_RECORDS) {
+		seal_active_segment(store);
+	}
+	return TRUE;
+}
+
+/**
+ * Determines whether a segment's indexes can be trusted: each holds one entry per record, every entry refers to a record in the
+ * segment, and every account number is terminated. Queries read records through the entries without further checks, so an index
+ * damaged on disk or left from a different records file must not be used.
+ * @param records Mapped records.
+ * @param by_account Mapped index by account number and date.
+ * @param by_amount Mapped index by total amount.
+ * @return `TRUE` if the indexes match the records.
+ */
+static gboolean indexes_match_records(GMappedFile *records, GMappedFile *by_account, GMappedFile *by_amount) {
+	gsize n_records = g_mapped_file_get_length(records) / sizeof(History_record);
+	const History_account_key *account_keys = (const History_account_key *)g_mapped_file_get_contents(by_account);
+	const History_amount_key *amount_keys = (const History_amount_key *)g_mapped_file_get_contents(by_amount);
+
+	if (g_mapped_file_get_length(by_account) != n_records * sizeof(History_account_key) ||
+		g_mapped_file_get_length(by_amount) != n_records * sizeof(History_amount_key)) {
+		return FALSE;
+	}
+	for (gsize k = 0; k < n_records; k++) {
+		if (account_keys[k].record >= n_records || amount_keys[k].record >= n_records ||
+			account_keys[k].account_number[sizeof(account_keys[k].account_number) - 1] != '\0') {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**
+ * Maps a sealed segment and its indexes, the first time it is queried. Indexes that do not match the records are written
+ * again from the records.
+ * @param store Pointer to the store.
+ * @param segment Pointer to the segment.
+ * @return `TRUE` if the segment is mapped.
+ */
+static gboolean map_segment(const History_store *store, History_segment *segment) {
+	if (segment->records != NULL) {
+		return TRUE;
+	}
+
+	gchar *records_path = segment_path(store, segment->number, HISTORY_RECORDS_EXTENSION);
+	gchar *account_path = segment_path(store, segment->number, HISTORY_BY_ACCOUNT_EXTENSION);
+	gchar *amount_path = segment_path(store, segment->number, HISTORY_BY_AMOUNT_EXTENSION);
+	gboolean mapped = FALSE;
+
+	for (gint attempt = 0; attempt < 2 && !mapped; attempt++) {
+		if (attempt > 0) {
+			g_print("History segment %u has a damaged index; indexing it again\n", segment->number);
+			index_segment(store, segment->number);
+		}
+
+		GMappedFile *records = g_mapped_file_new(records_path, FALSE, NULL);
+		GMappedFile *by_account = g_mapped_file_new(account_path, FALSE, NULL);
+		GMappedFile *by_amount = g_mapped_file_new(amount_path, FALSE, NULL);
+		if (records == NULL) {
+			break; /* Nothing to index from. */
+		}
+		if (by_account != NULL && by_amount != NULL && indexes_match_records(records, by_account, by_amount)) {
+			segment->records = records;
+			segment->by_account = by_account;
+			segment->by_amount = by_amount;
+			mapped = TRUE;
+			continue;
+		}
+
+		g_mapped_file_unref(records);
+		if (by_account != NULL) {
+			g_mapped_file_unref(by_account);
+		}
+		if (by_amount != NULL) {
+			g_mapped_file_unref(by_amount);
+		}
+	}
+
+	if (!mapped) {
+		g_print("Unable to map history segment %u\n", segment->number);
+	}
+	g_free(records_path);
+	g_free(account_path);
+	g_free(amount_path);
+	return mapped;
+}
+
+/**
+ * Finds the deposits of an account between two dates.
+ * @param store Pointer to the store.
+ * @param account_number Account number.
+ * @param first_date Earliest date, as `yyyymmdd`.
+ * @param last_date Latest date, as `yyyymmdd`.
+ * @return Array of \ref History_record from oldest to newest. Free with `g_array_unref()`.
+ */
+GArray *history_store_find_account(History_store *store, const gchar *account_number, guint32 first_date, guint32 last_date) {
+	GArray *found = g_array_new(FALSE, FALSE, sizeof(History_record));
+	History_account_key first = {{0}};
+	g_strlcpy(first.account_number, account_number, sizeof(first.account_number));
+	first.date = first_date;
+
+	for (guint i = 0; i < store->segments->len; i++) {
+		History_segment *segment = g_ptr_array_index(store->segments, i);
+		if (!map_segment(store, segment)) {
+			continue;
+		}
+		const History_record *records = (const History_record *)g_mapped_file_get_contents(segment->records);
+		const History_account_key *keys = (const History_account_key *)g_mapped_file_get_contents(segment->by_account);
+		gsize n_keys = g_mapped_file_get_length(segment->by_account) / sizeof(History_account_key);
+
+		/* Lower bound of (account, first_date), then read forward while still in range. */
+		gsize low = 0;
+		gsize high = n_keys;
+		while (low < high) {
+			gsize middle = low + (high - low) / 2;
+			if (compare_account_keys(&keys[middle], &first) < 0) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		for (gsize k = low; k < n_keys && keys[k].date <= last_date && strcmp(keys[k].account_number, first.account_number) == 0; k++) {
+			g_array_append_val(found, records[keys[k].record]);
+		}
+	}
+
+	for (guint i = 0; i < store->active->len; i++) {
+		const History_record *record = &g_array_index(store->active, History_record, i);
+		if (record->date >= first_date && record->date <= last_date && strcmp(record->account_number, first.account_number) == 0) {
+			g_array_append_val(found, *record);
+		}
+	}
+
+	g_array_sort(found, compare_record_dates);
+	return found;
+}
+
+/**
+ * Finds the deposits whose total is within a range.
+ * @param store Pointer to the store.
+ * @param minimum_cents Smallest total in cents.
+ * @param maximum_cents Largest total in cents.
+ * @return Array of \ref History_record from oldest to newest. Free with `g_array_unref()`.
+ */
+GArray *history_store_find_amount(History_store *store, gint64 minimum_cents, gint64 maximum_cents) {
+	GArray *found = g_array_new(FALSE, FALSE, sizeof(History_record));
+
+	for (guint i = 0; i < store->segments->len; i++) {
+		History_segment *segment = g_ptr_array_index(store->segments, i);
+		if (!map_segment(store, segment)) {
+			continue;
+		}
+		const History_record *records = (const History_record *)g_mapped_file_get_contents(segment->records);
+		const History_amount_key *keys = (const History_amount_key *)g_mapped_file_get_contents(segment->by_amount);
+		gsize n_keys = g_mapped_file_get_length(segment->by_amount) / sizeof(History_amount_key);
+
+		gsize low = 0;
+		gsize high = n_keys;
+		while (low < high) {
+			gsize middle = low + (high - low) / 2;
+			if (keys[middle].total_cents < minimum_cents) {
+				low = middle + 1;
+			} else {
+				high = middle;
+			}
+		}
+		for (gsize k = low; k < n_keys && keys[k].total_cents <= maximum_cents; k++) {
+			g_array_append_val(found, records[keys[k].record]);
+		}
+	}
+
+	for (guint i = 0; i < store->active->len; i++) {
+		const History_record *record = &g_array_index(store->active, History_record, i);
+		if (record->total_cents >= minimum_cents && record->total_cents <= maximum_cents) {
+			g_array_append_val(found, *record);
+		}
+	}
+
+	g_array_sort(found, compare_record_dates);
+	return found;
+}
+
+/**
+ * Fills in a history record from a deposit, dated today.
+ * @param deposit Pointer to the deposit.
+ * @param account_number Account number of the deposit.
+ * @param record Receives the record.
+ * @return `TRUE` if the record was filled in, `FALSE` if the account number is too long or the deposit has too many checks.
+ */
+gboolean history_record_from_deposit(const Deposit *deposit, const gchar *account_number, History_record *record) {
+	GtkTreeModel *model = GTK_TREE_MODEL(deposit->checks_store);
+	gint n_checks = gtk_tree_model_iter_n_children(model, NULL);
+
+	memset(record, 0, sizeof(History_record));
+	if (strlen(account_number) >= sizeof(record->account_number) || n_checks > MAXIMUM_CHECKS) {
+		return FALSE;
+	}
+
+	GDateTime *now = g_date_time_new_now_local();
+	record->date = g_date_time_get_year(now) * 10000 + g_date_time_get_month(now) * 100 + g_date_time_get_day_of_month(now);
+	g_date_time_unref(now);
+	g_strlcpy(record->account_number, account_number, sizeof(record->account_number));
+	record->n_checks = n_checks;
+	record->total_cents = deposit->totals->total;
+
+	GtkTreeIter iter;
+	gboolean valid = gtk_tree_model_get_iter_first(model, &iter);
+	for (gint i = 0; valid; i++) {
+		gtk_tree_model_get(model, &iter, CHECK_CENTS, &record->cents[i], -1);
+		valid = gtk_tree_model_iter_next(model, &iter);
+	}
+	return TRUE;
+}
+
+/**
+ * Records a printed deposit in the history. Deposits without an account are not recorded.
+ * @param data_passer Pointer to user data.
+ * @param deposit Pointer to the printed deposit.
+ */
+void history_record_deposit(Data_passer *data_passer, const Deposit *deposit) {
+	gchar *account_number = deposit_account_number(data_passer, deposit);
+	History_record record;
+
+	if (data_passer->history != NULL && account_number != NULL && history_record_from_deposit(deposit, account_number, &record)) {
+		history_store_append(data_passer->history, &record);
+	}
+	g_free(account_number);
+}
+
+/**
+ * Closes the store. Called from free_memory().
+ * @param store Pointer to the store.
+ */
+void history_store_close(History_store *store) {
+	if (store->active_file != NULL) {
+		fclose(store->active_file);
+	}
+	g_array_unref(store->active);
+	g_ptr_array_unref(store->segments);
+	g_free(store->directory);
+	g_free(store);
+}
@@ -0,0 +1,234 @@
+#include <gtk/gtk.h>
+
+#include <headers.h>
+
+/**
+ * @file job_queue.c
+ * @brief Bounded queue for handing jobs between the UI thread and worker threads.
+ *
+ * The queue is a ring of cells, each stamped with a sequence number that tells producers and consumers whether the cell is free
+ * or full, so any number of threads can push and pop without a lock. A full queue refuses the push, and the producer decides
+ * whether to wait, drop, or keep the job for later. Consumers that would rather sleep than spin on an empty queue park on a
+ * condition variable, which producers only signal when somebody is parked.
+ *
+ * Jobs coming back to the UI thread go through a \ref Job_queue_source. Producers wake the main loop once per batch: the first
+ * push after a dispatch wakes it, and the pushes that follow before the dispatch runs add to the same batch.
+ */
+
+/**
+ * Creates an empty queue.
+ * @param capacity Number of jobs the queue can hold. Rounded up to a power of two.
+ * @return Pointer to the queue. Free with job_queue_free().
+ */
+Job_queue *job_queue_new(guint capacity) {
+	Job_queue *queue = g_new0(Job_queue, 1);
+	guint size = 2;
+	while (size < capacity) {
+		size *= 2;
+	}
+	queue->cells = g_new(Job_queue_cell, size);
+	queue->mask = size - 1;
+	for (guint i = 0; i < size; i++) {
+		queue->cells[i].sequence = (gint)i;
+		queue->cells[i].job = NULL;
+	}
+	g_mutex_init(&queue->park_mutex);
+	g_cond_init(&queue->park_cond);
+	return queue;
+}
+
+/**
+ * Frees a queue. Jobs still in the queue are not freed; pop them first.
+ * @param queue Pointer to the queue.
+ */
+void job_queue_free(Job_queue *queue) {
+	g_cond_clear(&queue->park_cond);
+	g_mutex_clear(&queue->park_mutex);
+	g_free(queue->cells);
+	g_free(queue);
+}
+
+/**
+ * Adds a job to the queue, waking a parked consumer if there is one.
+ * @param queue Pointer to the queue.
+ * @param job The job, which must not be `NULL`.
+ * @return `TRUE` if the job was added, `FALSE` if the queue is full.
+ */
+gboolean job_queue_push(Job_queue *queue, gpointer job) {
+	guint position = (guint)g_atomic_int_get(&queue->tail);
+	Job_queue_cell *cell;
+
+	while (TRUE) {
+		cell = &queue->cells[position & queue->mask];
+		gint difference = (gint)((guint)g_atomic_int_get(&cell->sequence) - position);
+		if (difference == 0) {
+			/* The cell is free; claim it unless another producer got there first. */
+			if (g_atomic_int_compare_and_exchange(&queue->tail, (gint)position, (gint)(position + 1))) {
+				break;
+			}
+			position = (guint)g_atomic_int_get(&queue->tail);
+		} else if (difference < 0) {
+			return FALSE; /* The cell still holds the job from one lap ago. */
+		} else {
+			position = (guint)g_atomic_int_get(&queue->tail);
+		}
+	}
+
+	cell->job = job;
+	g_atomic_int_set(&cell->sequence, (gint)(position + 1));
+
+	if (g_atomic_int_get(&queue->parked) > 0) {
+		g_mutex_lock(&queue->park_mutex);
+		g_cond_signal(&queue->park_cond);
+		g_mutex_unlock(&queue->park_mutex);
+	}
+	return TRUE;
+}
+
+/**
+ * Removes the oldest job from the queue without waiting.
+ * @param queue Pointer to the queue.
+ * @return The job, or `NULL` if the queue is empty.
+ */
+gpointer job_queue_pop(Job_queue *queue) {
+	guint position = (guint)g_atomic_int_get(&queue->head);
+	Job_queue_cell *cell;
+
+	while (TRUE) {
+		cell = &queue->cells[position & queue->mask];
+		gint difference = (gint)((guint)g_atomic_int_get(&cell->sequence) - (position + 1));
+		if (difference == 0) {
+			if (g_atomic_int_compare_and_exchange(&queue->head, (gint)position, (gint)(position + 1))) {
+				break;
+			}
+			position = (guint)g_atomic_int_get(&queue->head);
+		} else if (difference < 0) {
+			return NULL; /* Nothing has been written to the cell yet. */
+		} else {
+			position = (guint)g_atomic_int_get(&queue->head);
+		}
+	}
+
+	gpointer job = cell->job;
+	/* Free the cell for the producer one lap ahead. */
+	g_atomic_int_set(&cell->sequence, (gint)(position + queue->mask + 1));
+	return job;
+}
+
+/**
+ * Removes the oldest job from the queue, sleeping while the queue is empty.
+ * @param queue Pointer to the queue.
+ * @return The job, or `NULL` once the queue is closed with job_queue_close().
+ */
+gpointer job_queue_pop_wait(Job_queue *queue) {
+	while (TRUE) {
+		gpointer job = job_queue_pop(queue);
+		if (job != NULL || g_atomic_int_get(&queue->closed)) {
+			return job;
+		}
+
+		g_mutex_lock(&queue->park_mutex);
+		g_atomic_int_inc(&queue->parked);
+		/* Look again after announcing ourselves, so a push made in between is not missed. */
+		job = job_queue_pop(queue);
+		if (job == NULL && !g_atomic_int_get(&queue->closed)) {
+			g_cond_wait(&queue->park_cond, &queue->park_mutex);
+		}
+		g_atomic_int_add(&queue->parked, -1);
+		g_mutex_unlock(&queue->park_mutex);
+		if (job != NULL) {
+			return job;
+		}
+	}
+}
+
+/**
+ * Closes a queue, waking every parked consumer. job_queue_pop_wait() returns `NULL` once the queue is closed and empty.
+ * @param queue Pointer to the queue.
+ */
+void job_queue_close(Job_queue *queue) {
+	g_mutex_lock(&queue->park_mutex);
+	g_atomic_int_set(&queue->closed, TRUE);
+	g_cond_broadcast(&queue->park_cond);
+	g_mutex_unlock(&queue->park_mutex);
+}
+
+/**
+ * Determines whether a queue holds any jobs. The answer may be out of date as soon as it is returned if other threads are pushing.
+ * @param queue Pointer to the queue.
+ * @return `TRUE` if the queue is empty.
+ */
+gboolean job_queue_is_empty(Job_queue *queue) {
+	guint position = (guint)g_atomic_int_get(&queue->head);
+	const Job_queue_cell *cell = &queue->cells[position & queue->mask];
+	return (guint)g_atomic_int_get(&cell->sequence) != position + 1;
+}
+
+/**
+ * Tells the main loop whether a \ref Job_queue_source is ready. The source has no timeout.
+ * @param source The source.
+ * @param timeout Receives -1.
+ * @return `TRUE` if the source's queue holds jobs.
+ */
+static gboolean source_prepare(GSource *source, gint *timeout) {
+	*timeout = -1;
+	return !job_queue_is_empty(((Job_queue_source *)source)->queue);
+}
+
+/**
+ * Tells the main loop whether a \ref Job_queue_source is ready after polling.
+ * @param source The source.
+ * @return `TRUE` if the source's queue holds jobs.
+ */
+static gboolean source_check(GSource *source) {
+	return !job_queue_is_empty(((Job_queue_source *)source)->queue);
+}
+
+/**
+ * Runs the source's callback, which drains the queue. Clears the wake-up flag first, so a push made while the callback runs
+ * wakes the loop again.
+ * @param source The source.
+ * @param callback Callback set with `g_source_set_callback()`.
+ * @param data Data of the callback.
+ * @return The callback's result.
+ */
+static gboolean source_dispatch(GSource *source, GSourceFunc callback, gpointer data) {
+	g_atomic_int_set(&((Job_queue_source *)source)->wake_pending, FALSE);
+	return callback != NULL ? callback(data) : G_SOURCE_REMOVE;
+}
+
+/** Functions of a \ref Job_queue_source. */
+static GSourceFuncs source_funcs = {source_prepare, source_check, source_dispatch, NULL, NULL, NULL};
+
+/**
+ * Creates a source that dispatches on the main loop while a queue holds jobs. The callback should pop every job in the
+ * queue and return `G_SOURCE_CONTINUE`.
+ * @param queue Queue that worker threads push finished jobs onto.
+ * @param callback Callback that drains the queue.
+ * @param data Data passed to the callback.
+ * @return The source, attached to the default main context. Destroy with `g_source_destroy()` and `g_source_unref()`.
+ */
+GSource *job_queue_source_new(Job_queue *queue, GSourceFunc callback, gpointer data) {
+	GSource *source = g_source_new(&source_funcs, sizeof(Job_queue_source));
+	((Job_queue_source *)source)->queue = queue;
+	g_source_set_callback(source, callback, data, NULL);
+	g_source_attach(source, NULL);
+	return source;
+}
+
+/**
+ * Pushes a finished job onto a source's queue and wakes the main loop, unless a wake-up for this batch is already on its way.
+ * @param source A source made with job_queue_source_new().
+ * @param job The job.
+ * @return `TRUE` if the job was added, `FALSE` if the queue is full.
+ */
+gboolean job_queue_source_push(GSource *source, gpointer job) {
+	Job_queue_source *queue_source = (Job_queue_source *)source;
+	if (!job_queue_push(queue_source->queue, job)) {
+		return FALSE;
+	}
+	if (g_atomic_int_compare_and_exchange(&queue_source->wake_pending, FALSE, TRUE)) {
+		g_main_context_wakeup(g_source_get_context(source));
+	}
+	return TRUE;
+}
@@ -0,0 +1,394 @@
+#include <gtk/gtk.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file preview_renderer.c
+ * @brief Rasterizes the slip's preview on a separate thread.
+ *
+ * Whenever the slip changes, the UI thread copies the display list of the side being shown and hands the copy to the render
+ * thread through a \ref Job_queue. The render thread replays the copy into whichever of two image surfaces is not on screen and
+ * hands the job back through a second queue, which wakes the main loop to publish the surface and redraw. The `draw` handler
+ * only paints the latest published surface, so typing an amount never waits for the slip to be rasterized.
+ *
+ * Only one job is in flight at a time, so the render thread never draws into the surface on screen. A snapshot taken while a
+ * job is in flight waits in \ref Preview_renderer.next, where a later snapshot replaces it, so a burst of edits renders once.
+ *
+ * Jobs are allocated when the renderer is created and handed back to \ref Preview_renderer.spare_jobs once drawn, and each
+ * keeps a snapshot of each side. Taking a snapshot copies the side over the spare job's earlier copy of the same side, so once
+ * every job has held both sides, an edit allocates nothing. Allocations that do happen are counted in
+ * \ref Preview_renderer.heap_allocations and written with `g_debug`, as the frame arena does.
+ *
+ * Once the side shown is up to date and the main loop is idle, the side not shown is rendered too, into a third surface. Switching
+ * sides then swaps that surface with the one on screen instead of rendering, and the side left behind stays ready for switching
+ * back. Any change to the slip discards the image of the side not shown, and it is rendered again at the next idle moment.
+ */
+
+/** Number of jobs each of the renderer's queues holds. One job is in flight at a time, so this is only headroom. */
+#define PREVIEW_QUEUE_CAPACITY 4
+
+/** Index in \ref Preview_renderer.buffers of the image of the side not shown. */
+#define PREVIEW_HIDDEN 2
+
+/**
+ * Replays a snapshot into a surface of the requested size, replacing the surface if its size is out of date.
+ * @param surface Pointer to the surface, which may be `NULL` the first time.
+ * @param job The job, holding the snapshot and the size to draw it at.
+ */
+static void render_snapshot(cairo_surface_t **surface, const Preview_job *job) {
+	gint pixel_width = job->width * job->scale_factor;
+	gint pixel_height = job->height * job->scale_factor;
+
+	if (*surface == NULL ||
+		cairo_image_surface_get_width(*surface) != pixel_width ||
+		cairo_image_surface_get_height(*surface) != pixel_height) {
+		if (*surface != NULL) {
+			cairo_surface_destroy(*surface);
+		}
+		*surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, pixel_width, pixel_height);
+		cairo_surface_set_device_scale(*surface, job->scale_factor, job->scale_factor);
+	}
+
+	cairo_t *cr = cairo_create(*surface);
+	cairo_set_source_rgb(cr, 1, 1, 1);
+	cairo_paint(cr);
+	gdouble scale = (gdouble)job->width / SLIP_WIDTH;
+	cairo_scale(cr, scale, scale);
+	slip_display_list_replay(job->snapshot, cr);
+	cairo_destroy(cr);
+	cairo_surface_flush(*surface);
+}
+
+/**
+ * Frees a job and its snapshot.
+ * @param job Pointer to the job.
+ */
+static void preview_job_free(Preview_job *job) {
+	slip_display_list_free(job->sides[0]);
+	slip_display_list_free(job->sides[1]);
+	g_free(job);
+}
+
+/**
+ * Allocates a job with an empty snapshot of each side.
+ * @return The job. Free with preview_job_free().
+ */
+static Preview_job *preview_job_alloc(void) {
+	Preview_job *job = g_new0(Preview_job, 1);
+	job->sides[0] = slip_display_list_new();
+	job->sides[1] = slip_display_list_new();
+	return job;
+}
+
+/**
+ * Hands a job that is done with back to the renderer's spare jobs, keeping its snapshot for the next job. Only the UI thread
+ * calls this.
+ * @param renderer Pointer to the renderer.
+ * @param job Pointer to the job.
+ */
+static void preview_job_release(Preview_renderer *renderer, Preview_job *job) {
+	if (renderer->n_spare_jobs < PREVIEW_JOBS) {
+		renderer->spare_jobs[renderer->n_spare_jobs++] = job;
+	} else {
+		preview_job_free(job);
+	}
+}
+
+/**
+ * Body of the render thread. Takes jobs until the request queue is closed, renders each into its target surface, and hands it
+ * back to the UI thread.
+ * @param data Pointer to the renderer.
+ * @return `NULL`.
+ */
+static gpointer render_thread(gpointer data) {
+	Preview_renderer *renderer = (Preview_renderer *)data;
+	Preview_job *job;
+
+	while ((job = job_queue_pop_wait(renderer->requests)) != NULL) {
+		gint64 start = g_get_monotonic_time();
+		render_snapshot(&renderer->buffers[job->target], job);
+		job->render_usec = g_get_monotonic_time() - start;
+		/* The UI thread drains the queue on every wake-up, so it is only full if the main loop is stalled. */
+		while (!job_queue_source_push(renderer->completion_source, job)) {
+			g_thread_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Sends a job to the render thread, drawing into the surface that is not on screen. The UI thread keeps the job if the request
+ * queue is full and sends it when the job in flight comes back.
+ * @param renderer Pointer to the renderer.
+ * @param job The job. The renderer takes it over.
+ */
+static void submit(Preview_renderer *renderer, Preview_job *job) {
+	if (renderer->in_flight) {
+		if (renderer->next != NULL) {
+			preview_job_release(renderer, renderer->next); /* Superseded before it was sent. */
+		}
+		renderer->next = job;
+		return;
+	}
+
+	if (!job->speculative) {
+		job->target = renderer->completed == 0 ? 1 : 0;
+	}
+	if (!job_queue_push(renderer->requests, job)) {
+		renderer->next = job;
+		return;
+	}
+	renderer->in_flight = TRUE;
+}
+
+/**
+ * Makes a job rendering one side of the slip at the size the preview was last drawn, from a spare job if there is one.
+ * @param renderer Pointer to the renderer.
+ * @param front `TRUE` for the front of the slip.
+ * @return The job. Hand it back with preview_job_release() once done with.
+ */
+static Preview_job *preview_job_new(Preview_renderer *renderer, gboolean front) {
+	Data_passer *data_passer = renderer->data_passer;
+	guint allocations = 0;
+	Preview_job *job;
+
+	if (renderer->n_spare_jobs > 0) {
+		job = renderer->spare_jobs[--renderer->n_spare_jobs];
+	} else {
+		job = preview_job_alloc();
+		allocations++;
+	}
+	job->snapshot = job->sides[front ? 1 : 0];
+	allocations += slip_display_list_copy_into(job->snapshot, front ? data_passer->slip_front : data_passer->slip_back);
+	if (allocations > 0) {
+		renderer->heap_allocations += allocations;
+		g_debug("Preview renderer: %u heap allocations for this snapshot, %u in all", allocations, renderer->heap_allocations);
+	}
+
+	job->width = renderer->width;
+	job->height = renderer->height;
+	job->scale_factor = renderer->scale_factor;
+	job->front = front;
+	job->speculative = FALSE;
+	job->target = 0;
+	job->generation = renderer->generation;
+	job->render_usec = 0;
+	return job;
+}
+
+/**
+ * Idle callback that renders the side of the slip not shown, if the back is in use, nothing else is being rendered or printed,
+ * and the image is not already up to date.
+ * @param data Pointer to the renderer.
+ * @return `G_SOURCE_REMOVE`; the next completed job schedules the callback again.
+ */
+static gboolean speculate(gpointer data) {
+	Preview_renderer *renderer = (Preview_renderer *)data;
+	Data_passer *data_passer = renderer->data_passer;
+
+	renderer->speculate_id = 0;
+	/* A print job holding the layout may be writing other deposits into the display lists. */
+	if (renderer->hidden_valid || renderer->in_flight || renderer->next != NULL || data_passer->layout_holds > 0 ||
+		number_of_checks(data_passer) <= 2) {
+		return G_SOURCE_REMOVE;
+	}
+
+	Preview_job *job = preview_job_new(renderer, !data_passer->front_slip_active);
+	job->speculative = TRUE;
+	job->target = PREVIEW_HIDDEN;
+	submit(renderer, job);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * Callback run on the UI thread when the render thread hands jobs back. Publishes the surface of the newest one, sends the job
+ * that waited while it was in flight, and redraws the preview. Once nothing is waiting, schedules rendering the side not shown.
+ * @param data Pointer to the renderer.
+ * @return `G_SOURCE_CONTINUE`, to keep the source for later jobs.
+ */
+static gboolean jobs_completed(gpointer data) {
+	Preview_renderer *renderer = (Preview_renderer *)data;
+	Preview_job *job;
+	gboolean shown_changed = FALSE;
+
+	while ((job = job_queue_pop(renderer->completions)) != NULL) {
+		renderer->in_flight = FALSE;
+		if (job->speculative) {
+			/* Keep the image unless the slip changed while it was rendered. */
+			if (job->generation == renderer->generation) {
+				renderer->hidden_valid = TRUE;
+				renderer->hidden_front = job->front;
+			}
+		} else {
+			renderer->completed = job->target;
+			frame_stats_record_render(renderer->frame_stats, job->render_usec);
+			shown_changed = TRUE;
+		}
+		preview_job_release(renderer, job);
+	}
+
+	if (renderer->next != NULL) {
+		Preview_job *next = renderer->next;
+		renderer->next = NULL;
+		submit(renderer, next);
+	} else if (!renderer->hidden_valid && renderer->speculate_id == 0) {
+		renderer->speculate_id = g_idle_add(speculate, renderer);
+	}
+	if (shown_changed) {
+		gtk_widget_queue_draw(renderer->drawing_area);
+	}
+	return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Creates the renderer and starts its thread. Nothing is rendered until the preview is first drawn.
+ * @param data_passer Pointer to user data, holding the preview area and the statistics receiving the time each image took to render.
+ * @return Pointer to the renderer. Free with preview_renderer_free().
+ */
+Preview_renderer *preview_renderer_new(Data_passer *data_passer) {
+	Preview_renderer *renderer = g_new0(Preview_renderer, 1);
+	renderer->data_passer = data_passer;
+	renderer->drawing_area = data_passer->drawing_area;
+	renderer->frame_stats = data_passer->frame_stats;
+	renderer->completed = -1;
+	renderer->requests = job_queue_new(PREVIEW_QUEUE_CAPACITY);
+	renderer->completions = job_queue_new(PREVIEW_QUEUE_CAPACITY);
+	renderer->completion_source = job_queue_source_new(renderer->completions, jobs_completed, renderer);
+	for (gint i = 0; i < PREVIEW_JOBS; i++) {
+		renderer->spare_jobs[renderer->n_spare_jobs++] = preview_job_alloc();
+	}
+	renderer->thread = g_thread_new("preview", render_thread, renderer);
+	return renderer;
+}
+
+/**
+ * Stops the render thread and frees the renderer. Called from free_memory().
+ * @param renderer Pointer to the renderer.
+ */
+void preview_renderer_free(Preview_renderer *renderer) {
+	if (renderer->speculate_id != 0) {
+		g_source_remove(renderer->speculate_id);
+	}
+	job_queue_close(renderer->requests);
+	g_thread_join(renderer->thread);
+
+	g_source_destroy(renderer->completion_source);
+	g_source_unref(renderer->completion_source);
+
+	Preview_job *job;
+	while ((job = job_queue_pop(renderer->requests)) != NULL) {
+		preview_job_free(job);
+	}
+	while ((job = job_queue_pop(renderer->completions)) != NULL) {
+		preview_job_free(job);
+	}
+	if (renderer->next != NULL) {
+		preview_job_free(renderer->next);
+	}
+	for (gint i = 0; i < renderer->n_spare_jobs; i++) {
+		preview_job_free(renderer->spare_jobs[i]);
+	}
+	job_queue_free(renderer->requests);
+	job_queue_free(renderer->completions);
+
+	for (gint i = 0; i < 3; i++) {
+		if (renderer->buffers[i] != NULL) {
+			cairo_surface_destroy(renderer->buffers[i]);
+		}
+	}
+	g_free(renderer);
+}
+
+/**
+ * Hands a copy of the side of the slip being shown to the render thread, at the size the preview was last drawn. The preview
+ * is redrawn when the new image is ready. Callbacks that change the slip go through slip_redraw_schedule() instead, which calls
+ * this once for a burst of changes.
+ * @param data_passer Pointer to user data.
+ */
+void preview_renderer_invalidate(Data_passer *data_passer) {
+	Preview_renderer *renderer = data_passer->preview_renderer;
+
+	if (renderer == NULL || data_passer->slip_front == NULL || renderer->width == 0) {
+		return; /* Not compiled or not drawn yet; the first draw requests the image. */
+	}
+
+	submit(renderer, preview_job_new(renderer, data_passer->front_slip_active));
+}
+
+/**
+ * Discards the image of the side not shown, because the slip changed. An image of it being rendered is dropped when it comes back.
+ * @param renderer Pointer to the renderer.
+ */
+void preview_renderer_discard_hidden(Preview_renderer *renderer) {
+	renderer->hidden_valid = FALSE;
+	renderer->generation++;
+}
+
+/**
+ * Shows the image of the side not shown, rendered ahead of time, after the user switches sides. The image that was on screen
+ * takes its place, ready for switching back.
+ * @param data_passer Pointer to user data.
+ * @return `TRUE` if the preview now shows the new side, `FALSE` if there was no up-to-date image of it and it must be rendered.
+ */
+gboolean preview_renderer_flip(Data_passer *data_passer) {
+	Preview_renderer *renderer = data_passer->preview_renderer;
+
+	/* A job in flight may be drawing into either surface being swapped. */
+	if (renderer == NULL || !renderer->hidden_valid || renderer->hidden_front != data_passer->front_slip_active ||
+		renderer->in_flight || renderer->next != NULL || renderer->completed < 0) {
+		return FALSE;
+	}
+	cairo_surface_t *hidden = renderer->buffers[PREVIEW_HIDDEN];
+	gdouble hidden_scale_factor;
+	cairo_surface_get_device_scale(hidden, &hidden_scale_factor, NULL);
+	if (cairo_image_surface_get_width(hidden) != renderer->width * renderer->scale_factor ||
+		cairo_image_surface_get_height(hidden) != renderer->height * renderer->scale_factor) {
+		return FALSE;
+	}
+
+	renderer->buffers[PREVIEW_HIDDEN] = renderer->buffers[renderer->completed];
+	renderer->buffers[renderer->completed] = hidden;
+	renderer->hidden_front = !renderer->hidden_front;
+	gtk_widget_queue_draw(renderer->drawing_area);
+	return TRUE;
+}
+
+/**
+ * Paints the latest rendered image of the slip, and asks for a new one if the preview changed size. Until the new image is
+ * ready, the previous one is stretched to the new width.
+ * @param data_passer Pointer to user data.
+ * @param cr Cairo context of the preview area.
+ * @param width Width of the preview area.
+ * @param height Height of the slip in the preview area.
+ * @param scale_factor Scale factor of the preview area.
+ */
+void preview_renderer_paint(Data_passer *data_passer, cairo_t *cr, gint width, gint height, gint scale_factor) {
+	Preview_renderer *renderer = data_passer->preview_renderer;
+
+	if (width != renderer->width || height != renderer->height || scale_factor != renderer->scale_factor) {
+		renderer->width = width;
+		renderer->height = height;
+		renderer->scale_factor = scale_factor;
+		preview_renderer_discard_hidden(renderer); /* Rendered at the old size. */
+		preview_renderer_invalidate(data_passer);
+	}
+
+	if (renderer->completed < 0) {
+		return;
+	}
+
+	/* The render thread only draws into the other surface, so this one can be read without a lock. */
+	cairo_surface_t *buffer = renderer->buffers[renderer->completed];
+	gdouble buffer_scale_factor;
+	cairo_surface_get_device_scale(buffer, &buffer_scale_factor, NULL);
+	gdouble buffer_width = cairo_image_surface_get_width(buffer) / buffer_scale_factor;
+	cairo_save(cr);
+	if (buffer_width != width) {
+		gdouble stretch = width / buffer_width;
+		cairo_scale(cr, stretch, stretch);
+	}
+	cairo_set_source_surface(cr, buffer, 0, 0);
+	cairo_paint(cr);
+	cairo_restore(cr);
+}
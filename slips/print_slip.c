@@ -1,129 +1,130 @@
+#include <cairo-pdf.h>
 #include <constants.h>
 #include <gtk/gtk.h>
+#include <gtk/gtkunixprint.h>
 #include <headers.h>
-#include <math.h>
 
 /**
  * @file print_slip.c
- * @brief Prints the actual deposit slip.
+ * @brief Compiles the layout of the deposit slip into display lists, and prints the slip.
+ *
+ * The static parts of the slip (borders, boxes, and labels) are compiled once into \ref Data_passer.slip_front and
+ * \ref Data_passer.slip_back. The variable parts (date, name, account number, and amounts) are written into fields of those
+ * lists, and only the affected fields are rewritten when the account or a check changes. See display_list.c.
+ *
+ * Printed and exported slips are rendered to PDF and kept in a \ref Render_cache, keyed by the display lists. Printing a slip
+ * that has not changed since it was last printed or exported sends the stored file to the printer, and exporting it copies the
+ * file. Printers that do not take PDF get the display lists replayed onto the print job's surface. See render_cache.c.
  */
 
 /**
- * Prints text in outlined boxes. The function prints the characters in reverse order,
- * ensuring the rightmost character is aligned with the rightmost box.
- * @param cr Cairo context.
+ * Writes text into a field, one character per box. The function places the characters in reverse order,
+ * ensuring the rightmost character is aligned with the rightmost box. Operations in the field past the end of the text are blanked.
+ * @param list Display list holding the field.
+ * @param field Field receiving the text.
  * @param text Pointer to text to be printed (account number or amount).
- * @param font_face Font face used to print the text.
  * @param font_size Font size used to print the text.
  * @param right_x Right edge of the text.
  * @param y y position of the text.
  * @param pitch Spacing between printed letters.
  */
-void print_amounts_in_boxes(cairo_t* cr,
-							const gchar* text,
-							const gchar* font_face,
-							const gint font_size,
-							const gint right_x,
-							const gint y,
-							const gint pitch) {
-	gchar destination[4];
-	cairo_save(cr);
-
+static void print_amounts_in_boxes(Slip_display_list* list,
+								   Slip_field field,
+								   const gchar* text,
+								   const gint font_size,
+								   const gint right_x,
+								   const gint y,
+								   const gint pitch) {
+	gchar destination[2];
 	gint current_x = right_x;
-	cairo_select_font_face(cr, font_face, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-	cairo_set_font_size(cr, font_size);
-	guint string_length = strlen(text);
+	gint string_length = (text != NULL) ? strlen(text) : 0;
+	gint op_index = 0;
 
-	/* In reverse order, print the current character.*/
+	/* In reverse order, place the current character.*/
 	for (gint i = string_length - 1; i >= 0; i--) {
+		Slip_op* op = slip_field_op(list, field, op_index++);
+		if (op == NULL) {
+			return; /* Text is longer than the field. */
+		}
 		g_strlcpy(destination, text + i, 2);
-		cairo_move_to(cr, current_x, y);
-		cairo_show_text(cr, destination);
+		slip_set_text_op(op, FALSE, SLIP_FONT_MONO_BOLD, font_size, current_x, y, destination, 0);
 		current_x -= pitch;
 	}
-	cairo_restore(cr);
+
+	/* Blank what is left of the field from a previous, longer value. */
+	for (Slip_op* op = slip_field_op(list, field, op_index); op != NULL; op = slip_field_op(list, field, ++op_index)) {
+		op->text[0] = '\0';
+	}
+}
+
+/**
+ * Formats an amount in cents as the digits printed in the amount boxes, for example `12345` for $123.45.
+ * @param arena Arena holding the digits.
+ * @param cents Amount in cents.
+ * @param minimum_width The digits are padded on the left with spaces to at least this many characters.
+ * @return The digits, valid until the arena is reset.
+ */
+static const gchar* box_digits(Frame_arena* arena, gint64 cents, gsize minimum_width) {
+	gchar* digits = frame_arena_alloc(arena, AMOUNT_BUFFER_SIZE);
+	amount_format_digits(cents, minimum_width, digits);
+	return digits;
 }
 
 /**
- * Prints triangles on the front side of the deposit slip. There are triangles on the rows
+ * Adds triangles on the front side of the deposit slip. There are triangles on the rows
  * for cash, total from reverse side, subtotal, less cash received.
- * @param cr Cairo context.
+ * @param list Display list of the front side.
  * @param front Pointer to a Front structure.
  */
-void write_triangles(cairo_t* cr, Front* front) {
+static void write_triangles(Slip_display_list* list, Front* front) {
 	gint rows[] = {0, 3, 4, 5};
 	gint length = sizeof(rows) / sizeof(rows[0]);
 
 	for (int i = 0; i < length; i++) {
-		cairo_new_path(cr);
 		gdouble right_vertex_y = front->amount_boxes_y + (rows[i] * front->amount_boxes_height) + (front->amount_boxes_height / 2);
-		cairo_move_to(cr, 310, right_vertex_y - 3);
-		cairo_line_to(cr, 310, right_vertex_y + 3);
-		cairo_line_to(cr, front->checks_bracket_right_x, right_vertex_y);
-		cairo_close_path(cr);
-		cairo_fill(cr);
+		gdouble vertices[] = {310, right_vertex_y - 3,
+							  310, right_vertex_y + 3,
+							  front->checks_bracket_right_x, right_vertex_y};
+		slip_add_triangle(list, vertices, 0);
 	}
 }
 
 /**
- * Prints the static shapes and text on the back of a deposit slip.
- * for cash, total from reverse side, subtotal, less cash received.
- * ensuring the rightmost character is aligned with the rightmost box.
- * @param cr Cairo context.
- * @param front Pointer to a Data_passer structure.
+ * Compiles the static shapes and text on the back of a deposit slip.
+ * @param list Display list of the back side.
+ * @param data_passer Pointer to a Data_passer structure.
  */
-void print_deposit_slip_back_static(cairo_t* cr, Data_passer* data_passer) {
-	Back* back = data_passer->back;
+static void print_deposit_slip_back_static(Slip_display_list* list, Data_passer* data_passer) {
+	Back* back = &data_passer->layout->back;
 	cairo_text_extents_t extents;
+	const gdouble listing_gray = 0.93;
 
 	/*
 	Write rectangle arround the back of the deposit slip.
 	*/
-	cairo_rectangle(cr, 0, 0, 432, 198);
-	cairo_set_line_width(cr, 0.5);
-	cairo_stroke(cr);
+	slip_add_rectangle(list, 0, 0, SLIP_WIDTH, SLIP_HEIGHT, 0.5, 0);
 
 	/*
 	Write rectangle arround the currency count.
 	*/
-	cairo_rectangle(cr, back->currency_count_frame_top_x, back->currency_count_frame_top_y, back->currency_count_frame_width, back->currency_count_frame_height);
-	cairo_set_line_width(cr, 0.5);
-	cairo_stroke(cr);
+	slip_add_rectangle(list, back->currency_count_frame_top_x, back->currency_count_frame_top_y, back->currency_count_frame_width, back->currency_count_frame_height, 0.5, 0);
 
 	/* Write horizontal body lines in currency count table.	*/
 	gdouble move_to_y = back->currency_count_frame_top_y + back->currency_count_frame_height;
 	for (gdouble i = 0; i <= 7; i++) {
 		gdouble current_x = back->currency_count_top_line_x + (i * back->currency_count_pitch);
-		cairo_move_to(cr, current_x, back->currency_count_frame_top_y);
-		cairo_line_to(cr, current_x, move_to_y);
-		cairo_stroke(cr);
+		slip_add_line(list, current_x, back->currency_count_frame_top_y, current_x, move_to_y, 0.5, 0);
 	}
 
 	/* Write vertical body lines in currency count table */
 
 	gdouble vertical_end_x = back->currency_count_frame_top_x + back->currency_count_frame_width;
-	cairo_move_to(cr, back->currency_count_top_line_x, back->currency_count_line_right_y);
-	cairo_line_to(cr, vertical_end_x, back->currency_count_line_right_y);
-	cairo_stroke(cr);
-
-	cairo_move_to(cr, back->currency_count_top_line_x, back->currency_count_line_middle_y);
-	cairo_line_to(cr, vertical_end_x, back->currency_count_line_middle_y);
-	cairo_stroke(cr);
+	slip_add_line(list, back->currency_count_top_line_x, back->currency_count_line_right_y, vertical_end_x, back->currency_count_line_right_y, 0.5, 0);
+	slip_add_line(list, back->currency_count_top_line_x, back->currency_count_line_middle_y, vertical_end_x, back->currency_count_line_middle_y, 0.5, 0);
+	slip_add_line(list, back->currency_count_top_line_x, back->currency_count_line_left_y, vertical_end_x - back->currency_count_pitch, back->currency_count_line_left_y, 0.5, 0);
 
-	cairo_move_to(cr, back->currency_count_top_line_x, back->currency_count_line_left_y);
-	cairo_line_to(cr, vertical_end_x - back->currency_count_pitch, back->currency_count_line_left_y);
-	cairo_stroke(cr);
-
-	/* Check listing lines and rectangles, requires save/restore for a new color*/
-	cairo_save(cr); /* Start new state for color */
-
-	cairo_set_source_rgb(cr, 0.93, 0.93, 0.93);
-
-	/* Draw border for check listing and the horizontal interior borders */
-	cairo_save(cr); /* Start new state for line width */
-	cairo_set_line_width(cr, back->check_listing_horizontal_border_width);
-	cairo_rectangle(cr, back->check_listing_top_x, back->check_listing_top_y, back->check_listing_width, back->check_listing_height);
-	cairo_stroke(cr);
+	/* Draw border for check listing and the horizontal interior borders, in light gray. */
+	slip_add_rectangle(list, back->check_listing_top_x, back->check_listing_top_y, back->check_listing_width, back->check_listing_height, back->check_listing_horizontal_border_width, listing_gray);
 
 	/* Draw internal horizontal borders for the check listing. */
 	gdouble internal_border_pitch_x = back->check_listing_width / 12.0;
@@ -131,35 +132,23 @@ void print_deposit_slip_back_static(cairo_t* cr, Data_passer* data_passer) {
 	gdouble check_listing_bottom_y = back->check_listing_top_y + back->check_listing_height;
 	for (gint i = 1; i <= 11; i++) {
 		current_internal_border_x += internal_border_pitch_x;
-		cairo_move_to(cr, current_internal_border_x, back->check_listing_top_y);
-		cairo_line_to(cr, current_internal_border_x, check_listing_bottom_y);
-		cairo_stroke(cr);
+		slip_add_line(list, current_internal_border_x, back->check_listing_top_y, current_internal_border_x, check_listing_bottom_y, back->check_listing_horizontal_border_width, listing_gray);
 	}
-	cairo_restore(cr); /* Restore previous line wdith */
 
 	/*
 	Draw line separating dollars and cents. As there are seven spaces for amounts, and
 	and two spaces for cents, therefore this line is drawn at 2/7 of the height of the check
-	listing. This line requires a special line width, so we introduce a new cairo state.
+	listing. This line requires a special line width.
 	*/
-	cairo_save(cr); /* Start new state for line width */
-	cairo_set_line_width(cr, 4);
 	gdouble separator_y = (back->check_listing_height * (2.0 / 7.0)) + back->check_listing_top_y;
-	cairo_move_to(cr, back->check_listing_top_x, separator_y);
-	cairo_line_to(cr, back->check_listing_top_x + back->check_listing_width, separator_y);
-	cairo_stroke(cr);
-	cairo_restore(cr); /* Restore previous line wdith */
+	slip_add_line(list, back->check_listing_top_x, separator_y, back->check_listing_top_x + back->check_listing_width, separator_y, 4, listing_gray);
 
 	/* Draw the line separating the two cents digits As there are seven spaces for amounts,
-	this line is drawin at 1/7 of the height of the check listing. At this point we set the line width
-	to back->check_listing_separator_width, and use that width for the following digit separators. */
-
-	cairo_save(cr); /* Start new state for line width */
-	cairo_set_line_width(cr, back->check_listing_separator_width);
+	this line is drawin at 1/7 of the height of the check listing. This line and the following digit separators
+	use back->check_listing_separator_width. */
+	gdouble separator_width = back->check_listing_separator_width;
 	separator_y = (back->check_listing_height / 7.0) + back->check_listing_top_y;
-	cairo_move_to(cr, back->check_listing_top_x, separator_y);
-	cairo_line_to(cr, back->check_listing_top_x + back->check_listing_width, separator_y);
-	cairo_stroke(cr);
+	slip_add_line(list, back->check_listing_top_x, separator_y, back->check_listing_top_x + back->check_listing_width, separator_y, separator_width, listing_gray);
 
 	/* Draw the small separator lines between digits. The lines are drawn across and then down.*/
 	gdouble separator_pitch_y = back->check_listing_height / 7.0;
@@ -172,374 +161,109 @@ void print_deposit_slip_back_static(cairo_t* cr, Data_passer* data_passer) {
 			switch (horiz_x) {
 				case 0:
 					/* Draw the short separator lines at the top of the check listing */
-					cairo_move_to(cr, current_internal_border_x, separator_y);
-					cairo_line_to(cr, current_internal_border_x + back->check_listing_separator_length, separator_y);
-					cairo_stroke(cr);
+					slip_add_line(list, current_internal_border_x, separator_y, current_internal_border_x + back->check_listing_separator_length, separator_y, separator_width, listing_gray);
 					break;
 
 				case 12:
 					/* Draw the short separator lines at the end of the check listing */
 					gdouble last_internal_border_x = back->check_listing_top_x + back->check_listing_width - back->check_listing_separator_length;
-					cairo_move_to(cr, last_internal_border_x, separator_y);
-					cairo_line_to(cr, last_internal_border_x + back->check_listing_separator_length, separator_y);
-					cairo_stroke(cr);
+					slip_add_line(list, last_internal_border_x, separator_y, last_internal_border_x + back->check_listing_separator_length, separator_y, separator_width, listing_gray);
 					break;
 
 				default:
 					current_internal_border_x += internal_border_pitch_x;
 					gdouble my_offset = current_internal_border_x - back->check_listing_separator_length;
-					cairo_move_to(cr, my_offset, separator_y);
-					cairo_line_to(cr, my_offset + long_seperator_length, separator_y);
-					cairo_stroke(cr);
+					slip_add_line(list, my_offset, separator_y, my_offset + long_seperator_length, separator_y, separator_width, listing_gray);
 			}
 		}
 	}
-	cairo_restore(cr); /* Restore previous line wdith */
 
-	cairo_restore(cr); /* Restore previous color */
-
-	/* Draw the lines for listing check numbers. Requires setting a line width */
-	cairo_save(cr); /* Set new state for line width */
-	// cairo_set_source_rgb(cr, 0.98, 0, 0);
-	cairo_set_line_width(cr, 0.5);
+	/* Draw the lines for listing check numbers. */
 	gdouble border_width_offset = back->check_listing_horizontal_border_width / 2.0;
 	current_internal_border_x = back->check_listing_top_x + internal_border_pitch_x - border_width_offset;
 	gdouble start_y = back->check_listing_top_y + back->check_listing_height + border_width_offset;
 	gdouble end_y = start_y + back->check_listing_check_number_line_length;
 	for (gint i = 0; i <= 10; i++) {
-		cairo_move_to(cr, current_internal_border_x, start_y);
-		cairo_line_to(cr, current_internal_border_x, end_y);
-		cairo_stroke(cr);
+		slip_add_line(list, current_internal_border_x, start_y, current_internal_border_x, end_y, 0.5, 0);
 		current_internal_border_x += internal_border_pitch_x;
 	}
-	cairo_restore(cr); /* Restore previous line width */
 
-	/* Labels, all of which are rotated 90 degrees. */
+	/* Labels, all of which are rotated 90 degrees. Rotation does not change text extents, so they are measured unrotated. */
 	/* Write Currency Count label. */
-
-	cairo_save(cr); /* Start new state */
-	cairo_select_font_face(cr, data_passer->font_family_sans, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-	cairo_set_font_size(cr, back->currency_count_label_font_size);
-	cairo_move_to(cr, 0, 0);
-	cairo_rotate(cr, -1.570796);
-	cairo_text_extents(cr, "CURRENCY COUNT - FOR FINANCIAL INSTITUTION USE ONLY", &extents);
-	cairo_move_to(cr, back->currency_count_label_x - (extents.width / 2), back->currency_count_label_y);
-	cairo_show_text(cr, "CURRENCY COUNT - FOR FINANCIAL INSTITUTION USE ONLY");
+	gdouble font_size = back->currency_count_label_font_size;
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "CURRENCY COUNT - FOR FINANCIAL INSTITUTION USE ONLY", &extents);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, back->currency_count_label_x - (extents.width / 2), back->currency_count_label_y, "CURRENCY COUNT - FOR FINANCIAL INSTITUTION USE ONLY", 0);
 
 	/* Write multiplication signs */
 	for (gdouble i = 0; i <= 6; i++) {
 		gdouble current_y = back->multiplication_sign_y + (i * back->currency_count_pitch);
-		cairo_move_to(cr, back->multiplication_sign_x, current_y);
-		cairo_show_text(cr, "×");
+		slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, back->multiplication_sign_x, current_y, "×", 0);
 	}
 
 	/* Write denominations */
 	gchar* denominations[] = {"100", "50", "20", "10", "5", "2", "1"};
 	for (gint i = 0; i <= 6; i++) {
 		gdouble current_y = back->multiplication_sign_y + (i * back->currency_count_pitch);
-		cairo_text_extents(cr, denominations[i], &extents);
-		cairo_move_to(cr, back->denomination_x - extents.width, current_y);
-		cairo_show_text(cr, denominations[i]);
+		slip_text_extents(list, SLIP_FONT_SANS, font_size, denominations[i], &extents);
+		slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, back->denomination_x - extents.width, current_y, denominations[i], 0);
 	}
 
-	/* Write Total */
-	cairo_set_font_size(cr, back->total_font_size);
-	cairo_move_to(cr, back->total_x, back->total_y);
-	cairo_show_text(cr, "TOTAL");
-
-	/* Write dollar sign */
-	cairo_set_font_size(cr, back->total_font_size);
-	cairo_move_to(cr, back->dollar_x, back->total_y);
-	cairo_show_text(cr, "$");
+	/* Write Total and the dollar sign */
+	slip_add_rotated_text(list, SLIP_FONT_SANS, back->total_font_size, back->total_x, back->total_y, "TOTAL", 0);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, back->total_font_size, back->dollar_x, back->total_y, "$", 0);
 
 	/* Write Dollars and Cents labels */
-	cairo_set_font_size(cr, back->currency_count_label_font_size);
 	gdouble label_baseline = back->check_listing_top_x - back->dollars_cents_offset_x;
 	/* Center the CENTS label in the middle of the CENTS column. */
-	cairo_text_extents(cr, "CENTS", &extents);
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "CENTS", &extents);
 	separator_y = (back->check_listing_height / 7.0) + back->check_listing_top_y + (extents.width / 2);
-	cairo_move_to(cr, -separator_y, label_baseline);
-	cairo_show_text(cr, "CENTS");
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, -separator_y, label_baseline, "CENTS", 0);
 
 	/* Center the DOLLARS label in the middle of the DOLLARS column. */
-	cairo_text_extents(cr, "DOLLARS", &extents);
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "DOLLARS", &extents);
 	separator_y = (back->check_listing_height * (4.5 / 7.0)) + back->check_listing_top_y + (extents.width / 2);
-	cairo_move_to(cr, -separator_y, label_baseline);
-	cairo_show_text(cr, "DOLLARS");
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, -separator_y, label_baseline, "DOLLARS", 0);
 
 	/* Write the CHECKS label. */
-	cairo_set_font_size(cr, back->total_font_size);
-	cairo_move_to(cr, -(back->check_listing_top_y + back->check_listing_height - border_width_offset + back->check_listing_check_number_line_length), back->check_listing_top_x - back->checks_offset_x);
-	cairo_show_text(cr, "CHECKS");
+	slip_add_rotated_text(list, SLIP_FONT_SANS, back->total_font_size, -(back->check_listing_top_y + back->check_listing_height - border_width_offset + back->check_listing_check_number_line_length), back->check_listing_top_x - back->checks_offset_x, "CHECKS", 0);
 
 	/* Write the LIST SINGLY label. */
-	cairo_set_font_size(cr, back->currency_count_label_font_size);
-	cairo_move_to(cr, -(back->check_listing_top_y + back->check_listing_height - border_width_offset + back->check_listing_check_number_line_length), back->check_listing_top_x - back->list_singly_offset_x);
-	cairo_show_text(cr, "LIST SINGLY");
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, -(back->check_listing_top_y + back->check_listing_height - border_width_offset + back->check_listing_check_number_line_length), back->check_listing_top_x - back->list_singly_offset_x, "LIST SINGLY", 0);
 
 	/* Write the TOTAL label. */
-	cairo_text_extents(cr, "TOTAL", &extents);
-	cairo_move_to(cr, -(back->check_listing_top_y + back->check_listing_height + border_width_offset + (back->check_listing_check_number_line_length / 2.0) + (extents.width / 2.0)), back->check_listing_top_x + back->check_listing_width - back->total_offset_x);
-	cairo_show_text(cr, "TOTAL");
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "TOTAL", &extents);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, -(back->check_listing_top_y + back->check_listing_height + border_width_offset + (back->check_listing_check_number_line_length / 2.0) + (extents.width / 2.0)), back->check_listing_top_x + back->check_listing_width - back->total_offset_x, "TOTAL", 0);
 
 	/* Write the MUST BE ENTERED label. */
-	cairo_set_font_size(cr, back->must_be_entered_font_size);
-	cairo_text_extents(cr, "MUST BE ENTERED", &extents);
-	cairo_move_to(cr, -(back->check_listing_top_y + back->check_listing_height + border_width_offset + (back->check_listing_check_number_line_length / 2.0) + (extents.width / 2.0)), back->check_listing_top_x + back->check_listing_width - back->must_be_entered_offset_x);
-	cairo_show_text(cr, "MUST BE ENTERED");
-
-	cairo_text_extents(cr, "ON FRONT SIDE", &extents);
-	cairo_move_to(cr, -(back->check_listing_top_y + back->check_listing_height + border_width_offset + (back->check_listing_check_number_line_length / 2.0) + (extents.width / 2.0)), back->check_listing_top_x + back->check_listing_width - back->on_front_side_offset_x);
-	cairo_show_text(cr, "ON FRONT SIDE");
-	cairo_restore(cr); /* remove rotation, font size*/
-}
-
-/**
- * Callback fired while iterating over all checks. This function accumulates the total of all checks appearing on the back side of the deposit slip--equivalent to the third check and beyond.
- * @param model Pointer to the model containing the checks.
- * @param path Path to the current check.
- * @param iter Iterator for the current check.
- * @param data Pointer to user data.
- * @return `FALSE` to ensure we iterate over all rows in the model.
- */
-gboolean subtotal_back_side(GtkTreeModel* model,
-							GtkTreePath* path,
-							GtkTreeIter* iter,
-							gpointer data) {
-	Data_passer* data_passer = (Data_passer*)data;
-	GtkTreePath* tree_path = gtk_tree_model_get_path(model, iter);
-	gchar* pathstring = gtk_tree_path_to_string(tree_path);
+	font_size = back->must_be_entered_font_size;
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "MUST BE ENTERED", &extents);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, -(back->check_listing_top_y + back->check_listing_height + border_width_offset + (back->check_listing_check_number_line_length / 2.0) + (extents.width / 2.0)), back->check_listing_top_x + back->check_listing_width - back->must_be_entered_offset_x, "MUST BE ENTERED", 0);
 
-	gchar* amount; /* Memory freed below. */
-	gtk_tree_model_get(model, iter, CHECK_AMOUNT, &amount, -1);
-	guint current_row_number = atoi(pathstring);
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "ON FRONT SIDE", &extents);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, font_size, -(back->check_listing_top_y + back->check_listing_height + border_width_offset + (back->check_listing_check_number_line_length / 2.0) + (extents.width / 2.0)), back->check_listing_top_x + back->check_listing_width - back->on_front_side_offset_x, "ON FRONT SIDE", 0);
 
-	if (current_row_number >= 2) {
-		gtk_tree_model_get(model, iter, CHECK_AMOUNT, &amount, -1);
-		gfloat amount_float = atof((char*)amount);
-		data_passer->total_back_side += amount_float;
-		g_free(amount);
+	/* Stroke the grid in a few batches, then reserve the check listing and its total. */
+	slip_display_list_batch_strokes(list);
+	for (gint row = 2; row < MAXIMUM_CHECKS; row++) {
+		slip_reserve_field(list, SLIP_FIELD_CHECK_FIRST + row, SLIP_AMOUNT_FIELD_OPS);
 	}
-
-	gtk_tree_path_free(tree_path);
-	return FALSE;
-}
-/**
- * Callback fired while iterating over all checks. This function prints the first two checks in the store on the front side of the deposit slip.
- * @param model Pointer to the model containing the checks.
- * @param path Path to the current check.
- * @param iter Iterator for the current check.
- * @param data Pointer to user data.
- * @return `FALSE` while we are printing the first two checks, `TRUE` if we were passed the third check, thereby halting the iteration.
- * \sa draw_page()
- * \sa print_deposit_amounts_back()
- */
-gboolean print_deposit_amounts_front(GtkTreeModel* model,
-									 GtkTreePath* path,
-									 GtkTreeIter* iter,
-									 gpointer data) {
-	Data_passer* data_passer = (Data_passer*)data;
-	cairo_t* cr = data_passer->cairo_context;
-	gchar* amount; /* Memory freed below. */
-	gtk_tree_model_get(model, iter, CHECK_AMOUNT, &amount, -1);
-	gchar* pathstring = gtk_tree_path_to_string(path); /* Memory freed below. */
-	guint current_row_number = atoi(pathstring) + 1;
-
-	guint64 row_number = 0;
-	GError* gerror = NULL;
-
-	g_ascii_string_to_unsigned(
-		pathstring, /* path of the current row */
-		10, /* Base 10 */
-		0, /* minimum value */
-		100, /* maximum value */
-		&row_number, /* returned row number */
-		&gerror); /* pointer for GError *. */
-
-	/* Stop rendering of checks after the second one in the store. */
-	if (row_number > 1) {
-		return TRUE;
-	}
-
-	/* Get the formatted string corresponding to this check's amount. */
-	gfloat current_amount = atof(amount) * 100;
-	gchar formatted_amount[10];
-	g_snprintf(formatted_amount, 11, "%3.0f", current_amount);
-	print_amounts_in_boxes(cr,
-						   formatted_amount,
-						   data_passer->font_family_mono,
-						   data_passer->front->account_number_human_font_size,
-						   data_passer->front->amount_boxes_x + (7 * data_passer->front->amount_boxes_width + 3),
-						   data_passer->front->amount_boxes_y + ((current_row_number + 1) * data_passer->front->amount_boxes_height) - 3,
-						   data_passer->front->amount_boxes_width);
-
-	/* Increment the total of all amounts in the deposit slip and update its
-	value in the hash table of passed pointers. */
-
-	float amount_float = atof((char*)amount);
-
-	data_passer->total_deposit += amount_float;
-
-	g_free(amount);
-	g_free(pathstring);
-
-	return FALSE; /* Continue rendering the next row. */
+	slip_reserve_field(list, SLIP_FIELD_BACK_SUBTOTAL, SLIP_AMOUNT_FIELD_OPS);
 }
 
 /**
- * Callback fired while iterating over all checks. This function prints the third through last checks (if any) and subtotal on the back side of the deposit slip.
- * @param model Pointer to the model containing the checks.
- * @param path Path to the current check.
- * @param iter Iterator for the current check.
- * @param data Pointer to user data.
- * @return Always returns `FALSE` as we want to examine every check in the store.
- * \sa draw_page()
- * \sa print_deposit_amounts_front()
+ * Compiles the static shapes and text on the front of a deposit slip, and reserves the fields for the variable parts.
+ * @param list Display list of the front side.
+ * @param data_passer Pointer to a Data_passer structure.
  */
-gboolean print_deposit_amounts_back(GtkTreeModel* model,
-									GtkTreePath* path,
-									GtkTreeIter* iter,
-									gpointer data) {
-	Data_passer* data_passer = (Data_passer*)data;
-	GtkTreePath* tree_path = gtk_tree_model_get_path(model, iter);
-	gchar* pathstring = gtk_tree_path_to_string(tree_path);
-
-	guint current_row_number = atoi(pathstring);
-
-	/* Ignore first two checks as they are not on the back of the slip. */
-	if (current_row_number < 2) {
-		gtk_tree_path_free(tree_path);
-		g_free(pathstring);
-		return FALSE;
-	}
-
-	gchar* amount; /* Memory freed below. */
-	gtk_tree_model_get(model, iter, CHECK_AMOUNT, &amount, -1);
-
-	gfloat current_amount = atof(amount) * 100;
-	gchar formatted_amount[10];
-	g_snprintf(formatted_amount, 11, "%3.0f", current_amount);
-
-	cairo_t* cr = data_passer->cairo_context;
-
-	cairo_save(cr); /* Save current rotation */
-	cairo_move_to(cr, 0, 0);
-	cairo_rotate(cr, -G_PI_2); /* Rotate 90 degrees clockwise relative to previous context */
-
-	cairo_select_font_face(cr, data_passer->font_family_mono, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-	cairo_set_font_size(cr, data_passer->font_size_monospace);
-
-	Back* back = data_passer->back;
-
-	guint string_length = strlen(formatted_amount);
-	gchar digit_string[2];
-	digit_string[1] = '\0';
-	gdouble separator_pitch_y = back->check_listing_height / 7.0;
-	gdouble separator_pitch_x = back->check_listing_width / 12.0;
-	/* The left edge of the right-most number is a function of the following:
-	 * top-left corner of check listing, y position
-	 * border width
-	 * pitch between number separators
-	 * separator width
-	 */
-	gdouble current_y = back->check_listing_top_y + ((back->check_listing_horizontal_border_width + separator_pitch_y - back->check_listing_separator_width) / 2.0);
-
-	/* The x position of the current number is a function of the following:
-	 * top-left corner of check listing, x position
-	 * border width
-	 * pitch between horizontal borders
-	 * separator width
-	 * current row number
-	 */
-	gdouble current_x = back->check_listing_top_x + ((back->check_listing_horizontal_border_width + separator_pitch_x - back->check_listing_separator_width) / 2.0) + ((current_row_number - 2) * separator_pitch_x);
-	/* In reverse order, print the current character.*/
+static void print_deposit_slip_front_static(Slip_display_list* list, Data_passer* data_passer) {
+	Front* front = &data_passer->layout->front;
 	cairo_text_extents_t extents;
-	for (gint i = string_length - 1; i >= 0; i--) {
-		digit_string[0] = formatted_amount[i];
-		cairo_text_extents(cr, digit_string, &extents);
-		cairo_move_to(cr, -(current_y + (extents.width / 2.0)), current_x + (extents.height / 2.0));
-		cairo_show_text(cr, digit_string);
-		current_y += separator_pitch_y;
-	}
-
-	/* If printed the last check on the back side, print the subtotal. */
-	if ((current_row_number + 1) == number_of_checks(data_passer)) {
-		g_snprintf(formatted_amount, 11, "%d", (guint)(data_passer->total_back_side * 100));
-		string_length = strlen(formatted_amount);
-		current_y = back->check_listing_top_y + ((back->check_listing_horizontal_border_width + separator_pitch_y - back->check_listing_separator_width) / 2.0);
-		current_x = back->check_listing_top_x + back->check_listing_width;
-		for (gint i = string_length - 1; i >= 0; i--) {
-			digit_string[0] = formatted_amount[i];
-			cairo_text_extents(cr, digit_string, &extents);
-			cairo_move_to(cr, -(current_y + (extents.width / 2.0)), current_x - (extents.height / 2.0));
-			cairo_show_text(cr, digit_string);
-			current_y += separator_pitch_y;
-		}
-	}
-
-	g_free(amount);
-	g_free(pathstring);
-	cairo_restore(cr); /* Restore previous rotation */
-	return FALSE;
-}
-
-/**
- * Callback fired when a print job prints a page. It calls functions to print the front and the back of the deposit slip. (There is a lot of commonality between this code and the one in draw_preview(). However, the commonality was not enough to combine them into a single function.)
- *
- * @param self A Gtk print operation.
- * @param context A GTK print context.
- * @param page_nr Current page number.
- * @param data Pointer to user data.
- * \sa print_deposit_amounts_front()
- * \sa print_deposit_amounts_back()
- */
-void draw_page(GtkPrintOperation* self, GtkPrintContext* context, gint page_nr, gpointer data) {
-	Data_passer* data_passer = (Data_passer*)data;
-
-	gchar* routing_number = NULL;
-	gchar* account_number = NULL;
-	gchar* account_name = NULL;
-
-	GtkTreeIter iter;
-	GtkTreeModel* model;
-
-	/* Retrieve the currently selected account. */
-	GtkTreeSelection* tree_selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(data_passer->checks_accounts_treeview));
-
-	if (gtk_tree_selection_get_selected(tree_selection, &model, &iter)) {
-		gtk_tree_model_get(model, &iter,
-						   ACCOUNT_NUMBER, &account_number,
-						   ACCOUNT_NAME, &account_name,
-						   ROUTING_NUMBER, &routing_number,
-						   -1);
-	}
-
-	cairo_text_extents_t extents;
-	cairo_t* cr;
-	cr = gtk_print_context_get_cairo_context(context);
-	data_passer->cairo_context = cr;
-
-	cairo_select_font_face(cr, data_passer->font_family_sans, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-	cairo_set_font_size(cr, data_passer->font_size_sans_serif);
-	cairo_set_source_rgb(cr, 0, 0, 0);
-
-	/*
-		Translate the surface so that the deposit slip appears in the top middle of the printed page.
-		Width of paper is 8.5 * 72 = 612
-		Width of deposit slip is 6 * 72 = 432
-		Difference is 180
-		Therefore there is a margin of 90 on each side of the deposit slip
-	 */
-	cairo_translate(cr, 90, 10);
-
-	Front* front = data_passer->front;
+	const gdouble box_gray = 0.85;
 
 	/*
 		Write rectangle arround the deposit slip.
 	*/
-	cairo_rectangle(cr, 0, 0, 432, 198);
-	cairo_set_line_width(cr, 0.5);
-	cairo_stroke(cr);
+	slip_add_rectangle(list, 0, 0, SLIP_WIDTH, SLIP_HEIGHT, 0.5, 0);
 
 	/*
 		Write Deposit label. This label is centered on the deposit slip, so
@@ -548,76 +272,48 @@ void draw_page(GtkPrintOperation* self, GtkPrintContext* context, gint page_nr,
 
 		The center of the deposit slip is 6 * 72 / 2 = 216.
 	*/
-	cairo_set_font_size(cr, front->deposit_label_font_size);
-	cairo_text_extents(cr, "DEPOSIT", &extents);
-	cairo_move_to(cr, 216 - (extents.width / 2), front->deposit_label_y);
-	cairo_show_text(cr, "DEPOSIT");
+	slip_text_extents(list, SLIP_FONT_SANS, front->deposit_label_font_size, "DEPOSIT", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, front->deposit_label_font_size, (SLIP_WIDTH / 2) - (extents.width / 2), front->deposit_label_y, "DEPOSIT", 0);
 
 	/* Write "Checks and other Items" label. This label is rotated 90 degrees. */
-	cairo_save(cr); /* Start new state */
-	cairo_select_font_face(cr, data_passer->font_family_sans, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-	cairo_set_font_size(cr, front->checks_other_items_font_size);
-	cairo_move_to(cr, 0, 0);
-	cairo_rotate(cr, -1.570796);
-	cairo_move_to(cr, -126, 7);
-	cairo_show_text(cr, "CHECKS AND OTHER ITEMS ARE RECEIVED FOR DEPOSIT SUBJECT");
-	cairo_move_to(cr, -117, 11);
-	cairo_show_text(cr, "TO THE PROVISIONS OF THE UNIFORM COMMERCIAL CODE");
-	cairo_move_to(cr, -108, 15);
-	cairo_show_text(cr, "OR ANY APPLICABLE COLLECTION AGREEMENT");
-	cairo_move_to(cr, 50, 50);
-	cairo_restore(cr); /* remove rotation, font size*/
+	slip_add_rotated_text(list, SLIP_FONT_SANS, front->checks_other_items_font_size, -126, 7, "CHECKS AND OTHER ITEMS ARE RECEIVED FOR DEPOSIT SUBJECT", 0);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, front->checks_other_items_font_size, -117, 11, "TO THE PROVISIONS OF THE UNIFORM COMMERCIAL CODE", 0);
+	slip_add_rotated_text(list, SLIP_FONT_SANS, front->checks_other_items_font_size, -108, 15, "OR ANY APPLICABLE COLLECTION AGREEMENT", 0);
 
 	/* Write Date label and line */
-	cairo_set_font_size(cr, front->date_name_address_label_font_size);
-	cairo_move_to(cr, front->date_name_address_label_x, front->date_label_y);
-	cairo_show_text(cr, "DATE");
-	cairo_move_to(cr, front->date_name_line_x, front->date_label_y);
-	cairo_line_to(cr, front->date_name_line_x + front->date_line_length, front->date_label_y);
-	cairo_stroke(cr);
+	gdouble font_size = front->date_name_address_label_font_size;
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->date_name_address_label_x, front->date_label_y, "DATE", 0);
+	slip_add_line(list, front->date_name_line_x, front->date_label_y, front->date_name_line_x + front->date_line_length, front->date_label_y, 0.5, 0);
 
 	/* Write Name label and line */
-	cairo_move_to(cr, front->date_name_address_label_x, front->name_label_y);
-	cairo_show_text(cr, "NAME");
-	cairo_move_to(cr, front->date_name_line_x, front->name_label_y);
-	cairo_line_to(cr, front->date_name_line_x + front->name_line_length, front->name_label_y);
-	cairo_stroke(cr);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->date_name_address_label_x, front->name_label_y, "NAME", 0);
+	slip_add_line(list, front->date_name_line_x, front->name_label_y, front->date_name_line_x + front->name_line_length, front->name_label_y, 0.5, 0);
 
 	/* Write Address label and line */
-	cairo_move_to(cr, front->date_name_address_label_x, front->address_label_y);
-	cairo_show_text(cr, "ADDRESS");
-	cairo_move_to(cr, front->address_line_x, front->address_label_y);
-	cairo_line_to(cr, front->date_name_line_x + front->name_line_length, front->address_label_y);
-	cairo_stroke(cr);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->date_name_address_label_x, front->address_label_y, "ADDRESS", 0);
+	slip_add_line(list, front->address_line_x, front->address_label_y, front->date_name_line_x + front->name_line_length, front->address_label_y, 0.5, 0);
 
 	/* Write Gray Account Number label*/
-	cairo_save(cr); /* New state for rgb */
-	cairo_set_source_rgb(cr, 0.85, 0.85, 0.85);
 	gdouble boxes_midpoint = (front->account_number_squares_width * 5) + front->account_number_squares_x;
-	cairo_set_font_size(cr, front->account_number_label_font_size);
-	cairo_text_extents(cr, "ACCOUNT NUMBER", &extents);
-	cairo_move_to(cr, (boxes_midpoint - (extents.width / 2)), front->account_number_label_y);
-	cairo_show_text(cr, "ACCOUNT NUMBER");
+	slip_text_extents(list, SLIP_FONT_SANS, front->account_number_label_font_size, "ACCOUNT NUMBER", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, front->account_number_label_font_size, (boxes_midpoint - (extents.width / 2)), front->account_number_label_y, "ACCOUNT NUMBER", box_gray);
 
 	/* Write boxes for account number */
-	cairo_rectangle(cr, front->account_number_squares_x,
-					front->account_number_squares_y,
-					front->account_number_squares_width * 10,
-					front->account_number_squares_height);
-	cairo_set_line_width(cr, 1.0);
+	slip_add_rectangle(list, front->account_number_squares_x,
+					   front->account_number_squares_y,
+					   front->account_number_squares_width * 10,
+					   front->account_number_squares_height,
+					   1.0, box_gray);
 
 	gdouble y_position = front->account_number_squares_y + front->account_number_squares_height;
 
 	for (gint i = 1; i <= 9; i++) {
 		gdouble x_position = front->account_number_squares_x + (i * front->account_number_squares_width);
-		cairo_move_to(cr, x_position, front->account_number_squares_y);
-		cairo_line_to(cr, x_position, y_position);
-		cairo_stroke(cr);
+		slip_add_line(list, x_position, front->account_number_squares_y, x_position, y_position, 1.0, box_gray);
 	}
 
 	/* Write boxes for cash, checks, subtotal, less cash */
 
-	cairo_set_line_width(cr, 1.0);
 	gint big_box_width = front->amount_boxes_width * 8;
 	gint cents_dividing_line_x = front->amount_boxes_x + 6 * front->amount_boxes_width;
 	gint line_top;
@@ -627,10 +323,11 @@ void draw_page(GtkPrintOperation* self, GtkPrintContext* context, gint page_nr,
 	for (gint i = 0; i <= 5; i++) {
 		/* Draw a rectangle for a row of boxes. */
 		line_top = front->amount_boxes_y + (i * front->amount_boxes_height);
-		cairo_rectangle(cr, front->amount_boxes_x,
-						line_top,
-						big_box_width,
-						front->amount_boxes_height);
+		slip_add_rectangle(list, front->amount_boxes_x,
+						   line_top,
+						   big_box_width,
+						   front->amount_boxes_height,
+						   1.0, box_gray);
 
 		line_bottom = line_top + front->amount_boxes_height;
 		short_line_top = line_bottom - front->amount_boxes_separator_height;
@@ -638,289 +335,680 @@ void draw_page(GtkPrintOperation* self, GtkPrintContext* context, gint page_nr,
 		/* Draw separator lines within current row */
 		for (gint j = 1; j <= 7; j++) {
 			if (j == 6) continue;
-			if (j == 7) {
-				cairo_move_to(cr, front->amount_boxes_x + j * front->amount_boxes_width, line_top);
-			} else {
-				cairo_move_to(cr, front->amount_boxes_x + j * front->amount_boxes_width, short_line_top);
-			}
-			cairo_line_to(cr, front->amount_boxes_x + j * front->amount_boxes_width, line_bottom);
+			gdouble x_position = front->amount_boxes_x + j * front->amount_boxes_width;
+			slip_add_line(list, x_position, (j == 7) ? line_top : short_line_top, x_position, line_bottom, 1.0, box_gray);
 		}
-		cairo_stroke(cr);
 		/* Draw thick line before cents boxes */
-		cairo_save(cr); /* New state for thick line*/
-		cairo_set_line_width(cr, 1.8);
-		cairo_move_to(cr, cents_dividing_line_x, line_top);
-		cairo_line_to(cr, cents_dividing_line_x, line_bottom);
-		cairo_stroke(cr);
-		cairo_restore(cr); /* Restore previous line width*/
+		slip_add_line(list, cents_dividing_line_x, line_top, cents_dividing_line_x, line_bottom, 1.8, box_gray);
 	}
 	/* Draw amount boxes for net deposit */
 	line_top = front->amount_boxes_y + (6 * front->amount_boxes_height);
 	gint net_deposit_left_edge = front->amount_boxes_x - front->amount_boxes_width;
-	cairo_rectangle(cr, net_deposit_left_edge,
-					line_top,
-					big_box_width + front->amount_boxes_width,
-					front->amount_boxes_height);
+	slip_add_rectangle(list, net_deposit_left_edge,
+					   line_top,
+					   big_box_width + front->amount_boxes_width,
+					   front->amount_boxes_height,
+					   1.0, box_gray);
 	line_bottom = line_top + front->amount_boxes_height;
 	short_line_top = line_bottom - front->amount_boxes_separator_height;
 	for (gint j = 1; j <= 8; j++) {
 		if (j == 7) continue;
-		if (j == 8) {
-			cairo_move_to(cr, net_deposit_left_edge + j * front->amount_boxes_width, line_top);
-		} else {
-			cairo_move_to(cr, net_deposit_left_edge + j * front->amount_boxes_width, short_line_top);
-		}
-		cairo_line_to(cr, net_deposit_left_edge + j * front->amount_boxes_width, line_bottom);
+		gdouble x_position = net_deposit_left_edge + j * front->amount_boxes_width;
+		slip_add_line(list, x_position, (j == 8) ? line_top : short_line_top, x_position, line_bottom, 1.0, box_gray);
 	}
-	cairo_stroke(cr);
 
 	/* Draw thick line before cents boxes */
-	cairo_save(cr); /* New state for thick line*/
-	cairo_set_line_width(cr, 1.8);
-	cairo_move_to(cr, cents_dividing_line_x, line_top);
-	cairo_line_to(cr, cents_dividing_line_x, line_bottom);
-	cairo_stroke(cr);
-	cairo_restore(cr); /* Restore previous line width*/
-
-	/* Write brackets for checks deposited. */
-	/* First bracket */
-	gint bottom_second_row_y = front->amount_boxes_y + 2 * front->amount_boxes_height;
+	slip_add_line(list, cents_dividing_line_x, line_top, cents_dividing_line_x, line_bottom, 1.8, box_gray);
+
+	/* Write brackets for checks deposited, below the first and second check rows. */
 	gint checks_bracket_left = front->checks_bracket_right_x - front->checks_bracket_width;
-	gint checks_bracket_top = bottom_second_row_y - front->checks_bracket_height;
-	cairo_new_path(cr);
-	cairo_move_to(cr, front->checks_bracket_right_x, checks_bracket_top);
-	cairo_line_to(cr, front->checks_bracket_right_x, bottom_second_row_y);
-	cairo_line_to(cr, checks_bracket_left, bottom_second_row_y);
-	cairo_line_to(cr, checks_bracket_left, checks_bracket_top);
-	cairo_stroke(cr);
-
-	/* Second bracket */
-	bottom_second_row_y = front->amount_boxes_y + 3 * front->amount_boxes_height;
-	checks_bracket_top = bottom_second_row_y - front->checks_bracket_height;
-	cairo_new_path(cr);
-	cairo_move_to(cr, front->checks_bracket_right_x, checks_bracket_top);
-	cairo_line_to(cr, front->checks_bracket_right_x, bottom_second_row_y);
-	cairo_line_to(cr, checks_bracket_left, bottom_second_row_y);
-	cairo_line_to(cr, checks_bracket_left, checks_bracket_top);
-	cairo_stroke(cr);
-
-	cairo_restore(cr); /* Restore previous color*/
+	for (gint row = 2; row <= 3; row++) {
+		gint bottom_row_y = front->amount_boxes_y + row * front->amount_boxes_height;
+		gint checks_bracket_top = bottom_row_y - front->checks_bracket_height;
+		gdouble bracket[] = {front->checks_bracket_right_x, checks_bracket_top,
+							 front->checks_bracket_right_x, bottom_row_y,
+							 checks_bracket_left, bottom_row_y,
+							 checks_bracket_left, checks_bracket_top};
+		slip_add_polyline(list, bracket, 4, 1.0, box_gray);
+	}
 
 	/*
 	Write decimal point in net deposit row.
 	The values for cents_dividing_line_x and line_bottom were
 	assigned when drawing the amount boxes for the net deposit row.
 	 */
-	cairo_arc(cr, cents_dividing_line_x, line_bottom, 0.9, 0, 2 * G_PI);
-	cairo_fill(cr);
-
-	/* Write MICR routing number */
-	cairo_save(cr); /* New state for MICR font face and size*/
-	cairo_select_font_face(cr, data_passer->font_face_micr, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-	cairo_set_font_size(cr, front->micr_font_size);
-	cairo_move_to(cr, front->micr_routing_number_label_x, front->micr_routing_number_label_y);
-	gchar* routing_with_transit = g_strconcat(MICR_TRANSIT, routing_number, MICR_TRANSIT, NULL);
-	cairo_show_text(cr, routing_with_transit);
-	g_free(routing_with_transit);
-
-	/* Write MICR account number */
-	cairo_move_to(cr, front->micr_account_number_label_x, front->micr_routing_number_label_y);
-	gchar* account_with_transit = g_strconcat(account_number, MICR_ON_US, NULL);
-	cairo_show_text(cr, account_with_transit);
-	g_free(account_with_transit);
-
-	/* Write MICR serial number */
-	cairo_move_to(cr, front->micr_serial_number_label_x, front->micr_routing_number_label_y);
-	cairo_show_text(cr, "009");
-
-	cairo_restore(cr); /* Restore previous font face and size.*/
+	slip_add_dot(list, cents_dividing_line_x, line_bottom, 0.9, 0);
+
+	/* Write MICR serial number. The routing and account numbers are in SLIP_FIELD_MICR. */
+	slip_add_text(list, SLIP_FONT_MICR, front->micr_font_size, front->micr_serial_number_label_x, front->micr_routing_number_label_y, "009", 0);
 
 	/* Write cash label*/
-	cairo_save(cr); /* New state for smaller font face and size */
-	cairo_select_font_face(cr, data_passer->font_family_sans, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
-	cairo_set_font_size(cr, front->cash_label_font_size);
-	cairo_text_extents(cr, "CASH", &extents);
-	cairo_move_to(cr, front->cash_label_x - extents.width, front->amount_boxes_y + (front->amount_boxes_height / 2) + extents.height / 2);
-	cairo_show_text(cr, "CASH");
-
-	/* Write total from other side.*/
-	cairo_save(cr); /* New state for smaller font size. */
-	cairo_set_font_size(cr, front->checks_other_items_font_size);
-	cairo_text_extents(cr, "TOTAL FROM OTHER SIDE", &extents);
-	cairo_move_to(cr, front->cash_label_x - extents.width, front->amount_boxes_y + (3 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + extents.height / 2);
-	cairo_show_text(cr, "TOTAL FROM OTHER SIDE");
-	cairo_restore(cr); /* Restore previous font size. */
+	font_size = front->cash_label_font_size;
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "CASH", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->cash_label_x - extents.width, front->amount_boxes_y + (front->amount_boxes_height / 2) + extents.height / 2, "CASH", 0);
+
+	/* Write total from other side in a smaller font size.*/
+	slip_text_extents(list, SLIP_FONT_SANS, front->checks_other_items_font_size, "TOTAL FROM OTHER SIDE", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, front->checks_other_items_font_size, front->cash_label_x - extents.width, front->amount_boxes_y + (3 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + extents.height / 2, "TOTAL FROM OTHER SIDE", 0);
 
 	/* Write Subtotal label*/
-	cairo_text_extents(cr, "SUB TOTAL", &extents);
-	cairo_move_to(cr, front->cash_label_x - extents.width, front->amount_boxes_y + (4 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + extents.height / 2);
-	cairo_show_text(cr, "SUB TOTAL");
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "SUB TOTAL", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->cash_label_x - extents.width, front->amount_boxes_y + (4 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + extents.height / 2, "SUB TOTAL", 0);
 
 	/* Write Less Cash Received label*/
-	cairo_text_extents(cr, "LESS CASH", &extents);
-	cairo_move_to(cr, front->cash_label_x - extents.width, front->amount_boxes_y + (5 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) - line_spacer);
-	cairo_show_text(cr, "LESS CASH");
-	cairo_move_to(cr, front->cash_label_x - extents.width, front->amount_boxes_y + (5 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) + line_spacer);
-	cairo_show_text(cr, "RECEIVED");
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "LESS CASH", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->cash_label_x - extents.width, front->amount_boxes_y + (5 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) - line_spacer, "LESS CASH", 0);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->cash_label_x - extents.width, front->amount_boxes_y + (5 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) + line_spacer, "RECEIVED", 0);
 
 	/* Write Net Deposit label*/
-	cairo_text_extents(cr, "DEPOSIT", &extents);
-	cairo_move_to(cr, front->net_deposit_label_x - extents.width, front->amount_boxes_y + (6 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) - line_spacer);
-	cairo_show_text(cr, "NET");
-	cairo_move_to(cr, front->net_deposit_label_x - extents.width, front->amount_boxes_y + (6 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) + line_spacer);
-	cairo_show_text(cr, "DEPOSIT");
+	slip_text_extents(list, SLIP_FONT_SANS, font_size, "DEPOSIT", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->net_deposit_label_x - extents.width, front->amount_boxes_y + (6 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) - line_spacer, "NET", 0);
+	slip_add_text(list, SLIP_FONT_SANS, font_size, front->net_deposit_label_x - extents.width, front->amount_boxes_y + (6 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) + line_spacer, "DEPOSIT", 0);
 
 	/* Write Checks vertically */
-	cairo_set_font_size(cr, 5);
 	gchar checks[7] = "CHECKS";
 	gchar strings[2];
 	for (gint i = 0; i <= 5; i++) {
-		cairo_move_to(cr, front->checks_label_x, front->checks_label_y + (i * front->checks_label_spacing));
 		g_strlcpy(strings, checks + i, 2);
-		cairo_show_text(cr, strings);
+		slip_add_text(list, SLIP_FONT_SANS, 5, front->checks_label_x, front->checks_label_y + (i * front->checks_label_spacing), strings, 0);
 	}
 
 	/* Write triangles */
-	write_triangles(cr, front);
+	write_triangles(list, front);
 
 	/* Write dollar sign */
-	cairo_save(cr); /* New state for large font size. */
-	cairo_set_font_size(cr, 14);
-	cairo_text_extents(cr, "$", &extents);
-	cairo_move_to(cr, 292, front->amount_boxes_y + (6 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) - line_spacer);
-	cairo_show_text(cr, "$");
-	cairo_restore(cr); /* Restore from large font size.*/
+	slip_text_extents(list, SLIP_FONT_SANS, 14, "$", &extents);
+	slip_add_text(list, SLIP_FONT_SANS, 14, 292, front->amount_boxes_y + (6 * front->amount_boxes_height) + (front->amount_boxes_height / 2) + (extents.height / 2) - line_spacer, "$", 0);
+
+	/* Stroke the boxes and lines in a few batches, then reserve the variable parts. */
+	slip_display_list_batch_strokes(list);
+	slip_reserve_field(list, SLIP_FIELD_DATE, 1);
+	slip_reserve_field(list, SLIP_FIELD_NAME, 1);
+	slip_reserve_field(list, SLIP_FIELD_ACCOUNT_NUMBER, SLIP_ACCOUNT_NUMBER_FIELD_OPS);
+	slip_reserve_field(list, SLIP_FIELD_MICR, 2);
+	slip_reserve_field(list, SLIP_FIELD_CHECK_FIRST, SLIP_AMOUNT_FIELD_OPS);
+	slip_reserve_field(list, SLIP_FIELD_CHECK_FIRST + 1, SLIP_AMOUNT_FIELD_OPS);
+	slip_reserve_field(list, SLIP_FIELD_OTHER_SIDE_TOTAL, SLIP_AMOUNT_FIELD_OPS);
+	slip_reserve_field(list, SLIP_FIELD_SUBTOTAL, SLIP_AMOUNT_FIELD_OPS);
+	slip_reserve_field(list, SLIP_FIELD_NET_DEPOSIT, SLIP_AMOUNT_FIELD_OPS);
+}
+
+/**
+ * Writes an amount into one of the rows of amount boxes on the front of the slip.
+ * @param data_passer Pointer to user data.
+ * @param field Field receiving the amount.
+ * @param digits Digits of the amount, as returned by box_digits().
+ * @param row_bottom Number of amount rows above the bottom of the row receiving the amount. For example, the first check is in the second row, so its bottom is at 2.
+ */
+static void write_front_amount(Data_passer* data_passer, Slip_field field, const gchar* digits, gint row_bottom) {
+	Front* front = &data_passer->layout->front;
+	print_amounts_in_boxes(data_passer->slip_front,
+						   field,
+						   digits,
+						   front->account_number_human_font_size,
+						   front->amount_boxes_x + (7 * front->amount_boxes_width + 3),
+						   front->amount_boxes_y + (row_bottom * front->amount_boxes_height) - 3,
+						   front->amount_boxes_width);
+}
+
+/**
+ * Writes an amount into the check listing on the back of the slip. The digits are rotated 90 degrees, and each digit is
+ * centered in its box.
+ * @param data_passer Pointer to user data.
+ * @param field Field receiving the amount.
+ * @param digits Digits of the amount, as returned by box_digits().
+ * @param baseline_x x position of the center of the column (before rotation).
+ * @param subtotal `TRUE` if writing the subtotal, whose digits sit on the listing's right edge instead of being centered in a column.
+ */
+static void write_back_amount(Data_passer* data_passer, Slip_field field, const gchar* digits, gdouble baseline_x, gboolean subtotal) {
+	Back* back = &data_passer->layout->back;
+	Slip_display_list* list = data_passer->slip_back;
+	gint string_length = strlen(digits);
+	gchar digit_string[2];
+	digit_string[1] = '\0';
+	gdouble separator_pitch_y = back->check_listing_height / 7.0;
+	/* The left edge of the right-most number is a function of the following:
+	 * top-left corner of check listing, y position
+	 * border width
+	 * pitch between number separators
+	 * separator width
+	 */
+	gdouble current_y = back->check_listing_top_y + ((back->check_listing_horizontal_border_width + separator_pitch_y - back->check_listing_separator_width) / 2.0);
+	cairo_text_extents_t extents;
+	gint op_index = 0;
+
+	/* In reverse order, place the current character.*/
+	for (gint i = string_length - 1; i >= 0; i--) {
+		Slip_op* op = slip_field_op(list, field, op_index++);
+		if (op == NULL) {
+			return;
+		}
+		digit_string[0] = digits[i];
+		slip_text_extents(list, SLIP_FONT_MONO_BOLD, data_passer->font_size_monospace, digit_string, &extents);
+		gdouble y = subtotal ? baseline_x - (extents.height / 2.0) : baseline_x + (extents.height / 2.0);
+		slip_set_text_op(op, TRUE, SLIP_FONT_MONO_BOLD, data_passer->font_size_monospace, -(current_y + (extents.width / 2.0)), y, digit_string, 0);
+		current_y += separator_pitch_y;
+	}
+	for (Slip_op* op = slip_field_op(list, field, op_index); op != NULL; op = slip_field_op(list, field, ++op_index)) {
+		op->text[0] = '\0';
+	}
+}
+
+/**
+ * Writes the amount of one check into its field, on the front for the first two checks and on the back for the others.
+ * @param data_passer Pointer to user data.
+ * @param row Row of the check in \ref Deposit.checks_store.
+ * @param cents Amount of the check in cents.
+ */
+static void write_check_amount(Data_passer* data_passer, gint row, gint64 cents) {
+	const gchar* digits = box_digits(data_passer->frame_arena, cents, 3);
+
+	if (row < 2) {
+		write_front_amount(data_passer, SLIP_FIELD_CHECK_FIRST + row, digits, row + 2);
+		return;
+	}
+
+	/* The x position of the current number is a function of the following:
+	 * top-left corner of check listing, x position
+	 * border width
+	 * pitch between horizontal borders
+	 * separator width
+	 * current row number
+	 */
+	Back* back = &data_passer->layout->back;
+	gdouble separator_pitch_x = back->check_listing_width / 12.0;
+	gdouble current_x = back->check_listing_top_x + ((back->check_listing_horizontal_border_width + separator_pitch_x - back->check_listing_separator_width) / 2.0) + ((row - 2) * separator_pitch_x);
+	write_back_amount(data_passer, SLIP_FIELD_CHECK_FIRST + row, digits, current_x, FALSE);
+}
+
+/**
+ * Blanks the field of a check that is no longer in the store.
+ * @param data_passer Pointer to user data.
+ * @param row Row of the check.
+ */
+static void clear_check_amount(Data_passer* data_passer, gint row) {
+	Slip_display_list* list = (row < 2) ? data_passer->slip_front : data_passer->slip_back;
+	slip_clear_field(list, SLIP_FIELD_CHECK_FIRST + row);
+}
+
+/**
+ * Rewrites the fields showing the totals from \ref Deposit.totals, which the checks store's signals keep current.
+ * @param data_passer Pointer to user data.
+ */
+static void update_totals(Data_passer* data_passer) {
+	Totals_tracker* totals = data_passer->deposit->totals;
+
+	/* Write subtotal and total of checks deposited */
+	const gchar* digits = box_digits(data_passer->frame_arena, totals->total, 1);
+	write_front_amount(data_passer, SLIP_FIELD_SUBTOTAL, digits, 5);
+	write_front_amount(data_passer, SLIP_FIELD_NET_DEPOSIT, digits, 7);
+
+	/* If we have more than two checks, write the back side's subtotal on both sides. */
+	if (totals->n_rows > 2) {
+		digits = box_digits(data_passer->frame_arena, totals->back_side, 1);
+		write_front_amount(data_passer, SLIP_FIELD_OTHER_SIDE_TOTAL, digits, 4);
+		Back* back = &data_passer->layout->back;
+		write_back_amount(data_passer, SLIP_FIELD_BACK_SUBTOTAL, digits, back->check_listing_top_x + back->check_listing_width, TRUE);
+	} else {
+		slip_clear_field(data_passer->slip_front, SLIP_FIELD_OTHER_SIDE_TOTAL);
+		slip_clear_field(data_passer->slip_back, SLIP_FIELD_BACK_SUBTOTAL);
+	}
+}
+
+/**
+ * Rewrites the fields of one check after it is added or edited, along with the totals. Only the operations in those fields change.
+ * Amounts come from the mirror in \ref Deposit.totals, so this does not read the checks store.
+ * @param data_passer Pointer to user data.
+ * @param row Row of the check in \ref Deposit.checks_store.
+ * \sa deposit_amount_edited()
+ */
+void slip_update_check(Data_passer* data_passer, gint row) {
+	if (data_passer->slip_front == NULL || row < 0 || row >= MAXIMUM_CHECKS) {
+		return;
+	}
+
+	if (row < data_passer->deposit->totals->n_rows) {
+		write_check_amount(data_passer, row, data_passer->deposit->totals->row_cents[row]);
+	} else {
+		clear_check_amount(data_passer, row);
+	}
+	update_totals(data_passer);
+	frame_arena_reset(data_passer->frame_arena);
+}
+
+/**
+ * Rewrites the fields of all checks and the totals, for example after deleting checks shifts the remaining ones to new rows.
+ * @param data_passer Pointer to user data.
+ * \sa delete_check_rows()
+ */
+void slip_update_all_checks(Data_passer* data_passer) {
+	if (data_passer->slip_front == NULL) {
+		return;
+	}
+
+	for (gint row = 0; row < MAXIMUM_CHECKS; row++) {
+		if (row < data_passer->deposit->totals->n_rows) {
+			write_check_amount(data_passer, row, data_passer->deposit->totals->row_cents[row]);
+		} else {
+			clear_check_amount(data_passer, row);
+		}
+	}
+	update_totals(data_passer);
+	frame_arena_reset(data_passer->frame_arena);
+}
+
+/**
+ * Rewrites the date, name, account number, and MICR fields from an account.
+ * @param data_passer Pointer to user data.
+ * @param model Model holding the account.
+ * @param iter Iterator of the account, or `NULL` to clear the account's fields.
+ */
+static void write_account(Data_passer* data_passer, GtkTreeModel* model, GtkTreeIter* iter) {
+	Slip_display_list* list = data_passer->slip_front;
+	Front* front = &data_passer->layout->front;
+
+	/* Strings in the account table, which does not change while the fields are written. */
+	const gchar* routing_number = NULL;
+	const gchar* account_number = NULL;
+	const gchar* account_name = NULL;
+
+	if (iter != NULL) {
+		account_number = account_table_column(data_passer->account_table, model, iter, ACCOUNT_NUMBER);
+		account_name = account_table_column(data_passer->account_table, model, iter, ACCOUNT_NAME);
+		routing_number = account_table_column(data_passer->account_table, model, iter, ROUTING_NUMBER);
+	}
 
 	/* Write date and name values */
-	cairo_save(cr); /* New state for font and size */
-	cairo_select_font_face(cr, data_passer->font_family_mono, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
-	cairo_set_font_size(cr, front->date_name_address_value_font_size);
-	GDateTime* date_time = g_date_time_new_now_local();
-	gchar* date_time_string = g_date_time_format(date_time, "%B %e, %Y");
-	cairo_move_to(cr, front->date_name_value_x, front->date_value_y);
-	cairo_set_font_size(cr, data_passer->font_size_sans_serif);
-	cairo_show_text(cr, date_time_string);
-	g_free(date_time_string);
-
-	cairo_move_to(cr, front->date_name_value_x, front->name_value_y);
-	cairo_show_text(cr, account_name);
-
-	cairo_restore(cr); /* Restore default font size*/
-
-	/* Print account number in boxes */
-	print_amounts_in_boxes(cr, account_number,
-						   data_passer->font_family_mono,
+	slip_set_text_op(slip_field_op(list, SLIP_FIELD_DATE, 0), FALSE, SLIP_FONT_MONO_BOLD, data_passer->font_size_sans_serif,
+					 front->date_name_value_x, front->date_value_y, formatted_date(data_passer->frame_arena), 0);
+	slip_set_text_op(slip_field_op(list, SLIP_FIELD_NAME, 0), FALSE, SLIP_FONT_MONO_BOLD, data_passer->font_size_sans_serif,
+					 front->date_name_value_x, front->name_value_y, account_name, 0);
+
+	/* Write account number in boxes */
+	print_amounts_in_boxes(list, SLIP_FIELD_ACCOUNT_NUMBER, account_number,
 						   front->account_number_human_font_size,
 						   front->account_number_squares_x + (9.3 * front->account_number_squares_width),
 						   front->account_number_squares_y + front->account_number_squares_height - 3,
 						   front->account_number_squares_width);
 
-	data_passer->total_deposit = 0;
-
-	/* Write amount of first two checks on front side. */
-	gtk_tree_model_foreach(GTK_TREE_MODEL(data_passer->checks_store), print_deposit_amounts_front, data_passer);
-
-	/* Accumulate a subtotal of checks on the back side. */
-	data_passer->total_back_side = 0.0;
-	gtk_tree_model_foreach(GTK_TREE_MODEL(data_passer->checks_store), subtotal_back_side, data_passer);
-	/* Add total from back side (which could be zero) to the total deposit. */
-	data_passer->total_deposit += data_passer->total_back_side;
-
-	/* Internal representation of a total deposit may not be accurate to two decimal places,
-		it may actually be much larger. For example, 8992.02 may be represented as
-		8992.01953. Because g_snprintf below converts a float to a decimal by truncation,
-		we need to round up the hundredths place if necessary. */
-	float step1 = data_passer->total_deposit * 100.0;
-	int mantissa = trunc(step1);
-	float decimal = step1 - mantissa;
-	if (decimal >= 0.5) {
-		data_passer->total_deposit += 0.01;
-	}
-
-	/* Write subtotal of checks deposited */
-	gchar formatted_amount[10];
-
-	g_snprintf(formatted_amount, 11, "%d", (guint)(data_passer->total_deposit * 100));
-	print_amounts_in_boxes(cr,
-						   formatted_amount,
-						   data_passer->font_family_mono,
-						   data_passer->front->account_number_human_font_size,
-						   data_passer->front->amount_boxes_x + (7 * data_passer->front->amount_boxes_width + 3),
-						   data_passer->front->amount_boxes_y + (5 * data_passer->front->amount_boxes_height) - 3,
-						   data_passer->front->amount_boxes_width);
-
-	/* Write total of checks deposited */
-	print_amounts_in_boxes(cr,
-						   formatted_amount,
-						   data_passer->font_family_mono,
-						   data_passer->front->account_number_human_font_size,
-						   data_passer->front->amount_boxes_x + (7 * data_passer->front->amount_boxes_width + 3),
-						   data_passer->front->amount_boxes_y + (7 * data_passer->front->amount_boxes_height) - 3,
-						   data_passer->front->amount_boxes_width);
-
-	/* If we have more than three checks:
-	 * Print the back side's subtotal on the front side.
-	 * Output the front side.
-	 * Print the back side. */
-	if (number_of_checks(data_passer) > 2) {
-		g_snprintf(formatted_amount, 11, "%d", (guint)(data_passer->total_back_side * 100));
-		print_amounts_in_boxes(cr,
-							   formatted_amount,
-							   data_passer->font_family_mono,
-							   data_passer->front->account_number_human_font_size,
-
-							   data_passer->front->amount_boxes_x + (7 * 		data_passer->front->amount_boxes_width + 3),
-
-							   data_passer->front->amount_boxes_y + (4 * data_passer->front->amount_boxes_height) - 3,
-
-							   data_passer->front->amount_boxes_width);
+	/* Write MICR routing and account numbers */
+	if (account_number != NULL) {
+		gchar* routing_with_transit = frame_arena_strconcat(data_passer->frame_arena, MICR_TRANSIT, routing_number, MICR_TRANSIT, NULL);
+		slip_set_text_op(slip_field_op(list, SLIP_FIELD_MICR, 0), FALSE, SLIP_FONT_MICR, front->micr_font_size,
+						 front->micr_routing_number_label_x, front->micr_routing_number_label_y, routing_with_transit, 0);
+		gchar* account_with_transit = frame_arena_strconcat(data_passer->frame_arena, account_number, MICR_ON_US, NULL);
+		slip_set_text_op(slip_field_op(list, SLIP_FIELD_MICR, 1), FALSE, SLIP_FONT_MICR, front->micr_font_size,
+						 front->micr_account_number_label_x, front->micr_routing_number_label_y, account_with_transit, 0);
+	} else {
+		slip_clear_field(list, SLIP_FIELD_MICR);
+	}
+
+	frame_arena_reset(data_passer->frame_arena);
+}
 
+/**
+ * Rewrites the date, name, account number, and MICR fields from the account selected in the Slip tab.
+ * @param data_passer Pointer to user data.
+ */
+void slip_update_account(Data_passer* data_passer) {
+	GtkTreeIter iter;
+	GtkTreeModel* model;
+
+	if (data_passer->slip_front == NULL) {
+		return;
+	}
+
+	/* Retrieve the currently selected account. */
+	GtkTreeSelection* tree_selection = gtk_tree_view_get_selection(GTK_TREE_VIEW(data_passer->checks_accounts_treeview));
+	gboolean selected = gtk_tree_selection_get_selected(tree_selection, &model, &iter);
+	write_account(data_passer, model, selected ? &iter : NULL);
+}
+
+/**
+ * Compiles both sides of the deposit slip from the layout in \ref Data_passer.layout, then fills in the
+ * current account and checks. Called once the configuration is read and the Slip tab is built. Text is measured through the cache
+ * in text_metrics.c, which is emptied here, so later updates of the variable fields do not measure the same digits again.
+ * @param data_passer Pointer to user data.
+ */
+void slip_compile(Data_passer* data_passer) {
+	/* Fonts or layout may have changed since the last compile. */
+	text_metrics_clear();
+
+	if (data_passer->slip_front == NULL) {
+		data_passer->slip_front = slip_display_list_new();
+		data_passer->slip_back = slip_display_list_new();
+	}
+	slip_display_list_clear(data_passer->slip_front);
+	slip_display_list_clear(data_passer->slip_back);
+	slip_display_list_set_fonts(data_passer->slip_front, data_passer);
+	slip_display_list_set_fonts(data_passer->slip_back, data_passer);
+
+	print_deposit_slip_front_static(data_passer->slip_front, data_passer);
+	print_deposit_slip_back_static(data_passer->slip_back, data_passer);
+
+	slip_update_account(data_passer);
+	slip_update_all_checks(data_passer);
+}
+
+/**
+ * Callback fired when the selection in the accounts listing of the Slip tab changes. Switches to the account's deposit and schedules its account fields and checks to be rewritten.
+ * @param tree_selection Selection that changed.
+ * @param data Pointer to user data.
+ */
+void slip_account_changed(GtkTreeSelection* tree_selection, gpointer data) {
+	Data_passer* data_passer = (Data_passer*)data;
+
+	deposit_session_select(data_passer);
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_ACCOUNT, REDRAW_SOURCE_APP);
+}
+
+/** Width of a letter-size page in points, the page exported slips are laid out on. */
+#define PAGE_WIDTH 612
+
+/** Height of a letter-size page in points. */
+#define PAGE_HEIGHT 792
+
+/**
+ * Draws the slip on printed pages: the front and, if requested, the back on a second page.
+ * @param data_passer Pointer to user data.
+ * @param cr Cairo context of a page.
+ * @param with_back `TRUE` to draw the back of the slip on a second page.
+ * @param page_width Width of the page in points.
+ */
+void draw_slip_pages(Data_passer* data_passer, cairo_t* cr, gboolean with_back, gdouble page_width) {
+	cairo_save(cr);
+	/*
+		Translate the surface so that the deposit slip appears in the top middle of the printed page.
+		On letter paper, 8.5 * 72 = 612 points wide, the 432-point slip has a margin of 90 on each side.
+	 */
+	cairo_translate(cr, (page_width - SLIP_WIDTH) / 2, 10);
+
+	slip_display_list_replay(data_passer->slip_front, cr);
+	if (with_back) {
 		cairo_show_page(cr);
-		print_deposit_slip_back_static(cr, data_passer);
-		gtk_tree_model_foreach(GTK_TREE_MODEL(data_passer->checks_store), print_deposit_amounts_back, data_passer);
+		slip_display_list_replay(data_passer->slip_back, cr);
+	}
+	cairo_restore(cr);
+}
+
+/**
+ * Appends the output of a PDF surface to a byte array.
+ * @param closure The byte array.
+ * @param data Output of the surface.
+ * @param length Number of bytes of output.
+ * @return `CAIRO_STATUS_SUCCESS`.
+ */
+static cairo_status_t append_pdf_output(void* closure, const unsigned char* data, unsigned int length) {
+	g_byte_array_append((GByteArray*)closure, data, length);
+	return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Renders the slip to PDF, laid out on the page as it is printed.
+ * @param data_passer Pointer to user data.
+ * @param with_back `TRUE` to render the back of the slip on a second page.
+ * @param page_width Width of the page in points.
+ * @param page_height Height of the page in points.
+ * @return The PDF. Free with `g_bytes_unref()`.
+ */
+static GBytes* render_slip_pdf(Data_passer* data_passer, gboolean with_back, gdouble page_width, gdouble page_height) {
+	GByteArray* output = g_byte_array_new();
+	cairo_surface_t* surface = cairo_pdf_surface_create_for_stream(append_pdf_output, output, page_width, page_height);
+	cairo_t* cr = cairo_create(surface);
+
+	draw_slip_pages(data_passer, cr, with_back, page_width);
+	cairo_destroy(cr);
+	cairo_surface_finish(surface);
+	cairo_surface_destroy(surface);
+	return g_byte_array_free_to_bytes(output);
+}
+
+/**
+ * Returns the path of the slip rendered to PDF in the render cache. A slip not in the cache is rendered and stored first. Call
+ * this with the layout held, so the file matches the display lists. The file stays in place until something else is stored in
+ * the cache, so open it before then.
+ * @param data_passer Pointer to user data.
+ * @param with_back `TRUE` if the back of the slip is printed.
+ * @param page_width Width of the page in points.
+ * @param page_height Height of the page in points.
+ * @return Path of the cached file, or `NULL` if the PDF could not be stored. Free with `g_free()`.
+ */
+static gchar* cached_slip_path(Data_passer* data_passer, gboolean with_back, gdouble page_width, gdouble page_height) {
+	gchar* key = render_cache_key(data_passer->slip_front, with_back ? data_passer->slip_back : NULL, page_width, page_height);
+	gchar* path = render_cache_lookup_path(data_passer->render_cache, key);
+
+	if (path == NULL) {
+		GBytes* pdf = render_slip_pdf(data_passer, with_back, page_width, page_height);
+		if (render_cache_store(data_passer->render_cache, key, pdf)) {
+			path = render_cache_lookup_path(data_passer->render_cache, key);
+		}
+		g_bytes_unref(pdf);
+	}
+	g_free(key);
+	return path;
+}
+
+/**
+ * Shows the print dialog.
+ * @param data_passer Pointer to user data.
+ * @param title Title of the dialog.
+ * @return The dialog if the user chose to print, with the printer and settings chosen, or `NULL` if the user cancelled. Destroy
+ * with `gtk_widget_destroy()`.
+ */
+static GtkPrintUnixDialog* run_print_dialog(Data_passer* data_passer, const gchar* title) {
+	GtkWidget* dialog = gtk_print_unix_dialog_new(title, GTK_WINDOW(data_passer->application_window));
+
+	if (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_OK) {
+		gtk_widget_destroy(dialog);
+		return NULL;
+	}
+	return GTK_PRINT_UNIX_DIALOG(dialog);
+}
+
+/**
+ * Callback fired when a print job has been handed to the printer, or has failed.
+ * @param job The print job.
+ * @param data Unused.
+ * @param error The error if the job failed, otherwise `NULL`.
+ */
+static void print_job_finished(GtkPrintJob* job, gpointer data, const GError* error) {
+	if (error != NULL) {
+		g_print("Error: %s\n", error->message);
+	}
+	g_object_unref(job);
+}
+
+/**
+ * Prints the slip in the display lists as its own print job, on the printer chosen in a print dialog. If the printer takes PDF,
+ * the job sends the slip's file in the render cache, rendering and storing it first at the dialog's paper size if the slip is not
+ * cached. Otherwise the display lists are replayed onto the job's surface. Call this with the layout held.
+ * @param dialog Print dialog the user accepted.
+ * @param data_passer Pointer to user data.
+ * @param title Title of the job.
+ * @param with_back `TRUE` to print the back of the slip on a second page.
+ * @return `TRUE` if the job was sent.
+ */
+static gboolean send_slip(GtkPrintUnixDialog* dialog, Data_passer* data_passer, const gchar* title, gboolean with_back) {
+	GtkPrinter* printer = gtk_print_unix_dialog_get_selected_printer(dialog);
+	GtkPrintSettings* settings = gtk_print_unix_dialog_get_settings(dialog);
+	GtkPageSetup* page_setup = gtk_print_unix_dialog_get_page_setup(dialog);
+	GtkPrintJob* job = gtk_print_job_new(title, printer, settings, page_setup);
+	GError* error = NULL;
+	g_object_unref(settings); /* The print job holds its own reference. */
+
+	/* The paper size takes the orientation into account. The key includes it, so a slip printed on A4 is not sent as letter. */
+	gdouble page_width = gtk_page_setup_get_paper_width(page_setup, GTK_UNIT_POINTS);
+	gdouble page_height = gtk_page_setup_get_paper_height(page_setup, GTK_UNIT_POINTS);
+	/* The job opens the file here, so evicting it from the cache later does not affect the job. */
+	gchar* path = gtk_printer_accepts_pdf(printer) ? cached_slip_path(data_passer, with_back, page_width, page_height) : NULL;
+	gboolean from_cache = (path != NULL) && gtk_print_job_set_source_file(job, path, &error);
+	g_free(path);
+	if (error != NULL) {
+		g_print("Error: %s\n", error->message);
+		g_clear_error(&error);
 	}
+
+	if (!from_cache) {
+		cairo_surface_t* surface = gtk_print_job_get_surface(job, &error);
+		if (surface == NULL) {
+			g_print("Error: %s\n", error->message);
+			g_error_free(error);
+			g_object_unref(job);
+			return FALSE;
+		}
+		cairo_t* cr = cairo_create(surface);
+		draw_slip_pages(data_passer, cr, with_back, page_width);
+		cairo_destroy(cr);
+		cairo_surface_finish(surface);
+	}
+
+	gtk_print_job_send(job, print_job_finished, NULL, NULL);
+	return TRUE;
 }
 
 /**
- * Callback fired when user clicks the print button. This function instantiates a GTK Print Operation, applies settings, and associates a callback draw_page().
+ * Callback fired when user clicks the print button. Shows the print dialog and prints the slip, sending the slip's PDF from the
+ * render cache when it is there. See send_slip().
  * @param self Pointer to the clicked button.
  * @param data Pointer to user data.
  */
 void print_deposit_slip(GtkButton* self, gpointer data) {
 	Data_passer* data_passer = (Data_passer*)data;
-	GtkPrintOperation* operation;
-	GError* error;
-	gint res;
-
-	operation = gtk_print_operation_new();
-
-	gtk_print_operation_set_unit(operation, GTK_UNIT_POINTS);
-	gtk_print_operation_set_use_full_page(operation, TRUE);
-	gtk_print_operation_set_n_pages(operation, 1);
-
-	GtkPrintSettings* settings = gtk_print_settings_new();
-
-	gtk_print_operation_set_print_settings(operation, settings);
-
-	g_signal_connect(G_OBJECT(operation), "draw_page", G_CALLBACK(draw_page), data_passer);
-
-	res = gtk_print_operation_run(operation, GTK_PRINT_OPERATION_ACTION_PRINT_DIALOG, GTK_WINDOW(data_passer->application_window), &error);
-	switch (res) {
-		case GTK_PRINT_OPERATION_RESULT_ERROR:
-			g_print("Error\n");
-			break;
-		case GTK_PRINT_OPERATION_RESULT_APPLY:
-			if (settings != NULL)
-				g_object_unref(settings);
-			settings = g_object_ref(gtk_print_operation_get_print_settings(operation));
-			break;
-		case GTK_PRINT_OPERATION_RESULT_CANCEL:
-			g_print("Cancel\n");
-			break;
-		case GTK_PRINT_OPERATION_RESULT_IN_PROGRESS:
-			g_print("In progress\n");
-			break;
-		default:
-	}
-	g_object_unref(operation);
+
+	GtkPrintUnixDialog* dialog = run_print_dialog(data_passer, "Print Deposit Slip");
+	if (dialog == NULL) {
+		g_print("Cancel\n");
+		return;
+	}
+
+	/* Print the slip as it is now, including edits not yet applied to the display lists. Refresh the date in case the application has been open since yesterday. */
+	slip_redraw_flush(data_passer);
+	slip_update_account(data_passer);
+	/* Keep the layout from being reloaded until the slip has been rendered. */
+	Slip_layout* layout = slip_layout_hold(data_passer);
+	if (send_slip(dialog, data_passer, "Deposit slip", number_of_checks(data_passer) > 2)) {
+		history_record_deposit(data_passer, data_passer->deposit);
+	}
+	slip_layout_release(data_passer, layout);
+	gtk_widget_destroy(GTK_WIDGET(dialog));
+}
+
+/**
+ * Callback fired when user clicks the export button. Asks for a file name and saves the slip there as PDF on a letter-size page,
+ * copying it from the render cache if the slip has not changed since it was last printed on letter paper or exported.
+ * @param self Pointer to the clicked button.
+ * @param data Pointer to user data.
+ */
+void export_deposit_slip(GtkButton* self, gpointer data) {
+	Data_passer* data_passer = (Data_passer*)data;
+
+	GtkWidget* dialog = gtk_file_chooser_dialog_new("Export Deposit Slip",
+													GTK_WINDOW(data_passer->application_window),
+													GTK_FILE_CHOOSER_ACTION_SAVE,
+													"_Cancel", GTK_RESPONSE_CANCEL,
+													"_Export", GTK_RESPONSE_ACCEPT,
+													NULL);
+	gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(dialog), TRUE);
+	gtk_file_chooser_set_current_name(GTK_FILE_CHOOSER(dialog), "deposit_slip.pdf");
+
+	if (gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT) {
+		gchar* path = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+		gboolean with_back = number_of_checks(data_passer) > 2;
+
+		/* Apply pending edits, and refresh the date as printing does, so the key matches what would be printed today. */
+		slip_redraw_flush(data_passer);
+		slip_update_account(data_passer);
+		Slip_layout* layout = slip_layout_hold(data_passer);
+		gchar* cached_path = cached_slip_path(data_passer, with_back, PAGE_WIDTH, PAGE_HEIGHT);
+		gchar* contents = NULL;
+		gsize length = 0;
+		/* A slip too large for the cache is rendered without being stored. */
+		if (cached_path == NULL || !g_file_get_contents(cached_path, &contents, &length, NULL)) {
+			GBytes* pdf = render_slip_pdf(data_passer, with_back, PAGE_WIDTH, PAGE_HEIGHT);
+			contents = g_bytes_unref_to_data(pdf, &length);
+		}
+		slip_layout_release(data_passer, layout);
+
+		GError* error = NULL;
+		if (!g_file_set_contents(path, contents, length, &error)) {
+			g_print("Unable to write `%s': %s\n", path, error->message);
+			g_error_free(error);
+		}
+		g_free(contents);
+		g_free(cached_path);
+		g_free(path);
+	}
+	gtk_widget_destroy(dialog);
+}
+
+/**
+ * Writes a deposit's account and checks into the display lists and makes it the current deposit.
+ * @param data_passer Pointer to user data.
+ * @param deposit The deposit.
+ */
+static void write_deposit(Data_passer* data_passer, Deposit* deposit) {
+	data_passer->deposit = deposit;
+	GtkTreePath* path = gtk_tree_row_reference_get_path(deposit->account);
+	GtkTreeModel* model = gtk_tree_row_reference_get_model(deposit->account);
+	GtkTreeIter iter;
+	gboolean found = (path != NULL) && gtk_tree_model_get_iter(model, &iter, path);
+	write_account(data_passer, model, found ? &iter : NULL);
+	gtk_tree_path_free(path);
+	slip_update_all_checks(data_passer);
+}
+
+/**
+ * Callback fired when user clicks the Print All button. Prints the deposit slips of every account whose checks were entered or loaded during the session, in the order
+ * their deposits were started. Deposits created only by selecting an account still hold the default check and are skipped, so they are neither printed nor recorded in
+ * the history.
+ * Each slip is its own print job, so a slip in the render cache is sent as the stored file. Each slip takes one page for the front and, if it has more than two checks,
+ * one page for the back.
+ * @param self Pointer to the clicked button.
+ * @param data Pointer to user data.
+ */
+void print_all_deposit_slips(GtkButton* self, gpointer data) {
+	Data_passer* data_passer = (Data_passer*)data;
+	GPtrArray* deposits = data_passer->session->deposits;
+	GPtrArray* printable = g_ptr_array_new();
+
+	for (guint i = 0; i < deposits->len; i++) {
+		Deposit* deposit = g_ptr_array_index(deposits, i);
+		/* The deposit started before any account was selected has no account to print. */
+		if (deposit->modified && deposit->account != NULL && gtk_tree_row_reference_valid(deposit->account)) {
+			g_ptr_array_add(printable, deposit);
+		}
+	}
+	if (printable->len == 0) {
+		g_ptr_array_unref(printable);
+		return;
+	}
+
+	GtkPrintUnixDialog* dialog = run_print_dialog(data_passer, "Print All Deposit Slips");
+	if (dialog == NULL) {
+		g_ptr_array_unref(printable);
+		return;
+	}
+
+	/* Apply pending edits now, so the flush does not run between slips and rewrite them. */
+	slip_redraw_flush(data_passer);
+	Deposit* current = data_passer->deposit;
+	/* Keep the layout from being reloaded between slips. */
+	Slip_layout* layout = slip_layout_hold(data_passer);
+	for (guint i = 0; i < printable->len; i++) {
+		Deposit* deposit = g_ptr_array_index(printable, i);
+		gchar title[64];
+		g_snprintf(title, sizeof(title), "Deposit slip %u of %u", i + 1, printable->len);
+
+		write_deposit(data_passer, deposit);
+		if (send_slip(dialog, data_passer, title, deposit->totals->n_rows > 2)) {
+			history_record_deposit(data_passer, deposit);
+		}
+	}
+	gtk_widget_destroy(GTK_WIDGET(dialog));
+	g_ptr_array_unref(printable);
+
+	/* Put the current deposit back in the display lists, then apply any layout read during the job. */
+	data_passer->deposit = current;
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_ACCOUNT | SLIP_DIRTY_ALL_CHECKS, REDRAW_SOURCE_APP);
+	slip_layout_release(data_passer, layout);
 }
@@ -0,0 +1,124 @@
+#include <gtk/gtk.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file redraw_scheduler.c
+ * @brief Collects changes to the slip and applies them once per main loop iteration.
+ *
+ * Callbacks that change what the slip shows mark the affected fields dirty in \ref Data_passer.redraw instead of rewriting the
+ * display lists and redrawing the preview themselves. The first change schedules an idle source that runs after every pending
+ * input event has been handled and before GTK paints, so an operator tabbing through amounts, or a deposit loading many rows,
+ * costs one rewrite of the dirty fields and one render. Code that replays the display lists, such as printing, calls
+ * slip_redraw_flush() first so it sees every change made so far.
+ */
+
+/** Priority of the flush: after input events, before GTK lays out and paints at `GDK_PRIORITY_REDRAW`. */
+#define REDRAW_PRIORITY (G_PRIORITY_HIGH_IDLE + 10)
+
+/**
+ * Idle callback that applies the collected changes.
+ * @param data Pointer to user data.
+ * @return `G_SOURCE_REMOVE`; the next change schedules a new source.
+ */
+static gboolean flush_idle(gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+
+	data_passer->redraw.idle_id = 0;
+	slip_redraw_flush(data_passer);
+	return G_SOURCE_REMOVE;
+}
+
+/**
+ * Marks parts of the slip dirty and schedules a flush if none is pending.
+ * @param data_passer Pointer to user data.
+ * @param dirty Combination of \ref Slip_dirty flags.
+ * @param source What changed the slip, counted by the timing overlay in frame_stats.c.
+ */
+void slip_redraw_schedule(Data_passer *data_passer, guint dirty, Redraw_source source) {
+	Slip_redraw *redraw = &data_passer->redraw;
+
+	if (data_passer->frame_stats != NULL) {
+		frame_stats_note_source(data_passer->frame_stats, source);
+	}
+	redraw->dirty |= dirty;
+	if (redraw->idle_id == 0) {
+		redraw->idle_id = g_idle_add_full(REDRAW_PRIORITY, flush_idle, data_passer, NULL);
+	}
+}
+
+/**
+ * Marks one check's fields dirty, along with the totals, and schedules a flush if none is pending.
+ * @param data_passer Pointer to user data.
+ * @param row Row of the check in \ref Deposit.checks_store.
+ * @param source What changed the check.
+ */
+void slip_redraw_schedule_check(Data_passer *data_passer, gint row, Redraw_source source) {
+	if (row >= 0 && row < MAXIMUM_CHECKS) {
+		data_passer->redraw.dirty_checks |= 1u << row;
+	}
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_PREVIEW, source);
+}
+
+/**
+ * Applies the collected changes now: rewrites the dirty fields of the display lists and hands the result to the preview
+ * renderer. If only the side shown changed, the preview shows the image of the other side rendered ahead of time, if there is
+ * one. Does nothing if nothing is dirty.
+ * @param data_passer Pointer to user data.
+ */
+void slip_redraw_flush(Data_passer *data_passer) {
+	Slip_redraw *redraw = &data_passer->redraw;
+
+	if (redraw->idle_id != 0) {
+		g_source_remove(redraw->idle_id);
+		redraw->idle_id = 0;
+	}
+	if (redraw->dirty == 0) {
+		return;
+	}
+
+	/* Clear first, so the updates below may schedule again without losing anything. */
+	guint dirty = redraw->dirty;
+	guint32 dirty_checks = redraw->dirty_checks;
+	redraw->dirty = 0;
+	redraw->dirty_checks = 0;
+
+	if (dirty == SLIP_DIRTY_SIDE) {
+		if (!preview_renderer_flip(data_passer)) {
+			preview_renderer_invalidate(data_passer);
+		}
+		return;
+	}
+
+	/* The slip changed, so the image of the side not shown is out of date. */
+	if (data_passer->preview_renderer != NULL) {
+		preview_renderer_discard_hidden(data_passer->preview_renderer);
+	}
+	if (dirty & SLIP_DIRTY_ACCOUNT) {
+		slip_update_account(data_passer);
+	}
+	if (dirty & SLIP_DIRTY_ALL_CHECKS) {
+		slip_update_all_checks(data_passer);
+	} else {
+		for (gint row = 0; dirty_checks != 0; row++, dirty_checks >>= 1) {
+			if (dirty_checks & 1) {
+				slip_update_check(data_passer, row);
+			}
+		}
+	}
+	preview_renderer_invalidate(data_passer);
+}
+
+/**
+ * Drops the pending flush without applying it. Called from free_memory().
+ * @param data_passer Pointer to user data.
+ */
+void slip_redraw_cancel(Data_passer *data_passer) {
+	if (data_passer->redraw.idle_id != 0) {
+		g_source_remove(data_passer->redraw.idle_id);
+	}
+	data_passer->redraw.idle_id = 0;
+	data_passer->redraw.dirty = 0;
+	data_passer->redraw.dirty_checks = 0;
+}
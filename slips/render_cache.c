@@ -0,0 +1,233 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file render_cache.c
+ * @brief Keeps rendered deposit slips on disk, keyed by what they draw.
+ *
+ * A rendered slip is stored in a file named after the SHA-256 of the display lists it was rendered from and the size of the paper.
+ * The display lists hold everything that ends up on the page (the layout, the account fields, the amounts, and the date), so two
+ * slips with the same key are the same page, and printing or exporting a slip that has not changed sends or copies the stored
+ * file instead of rendering again.
+ *
+ * The cache is bounded by the total size of its files. When a new file would exceed the bound, the least recently used files are
+ * removed first. A file's modification time records when it was last used, so the order survives restarting the application.
+ */
+
+/** Extension of cached files. */
+#define RENDER_CACHE_EXTENSION ".pdf"
+
+/** Bumped when the way slips are rendered changes, so files rendered the old way are no longer found. */
+#define RENDER_CACHE_FORMAT "pdf-2"
+
+/**
+ * One file in the cache.
+ */
+typedef struct Render_cache_entry {
+	gsize size; /**< Size of the file in bytes. */
+	gint64 last_used; /**< When the file was last stored or read, in microseconds since the epoch. */
+} Render_cache_entry;
+
+/**
+ * Returns the path of the file holding a key's output.
+ * @param cache Pointer to the cache.
+ * @param key The key.
+ * @return The path. Free with `g_free()`.
+ */
+static gchar *entry_path(const Render_cache *cache, const gchar *key) {
+	gchar *name = g_strconcat(key, RENDER_CACHE_EXTENSION, NULL);
+	gchar *path = g_build_filename(cache->directory, name, NULL);
+	g_free(name);
+	return path;
+}
+
+/**
+ * Removes the least recently used file from the cache.
+ * @param cache Pointer to the cache.
+ */
+static void evict_oldest(Render_cache *cache) {
+	GHashTableIter iter;
+	gpointer key, value;
+	const gchar *oldest_key = NULL;
+	Render_cache_entry *oldest = NULL;
+
+	g_hash_table_iter_init(&iter, cache->entries);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		Render_cache_entry *entry = (Render_cache_entry *)value;
+		if (oldest == NULL || entry->last_used < oldest->last_used) {
+			oldest_key = (const gchar *)key;
+			oldest = entry;
+		}
+	}
+	if (oldest == NULL) {
+		return;
+	}
+
+	gchar *path = entry_path(cache, oldest_key);
+	g_unlink(path);
+	g_free(path);
+	cache->total_bytes -= oldest->size;
+	g_hash_table_remove(cache->entries, oldest_key);
+}
+
+/**
+ * Opens the cache in a directory, creating the directory if needed, and lists the files already in it.
+ * @param directory Path of the directory.
+ * @param maximum_bytes Largest total size of the cached files.
+ * @return Pointer to the cache. Free with render_cache_close().
+ */
+Render_cache *render_cache_open(const gchar *directory, gsize maximum_bytes) {
+	Render_cache *cache = g_new0(Render_cache, 1);
+	cache->directory = g_strdup(directory);
+	cache->maximum_bytes = maximum_bytes;
+	cache->entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+
+	g_mkdir_with_parents(directory, 0700);
+	GDir *dir = g_dir_open(directory, 0, NULL);
+	if (dir == NULL) {
+		return cache;
+	}
+
+	const gchar *name;
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		if (!g_str_has_suffix(name, RENDER_CACHE_EXTENSION)) {
+			continue;
+		}
+		gchar *path = g_build_filename(directory, name, NULL);
+		GStatBuf file_stat;
+		if (g_stat(path, &file_stat) == 0) {
+			Render_cache_entry *entry = g_new(Render_cache_entry, 1);
+			entry->size = file_stat.st_size;
+			entry->last_used = (gint64)file_stat.st_mtime * G_USEC_PER_SEC;
+			g_hash_table_insert(cache->entries, g_strndup(name, strlen(name) - strlen(RENDER_CACHE_EXTENSION)), entry);
+			cache->total_bytes += entry->size;
+		}
+		g_free(path);
+	}
+	g_dir_close(dir);
+
+	/* The bound may have been lowered since the files were stored. */
+	while (cache->total_bytes > cache->maximum_bytes && g_hash_table_size(cache->entries) > 0) {
+		evict_oldest(cache);
+	}
+	return cache;
+}
+
+/**
+ * Computes the key of a slip from the display lists it is rendered from and the paper it is rendered on.
+ * @param front Display list of the front of the slip.
+ * @param back Display list of the back of the slip, or `NULL` if the back is not rendered.
+ * @param page_width Width of the paper in points.
+ * @param page_height Height of the paper in points.
+ * @return The key, as hexadecimal digits. Free with `g_free()`.
+ */
+gchar *render_cache_key(const Slip_display_list *front, const Slip_display_list *back, gdouble page_width, gdouble page_height) {
+	GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	guchar pages = (back != NULL) ? 2 : 1;
+	/* Hundredths of a point, so paper sizes converted from millimetres hash the same each time. */
+	gint32 page_size[2] = {(gint32)(page_width * 100 + 0.5), (gint32)(page_height * 100 + 0.5)};
+
+	g_checksum_update(checksum, (const guchar *)RENDER_CACHE_FORMAT, strlen(RENDER_CACHE_FORMAT));
+	g_checksum_update(checksum, &pages, 1);
+	g_checksum_update(checksum, (const guchar *)page_size, sizeof(page_size));
+	slip_display_list_checksum(front, checksum);
+	if (back != NULL) {
+		slip_display_list_checksum(back, checksum);
+	}
+
+	gchar *key = g_strdup(g_checksum_get_string(checksum));
+	g_checksum_free(checksum);
+	return key;
+}
+
+/**
+ * Forgets a key whose file is gone, such as one removed behind the cache's back.
+ * @param cache Pointer to the cache.
+ * @param key The key.
+ */
+static void forget_entry(Render_cache *cache, const gchar *key) {
+	Render_cache_entry *entry = g_hash_table_lookup(cache->entries, key);
+	if (entry != NULL) {
+		cache->total_bytes -= entry->size;
+		g_hash_table_remove(cache->entries, key);
+	}
+}
+
+/**
+ * Finds the file holding a key's output and marks it as recently used. The file stays in place until a later
+ * render_cache_store() evicts it, so open it before storing anything else.
+ * @param cache Pointer to the cache.
+ * @param key The key, from render_cache_key().
+ * @return Path of the file, or `NULL` if the key is not in the cache. Free with `g_free()`.
+ */
+gchar *render_cache_lookup_path(Render_cache *cache, const gchar *key) {
+	Render_cache_entry *entry = g_hash_table_lookup(cache->entries, key);
+	if (entry == NULL) {
+		return NULL;
+	}
+
+	gchar *path = entry_path(cache, key);
+	if (!g_file_test(path, G_FILE_TEST_IS_REGULAR)) {
+		forget_entry(cache, key);
+		g_free(path);
+		return NULL;
+	}
+	entry->last_used = g_get_real_time();
+	g_utime(path, NULL);
+	return path;
+}
+
+/**
+ * Stores a key's output in the cache, removing the least recently used files to stay within the cache's bound. Output larger
+ * than the bound is not stored.
+ * @param cache Pointer to the cache.
+ * @param key The key, from render_cache_key().
+ * @param output The rendered output.
+ * @return `TRUE` if the output was stored.
+ */
+gboolean render_cache_store(Render_cache *cache, const gchar *key, GBytes *output) {
+	gsize length;
+	gconstpointer contents = g_bytes_get_data(output, &length);
+
+	if (length > cache->maximum_bytes) {
+		return FALSE;
+	}
+	Render_cache_entry *entry = g_hash_table_lookup(cache->entries, key);
+	if (entry != NULL) {
+		cache->total_bytes -= entry->size;
+		g_hash_table_remove(cache->entries, key);
+	}
+	while (cache->total_bytes + length > cache->maximum_bytes && g_hash_table_size(cache->entries) > 0) {
+		evict_oldest(cache);
+	}
+
+	GError *error = NULL;
+	gchar *path = entry_path(cache, key);
+	gboolean written = g_file_set_contents(path, contents, length, &error);
+	if (written) {
+		entry = g_new(Render_cache_entry, 1);
+		entry->size = length;
+		entry->last_used = g_get_real_time();
+		g_hash_table_insert(cache->entries, g_strdup(key), entry);
+		cache->total_bytes += length;
+	} else {
+		g_print("Unable to write `%s': %s\n", path, error->message);
+		g_error_free(error);
+	}
+	g_free(path);
+	return written;
+}
+
+/**
+ * Frees the cache. The cached files stay on disk for the next session.
+ * @param cache Pointer to the cache.
+ */
+void render_cache_close(Render_cache *cache) {
+	g_hash_table_unref(cache->entries);
+	g_free(cache->directory);
+	g_free(cache);
+}
@@ -0,0 +1,244 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file selection_set.c
+ * @brief Keeps track of the rows whose Delete checkbox is marked, from the store's signals.
+ *
+ * The set mirrors a store's checkbox column as one bit per row and counts the marked rows, so enabling the Delete button after
+ * a click does not walk the store. The button is made sensitive when the count rises above zero and insensitive when it drops
+ * back to zero.
+ */
+
+/** Number of rows held in one word of \ref Selection_set.words. */
+#define SELECTION_WORD_BITS 32
+
+/**
+ * Returns whether a row is marked.
+ * @param set Pointer to the selection set.
+ * @param row Row number.
+ * @return `TRUE` if the row's bit is set.
+ */
+static gboolean is_marked(const Selection_set *set, gint row) {
+	return (set->words[row / SELECTION_WORD_BITS] >> (row % SELECTION_WORD_BITS)) & 1;
+}
+
+/**
+ * Sets or clears a row's bit, updating the count and the Delete button.
+ * @param set Pointer to the selection set.
+ * @param row Row number.
+ * @param marked Whether the row's checkbox is marked.
+ */
+static void mark(Selection_set *set, gint row, gboolean marked) {
+	guint32 bit = 1u << (row % SELECTION_WORD_BITS);
+	if (is_marked(set, row) == marked) {
+		return;
+	}
+	if (marked) {
+		set->words[row / SELECTION_WORD_BITS] |= bit;
+		set->count++;
+	} else {
+		set->words[row / SELECTION_WORD_BITS] &= ~bit;
+		set->count--;
+	}
+	if (set->button != NULL && (set->count == 0 || (marked && set->count == 1))) {
+		gtk_widget_set_sensitive(set->button, set->count > 0);
+	}
+}
+
+/**
+ * Reads a row's checkbox from the model.
+ * @param set Pointer to the selection set.
+ * @param model The tracked store.
+ * @param iter Iterator of the row.
+ * @return `TRUE` if the checkbox is marked.
+ */
+static gboolean checkbox_value(const Selection_set *set, GtkTreeModel *model, GtkTreeIter *iter) {
+	gboolean value;
+	gtk_tree_model_get(model, iter, set->column, &value, -1);
+	return value;
+}
+
+/**
+ * Callback fired when a row is inserted into the store. Shifts the bits at and after the row up by one. Appending a row, the
+ * usual case, shifts nothing.
+ * @param model The tracked store.
+ * @param path Path of the new row.
+ * @param iter Iterator of the new row.
+ * @param data Pointer to the selection set.
+ */
+static void row_inserted(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data) {
+	Selection_set *set = (Selection_set *)data;
+	gint row = gtk_tree_path_get_indices(path)[0];
+
+	if ((set->n_rows + 1 + SELECTION_WORD_BITS - 1) / SELECTION_WORD_BITS > set->n_words) {
+		gint n_words = MAX(set->n_words * 2, 4);
+		set->words = g_renew(guint32, set->words, n_words);
+		memset(&set->words[set->n_words], 0, (n_words - set->n_words) * sizeof(guint32));
+		set->n_words = n_words;
+	}
+
+	/* Shift whole words from the end down to the row's word, carrying the top bit of each word into the next. */
+	gint first_word = row / SELECTION_WORD_BITS;
+	gint last_word = set->n_rows / SELECTION_WORD_BITS;
+	for (gint word = last_word; word > first_word; word--) {
+		set->words[word] = (set->words[word] << 1) | (set->words[word - 1] >> (SELECTION_WORD_BITS - 1));
+	}
+	guint32 low_mask = (1u << (row % SELECTION_WORD_BITS)) - 1;
+	guint32 first = set->words[first_word];
+	set->words[first_word] = (first & low_mask) | ((first & ~low_mask) << 1);
+	set->n_rows++;
+
+	mark(set, row, checkbox_value(set, model, iter));
+}
+
+/**
+ * Callback fired when a row in the store changes. Brings the row's bit in line with its checkbox.
+ * @param model The tracked store.
+ * @param path Path of the changed row.
+ * @param iter Iterator of the changed row.
+ * @param data Pointer to the selection set.
+ */
+static void row_changed(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data) {
+	Selection_set *set = (Selection_set *)data;
+	gint row = gtk_tree_path_get_indices(path)[0];
+
+	if (row >= set->n_rows) {
+		return;
+	}
+	mark(set, row, checkbox_value(set, model, iter));
+}
+
+/**
+ * Callback fired when a row is deleted from the store. Shifts the bits after the row down by one.
+ * @param model The tracked store.
+ * @param path Path the deleted row had.
+ * @param data Pointer to the selection set.
+ */
+static void row_deleted(GtkTreeModel *model, GtkTreePath *path, gpointer data) {
+	Selection_set *set = (Selection_set *)data;
+	gint row = gtk_tree_path_get_indices(path)[0];
+
+	if (row >= set->n_rows) {
+		return;
+	}
+	mark(set, row, FALSE);
+
+	gint first_word = row / SELECTION_WORD_BITS;
+	gint last_word = (set->n_rows - 1) / SELECTION_WORD_BITS;
+	guint32 low_mask = (1u << (row % SELECTION_WORD_BITS)) - 1;
+	guint32 first = set->words[first_word];
+	set->words[first_word] = (first & low_mask) | ((first >> 1) & ~low_mask);
+	for (gint word = first_word; word < last_word; word++) {
+		set->words[word] |= set->words[word + 1] << (SELECTION_WORD_BITS - 1);
+		set->words[word + 1] >>= 1;
+	}
+	set->n_rows--;
+}
+
+/**
+ * Creates a selection set for a store and subscribes it to the store's signals. The store's current rows are read once here.
+ * @param store Store to track. The set holds a reference to it.
+ * @param column Boolean column holding the Delete checkbox, such as \ref CHECKBOX or \ref CHECK_RADIO.
+ * @param button Delete button whose sensitivity follows the set, or `NULL`.
+ * @return Pointer to the new selection set. Free with selection_set_free().
+ */
+Selection_set *selection_set_new(GtkListStore *store, gint column, GtkWidget *button) {
+	Selection_set *set = g_new0(Selection_set, 1);
+	GtkTreeModel *model = GTK_TREE_MODEL(store);
+	GtkTreeIter iter;
+
+	set->store = g_object_ref(store);
+	set->column = column;
+	set->n_rows = gtk_tree_model_iter_n_children(model, NULL);
+	set->n_words = MAX((set->n_rows + SELECTION_WORD_BITS - 1) / SELECTION_WORD_BITS, 4);
+	set->words = g_new0(guint32, set->n_words);
+
+	gint row = 0;
+	gboolean valid = gtk_tree_model_get_iter_first(model, &iter);
+	while (valid) {
+		mark(set, row++, checkbox_value(set, model, &iter));
+		valid = gtk_tree_model_iter_next(model, &iter);
+	}
+
+	set->button = button;
+	if (button != NULL) {
+		gtk_widget_set_sensitive(button, set->count > 0);
+	}
+
+	g_signal_connect(store, "row-inserted", G_CALLBACK(row_inserted), set);
+	g_signal_connect(store, "row-changed", G_CALLBACK(row_changed), set);
+	g_signal_connect(store, "row-deleted", G_CALLBACK(row_deleted), set);
+
+	return set;
+}
+
+/**
+ * Copies the rows that are not marked into a new store with the same columns, in one pass over the set's store. Nothing is
+ * listening to the new store while it is filled, so callers can swap it in for the old one and the view sees a single change
+ * of model instead of one `row-deleted` per removed row.
+ * @param set Pointer to the selection set.
+ * @return Pointer to the new store, with a reference owned by the caller.
+ */
+GtkListStore *selection_set_copy_unmarked(const Selection_set *set) {
+	GtkTreeModel *model = GTK_TREE_MODEL(set->store);
+	gint n_columns = gtk_tree_model_get_n_columns(model);
+	GType *types = g_new(GType, n_columns);
+	gint *columns = g_new(gint, n_columns);
+	GValue *values = g_new0(GValue, n_columns);
+
+	for (gint column = 0; column < n_columns; column++) {
+		types[column] = gtk_tree_model_get_column_type(model, column);
+		columns[column] = column;
+	}
+	GtkListStore *remaining = gtk_list_store_newv(n_columns, types);
+
+	GtkTreeIter iter;
+	gint row = 0;
+	gboolean valid = gtk_tree_model_get_iter_first(model, &iter);
+	while (valid) {
+		if (!is_marked(set, row)) {
+			for (gint column = 0; column < n_columns; column++) {
+				gtk_tree_model_get_value(model, &iter, column, &values[column]);
+			}
+			gtk_list_store_insert_with_valuesv(remaining, NULL, -1, columns, values, n_columns);
+			for (gint column = 0; column < n_columns; column++) {
+				g_value_unset(&values[column]);
+			}
+		}
+		row++;
+		valid = gtk_tree_model_iter_next(model, &iter);
+	}
+
+	g_free(values);
+	g_free(columns);
+	g_free(types);
+	return remaining;
+}
+
+/**
+ * Hands the Delete button to a selection set, or takes it away. Several sets can track stores for the same button, as the
+ * deposits in deposit_session.c do; only the set of the store shown in the view should hold it, or marking a check in a
+ * deposit in the background would change the button of the one on screen.
+ * @param set Pointer to the selection set.
+ * @param button Delete button whose sensitivity follows the set from now on, or `NULL`.
+ */
+void selection_set_bind_button(Selection_set *set, GtkWidget *button) {
+	set->button = button;
+	if (button != NULL) {
+		gtk_widget_set_sensitive(button, set->count > 0);
+	}
+}
+
+/**
+ * Disconnects a selection set from its store and frees it.
+ * @param set Pointer to the selection set.
+ */
+void selection_set_free(Selection_set *set) {
+	g_signal_handlers_disconnect_by_data(set->store, set);
+	g_object_unref(set->store);
+	g_free(set->words);
+	g_free(set);
+}
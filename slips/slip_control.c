@@ -8,40 +8,17 @@
  * @brief Contains code for managing interactions with the controls in the deposit slip view.
  */
 
-/**
- * Callback fired during a `gtk_tree_model_foreach`. The function
- * determines if the passed checkbox is checked. If it is, set the flag `CheckSelection.at_least_one_check_selected` to `TRUE`.
- * @param model Pointer to the model being iterated.
- * @param path Pointer to the path associated with the current iteration.
- * @param iter Pointer to the iterator associated with the current iteration.
- * @param data Pointer to a \ref CheckSelection structure.
- * @return `TRUE` upon being passed a checkbox that is checked, indicating that at least one checkbox is checked. We can then activate the Delete button. `FALSE` if the current checkbox is not checked, implying we can possibly iterate over all checkboxes.
- * \sa check_toggle_clicked()
- */
-gboolean examine_all_check_checkboxes(GtkTreeModel *model,
-									  GtkTreePath *path,
-									  GtkTreeIter *iter,
-									  gpointer data) {
-	CheckSelection *check_selection = (CheckSelection *)data;
-	gboolean value;
-	if (gtk_tree_model_get_iter(model, iter, path)) {
-		gtk_tree_model_get(model, iter, CHECK_RADIO, &value, -1);
-		if (value == TRUE) {
-			check_selection->at_least_one_check_selected = TRUE;
-			return TRUE;
-		}
-	}
-	return FALSE;
-}
-
 /**
  * Callback fired after changing the selection in the accounts listing in the Slips tab.
  * The function changes the label under the accounts list to show the selected
- * account's name and description.
+ * account's name and description, followed by the bank's name if the routing number is in the routing directory.
  * @param tree_view Pointer to tree view whose selection was changed.
- * @param user_data Pointer to user data (not used).
+ * @param path Path of the activated row.
+ * @param column Column of the activated row.
+ * @param user_data Pointer to user data.
  */
-void update_label(GtkTreeView *tree_view, gpointer user_data) {
+void update_label(GtkTreeView *tree_view, GtkTreePath *path, GtkTreeViewColumn *column, gpointer user_data) {
+	Data_passer *data_passer = (Data_passer *)user_data;
 	GtkWidget *tree_parent = gtk_widget_get_parent(GTK_WIDGET(tree_view));
 	GtkTreeSelection *tree_selection = gtk_tree_view_get_selection(tree_view);
 	GtkTreeModel *model;
@@ -49,14 +26,14 @@ void update_label(GtkTreeView *tree_view, gpointer user_data) {
 
 	if (gtk_tree_selection_get_selected(tree_selection, &model, &iter)) {
 		GtkWidget *lbl_description = get_child_from_parent(tree_parent, LABEL_ACCOUNT_DESCRIPTION);
-		gchar *account_name;
-		gchar *description;
-		gtk_tree_model_get(model, &iter, ACCOUNT_NAME, &account_name, DESCRIPTION, &description, -1);
-		gchar *full_label = g_strdup_printf("%s (%s)", account_name, description);
+		const gchar *account_name = account_table_column(data_passer->account_table, model, &iter, ACCOUNT_NAME);
+		const gchar *description = account_table_column(data_passer->account_table, model, &iter, DESCRIPTION);
+		const gchar *routing = account_table_column(data_passer->account_table, model, &iter, ROUTING_NUMBER);
+		const Routing_entry *bank = routing_directory_lookup(routing);
+		gchar *full_label = (bank != NULL) ? g_strdup_printf("%s (%s), %s", account_name, description, bank->bank_name)
+										   : g_strdup_printf("%s (%s)", account_name, description);
 		gtk_label_set_label(GTK_LABEL(lbl_description), full_label);
 		g_free(full_label);
-		g_free(account_name);
-		g_free(description);
 	} else {
 		return;
 	}
@@ -84,24 +61,11 @@ void check_toggle_clicked(GtkCellRendererToggle *renderer,
 		return;
 	}
 
+	/* Deposit.check_selection sees the change and sets the Delete button's sensitivity. */
 	if (gtk_tree_model_get_iter_from_string(model, &iter, path)) {
 		gtk_tree_model_get(model, &iter, CHECK_RADIO, &value, -1);
 		gtk_list_store_set(GTK_LIST_STORE(model), &iter, CHECK_RADIO, !value, -1);
 	}
-
-	CheckSelection check_selection;
-	check_selection.path = gtk_tree_path_new_from_string(path); /* Memory freed below. */
-	check_selection.at_least_one_check_selected = FALSE;
-
-	gtk_tree_model_foreach(model, examine_all_check_checkboxes, &check_selection);
-
-	if (check_selection.at_least_one_check_selected == TRUE) {
-		gtk_widget_set_sensitive(data_passer->btn_checks_delete, TRUE);
-	} else {
-		gtk_widget_set_sensitive(data_passer->btn_checks_delete, FALSE);
-	}
-
-	gtk_tree_path_free(check_selection.path);
 }
 
 
@@ -124,6 +88,7 @@ void toggle_slip_view(GtkWidget *widget, gpointer data) {
 		data_passer->front_slip_active = FALSE;
 
 	}
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_SIDE, REDRAW_SOURCE_APP);
 }
 
 /**
@@ -135,15 +100,17 @@ void add_check_row(GtkWidget *widget, gpointer data) {
 	Data_passer *data_passer = (Data_passer *)data;
 
 	GtkTreeIter iter;
-	gtk_list_store_append(data_passer->checks_store, &iter);
-	gtk_list_store_set(data_passer->checks_store, &iter,
+	gtk_list_store_append(data_passer->deposit->checks_store, &iter);
+	gtk_list_store_set(data_passer->deposit->checks_store, &iter,
 					   CHECK_AMOUNT, NEW_AMOUNT,
 					   CHECK_RADIO, FALSE,
+					   CHECK_CENTS, (gint64)0,
 					   -1);
+	data_passer->deposit->modified = TRUE;
 
 	/* If we added a 15th row, set the button's sensitivity to FALSE to prevent the user from adding another row. */
 	gint local_number_of_checks = number_of_checks(data_passer);
-	if (local_number_of_checks >= 15) {
+	if (local_number_of_checks >= MAXIMUM_CHECKS) {
 		gtk_widget_set_sensitive(widget, FALSE);
 	}
 
@@ -162,44 +129,42 @@ void add_check_row(GtkWidget *widget, gpointer data) {
 	}
 	/* After adding a row, enable the radio buttons to delete one of the rows. */
 	g_object_set(data_passer->radio_renderer, "activatable", TRUE, NULL);
+
+	slip_redraw_schedule_check(data_passer, local_number_of_checks - 1, REDRAW_SOURCE_APP);
 }
 
 /**
-	Deletes all checked rows from the model (and reflected in the treeview) after user clicks the Delete button. Inspiration for this loop is from [198. How to iterate through a GtkListStore - Part 2?](https://www.kksou.com/php-gtk2/sample-codes/iterate-through-a-GtkListStore-Part-2.php). This function also sets the delete button's sensitivity to `FALSE`.
+ * Replaces the current deposit's checks store with another one. The checks view is detached while the trackers that follow
+ * the store are moved to the new one, and is then attached to the new store, so the view lays itself out once.
+ * @param data_passer Pointer to user data.
+ * @param checks_store The new store. The deposit takes over the caller's reference.
+ */
+static void set_checks_store(Data_passer *data_passer, GtkListStore *checks_store) {
+	gtk_tree_view_set_model(GTK_TREE_VIEW(data_passer->check_tree_view), NULL);
+	deposit_set_checks_store(data_passer->deposit, checks_store);
+	gtk_tree_view_set_model(GTK_TREE_VIEW(data_passer->check_tree_view), GTK_TREE_MODEL(checks_store));
+}
+
+/**
+	Deletes all checked rows from the model (and reflected in the treeview) after user clicks the Delete button. The unchecked
+	rows are copied into a new store in one pass, which then replaces the old store, so the view and the totals see one change
+	instead of one per deleted row. The new store has no checked rows, so the delete button becomes insensitive.
 
 	@param widget Pointer to the clicked Delete button.
-	@param data Pointer to the temporary list store.
+	@param data Pointer to the data passer.
 */
 void delete_check_rows(GtkWidget *widget, gpointer data) {
 
 	Data_passer *data_passer = (Data_passer *)data;
 
-  //  GtkListStore *list_store = (GtkListStore *)data;
-	GtkTreeIter iter;
-	GValue gvalue = G_VALUE_INIT;
-	gboolean still_in_list = TRUE;
-	gboolean removed_last_row = FALSE;
-
-	gtk_tree_model_get_iter_first(GTK_TREE_MODEL(data_passer->checks_store), &iter);
-
-	do {
-		g_value_unset(&gvalue);
-
-		gtk_tree_model_get_value(GTK_TREE_MODEL(data_passer->checks_store), &iter, CHECK_RADIO, &gvalue);
-
-		if (g_value_get_boolean(&gvalue) == TRUE) {
-			removed_last_row = !gtk_list_store_remove(data_passer->checks_store, &iter);
-		} else {
-			still_in_list = gtk_tree_model_iter_next(GTK_TREE_MODEL(data_passer->checks_store), &iter);
-		}
-	} while (still_in_list && !removed_last_row);
-
-	/* After deleting the checked rows, set the delete button's sensitivity (passed to this function) to FALSE. */
-	gtk_widget_set_sensitive(widget, FALSE);
-
+	set_checks_store(data_passer, selection_set_copy_unmarked(data_passer->deposit->check_selection));
+	data_passer->deposit->modified = TRUE;
 
 	if (number_of_checks(data_passer) <= 2) {
 		gtk_widget_hide(data_passer->btn_go_to_first);
 		gtk_widget_hide(data_passer->btn_go_to_last);
 	}
+
+	/* Remaining checks moved up, so rewrite every check's field. */
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_ALL_CHECKS, REDRAW_SOURCE_APP);
 }
@@ -0,0 +1,132 @@
+#include <gtk/gtk.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file slip_layout.c
+ * @brief Immutable, reference-counted snapshots of the slip's layout.
+ *
+ * A \ref Slip_layout holds the \ref Front and \ref Back coordinates read from the configuration file and is never changed after
+ * it is read. When the file changes, a new layout is read and swapped in for \ref Data_passer.layout on the UI thread, and the
+ * display lists are compiled again. Anything that reads a layout for longer than one callback, such as a print job, holds a
+ * reference instead of reading the current pointer, so a reload cannot change the layout under it. Code on other threads is handed
+ * a reference by the UI thread and never reads \ref Data_passer.layout itself.
+ */
+
+/**
+ * Creates a layout with every coordinate zero.
+ * @return Pointer to the layout, with one reference. Release with slip_layout_unref().
+ */
+Slip_layout *slip_layout_new(void) {
+	Slip_layout *layout = g_new0(Slip_layout, 1);
+	g_atomic_ref_count_init(&layout->ref_count);
+	return layout;
+}
+
+/**
+ * Adds a reference to a layout.
+ * @param layout Pointer to the layout.
+ * @return The layout.
+ */
+Slip_layout *slip_layout_ref(Slip_layout *layout) {
+	g_atomic_ref_count_inc(&layout->ref_count);
+	return layout;
+}
+
+/**
+ * Releases a reference to a layout, freeing it with the last reference.
+ * @param layout Pointer to the layout, or `NULL`.
+ */
+void slip_layout_unref(Slip_layout *layout) {
+	if (layout != NULL && g_atomic_ref_count_dec(&layout->ref_count)) {
+		g_free(layout);
+	}
+}
+
+/**
+ * Makes a layout current, compiles the display lists from it, and redraws the preview. While a print job holds the current
+ * layout, the new one waits in \ref Data_passer.layout_pending until the job releases it.
+ * @param data_passer Pointer to user data.
+ * @param layout The new layout. The function takes over the caller's reference.
+ */
+void slip_layout_publish(Data_passer *data_passer, Slip_layout *layout) {
+	if (data_passer->layout_holds > 0) {
+		slip_layout_unref(data_passer->layout_pending);
+		data_passer->layout_pending = layout;
+		return;
+	}
+
+	/* Only the UI thread swaps the layout, so reading the old pointer and storing the new one need not be one operation. */
+	Slip_layout *previous = data_passer->layout;
+	g_atomic_pointer_set(&data_passer->layout, layout);
+	slip_layout_unref(previous);
+	slip_compile(data_passer);
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_PREVIEW, REDRAW_SOURCE_APP);
+}
+
+/**
+ * Returns a reference to the current layout and keeps it current until slip_layout_release(). Print jobs call this before
+ * writing deposits into the display lists, so every page of the job has the same layout.
+ * @param data_passer Pointer to user data.
+ * @return Pointer to the current layout, with a reference owned by the caller.
+ */
+Slip_layout *slip_layout_hold(Data_passer *data_passer) {
+	data_passer->layout_holds++;
+	return slip_layout_ref(data_passer->layout);
+}
+
+/**
+ * Releases a layout returned by slip_layout_hold(). If the configuration file was reloaded in the meantime, the new layout is
+ * published once the last hold is released.
+ * @param data_passer Pointer to user data.
+ * @param layout Pointer to the held layout.
+ */
+void slip_layout_release(Data_passer *data_passer, Slip_layout *layout) {
+	slip_layout_unref(layout);
+	if (--data_passer->layout_holds == 0 && data_passer->layout_pending != NULL) {
+		Slip_layout *pending = data_passer->layout_pending;
+		data_passer->layout_pending = NULL;
+		slip_layout_publish(data_passer, pending);
+	}
+}
+
+/**
+ * Callback fired when the configuration file changes. Reads the layout again and publishes it.
+ * @param monitor The file monitor.
+ * @param file The configuration file.
+ * @param other_file Unused.
+ * @param event_type Kind of change.
+ * @param data Pointer to user data.
+ */
+static void configuration_changed(GFileMonitor *monitor, GFile *file, GFile *other_file, GFileMonitorEvent event_type, gpointer data) {
+	Data_passer *data_passer = (Data_passer *)data;
+
+	/* Editors write the file in several steps; read it once they are done. */
+	if (event_type != G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT && event_type != G_FILE_MONITOR_EVENT_CREATED) {
+		return;
+	}
+	Slip_layout *layout = read_slip_layout_file();
+	if (layout != NULL) {
+		slip_layout_publish(data_passer, layout);
+	}
+}
+
+/**
+ * Starts watching the configuration file, so that edits to the slip's layout show in the preview without restarting.
+ * Stopped in free_memory().
+ * @param data_passer Pointer to user data.
+ */
+void slip_layout_watch(Data_passer *data_passer) {
+	GError *error = NULL;
+	GFile *file = g_file_new_for_path(CONFIG_FILE);
+
+	data_passer->layout_monitor = g_file_monitor_file(file, G_FILE_MONITOR_NONE, NULL, &error);
+	if (data_passer->layout_monitor == NULL) {
+		g_print("Unable to watch `%s': %s\n", CONFIG_FILE, error->message);
+		g_error_free(error);
+	} else {
+		g_signal_connect(data_passer->layout_monitor, "changed", G_CALLBACK(configuration_changed), data_passer);
+	}
+	g_object_unref(file);
+}
@@ -9,6 +9,24 @@
  * @brief Creates the view for creating the deposit slip.
  */
 
+/**
+ * Callback fired from a `gtk_tree_view_column_set_cell_data_func()` to show the account number of each row in the Slip tab's
+ * accounts list. The store holds the number's offset in the account table.
+ * @param col Pointer to the account's column.
+ * @param renderer Pointer to the account's cell renderer.
+ * @param model Pointer to model associated with the tree view.
+ * @param iter Pointer to iterator associated with the model.
+ * @param user_data Pointer to user data.
+ */
+static void account_number_formatter(GtkTreeViewColumn *col,
+									 GtkCellRenderer *renderer,
+									 GtkTreeModel *model,
+									 GtkTreeIter *iter,
+									 gpointer user_data) {
+	Data_passer *data_passer = (Data_passer *)user_data;
+	g_object_set(renderer, "text", account_table_column(data_passer->account_table, model, iter, ACCOUNT_NUMBER), NULL);
+}
+
 /**
  * Creates the view of account numbers in the deposit list tab.
  * @param data_passer Pointer to user data.
@@ -26,8 +44,8 @@ GtkWidget *make_account_view(Data_passer *data_passer) {
 	rendererAccount = gtk_cell_renderer_text_new();
 	columnAccount = gtk_tree_view_column_new_with_attributes("Account No.",
 															 rendererAccount,
-															 "text", ACCOUNT_NUMBER,
 															 NULL);
+	gtk_tree_view_column_set_cell_data_func(columnAccount, rendererAccount, account_number_formatter, data_passer, NULL);
 
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree_view), columnAccount);
 
@@ -35,7 +53,7 @@ GtkWidget *make_account_view(Data_passer *data_passer) {
 	gtk_tree_selection_set_mode(tree_selection, GTK_SELECTION_SINGLE);
 
 	gtk_tree_view_set_activate_on_single_click(GTK_TREE_VIEW(tree_view), TRUE);
-	g_signal_connect(G_OBJECT(tree_view), "row-activated", G_CALLBACK(update_label), NULL);
+	g_signal_connect(G_OBJECT(tree_view), "row-activated", G_CALLBACK(update_label), data_passer);
 
 	return tree_view;
 }
@@ -85,7 +103,8 @@ void started_cell_editing(GtkCellRenderer *self, GtkCellEditable *editable, gcha
 void make_checks_view(Data_passer *data_passer) {
 	GtkWidget *tree;
 
-	tree = gtk_tree_view_new_with_model(GTK_TREE_MODEL(data_passer->checks_store));
+	/* The model is the checks store of the current deposit, set in deposit_session_select(). */
+	tree = gtk_tree_view_new();
 
 	data_passer->check_tree_view = tree;
 	g_object_set(tree, "enable-grid-lines", GTK_TREE_VIEW_GRID_LINES_BOTH, NULL);
@@ -133,8 +152,6 @@ void make_checks_view(Data_passer *data_passer) {
 
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnChecks);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(tree), columnToggle);
-
-	g_object_unref(data_passer->checks_store); /* destroy model automatically with view */
 }
 
 /**
@@ -153,8 +170,15 @@ GtkWidget *make_slip_view(Data_passer *data_passer) {
 	GtkWidget *btnChecksAdd = gtk_button_new_from_icon_name("gtk-add", GTK_ICON_SIZE_BUTTON);
 	GtkWidget *btnChecksDelete = gtk_button_new_from_icon_name("gtk-delete", GTK_ICON_SIZE_BUTTON);
 	;
+	data_passer->btn_checks_add = btnChecksAdd;
 	data_passer->btn_checks_delete = btnChecksDelete;
 	GtkWidget *btnSlipPrint = gtk_button_new_from_icon_name("gtk-print", GTK_ICON_SIZE_BUTTON);
+	GtkWidget *btnSlipPrintAll = gtk_button_new_with_label("Print all");
+	GtkWidget *btnSlipExport = gtk_button_new_with_label("Export");
+	GtkWidget *btnSlipSave = gtk_button_new_from_icon_name("document-save", GTK_ICON_SIZE_BUTTON);
+	GtkWidget *btnSlipOpen = gtk_button_new_from_icon_name("document-open", GTK_ICON_SIZE_BUTTON);
+	GtkWidget *btnSlipOpenAll = gtk_button_new_with_label("Open all");
+	GtkWidget *btnSlipReprint = gtk_button_new_with_label("Reprint");
 
 	GtkWidget *btnGotoFirst = gtk_button_new_from_icon_name("gtk-goto-first-ltr", GTK_ICON_SIZE_BUTTON);
 	GtkWidget *btnGotoLast = gtk_button_new_from_icon_name("gtk-goto-last-ltr", GTK_ICON_SIZE_BUTTON);
@@ -167,6 +191,18 @@ GtkWidget *make_slip_view(Data_passer *data_passer) {
 	gtk_widget_set_name(btnChecksAdd, BUTTON_CHECK_ADD);
 	gtk_widget_set_name(btnChecksDelete, BUTTON_CHECK_DELETE);
 	gtk_widget_set_name(btnSlipPrint, BUTTON_SLIP_PRINT);
+	gtk_widget_set_name(btnSlipPrintAll, BUTTON_SLIP_PRINT_ALL);
+	gtk_widget_set_tooltip_text(btnSlipPrintAll, "Print the deposit slips of all accounts");
+	gtk_widget_set_name(btnSlipExport, BUTTON_SLIP_EXPORT);
+	gtk_widget_set_tooltip_text(btnSlipExport, "Save this deposit slip as PDF");
+	gtk_widget_set_name(btnSlipSave, BUTTON_SLIP_SAVE);
+	gtk_widget_set_tooltip_text(btnSlipSave, "Save this account's deposit");
+	gtk_widget_set_name(btnSlipOpen, BUTTON_SLIP_OPEN);
+	gtk_widget_set_tooltip_text(btnSlipOpen, "Open this account's saved deposit");
+	gtk_widget_set_name(btnSlipOpenAll, BUTTON_SLIP_OPEN_ALL);
+	gtk_widget_set_tooltip_text(btnSlipOpenAll, "Open the saved deposits of all accounts");
+	gtk_widget_set_name(btnSlipReprint, BUTTON_SLIP_REPRINT);
+	gtk_widget_set_tooltip_text(btnSlipReprint, "Open this account's last printed deposit");
 	gtk_widget_set_name(lblAccountDescription, LABEL_ACCOUNT_DESCRIPTION);
 
 	gtk_label_set_xalign(GTK_LABEL(lblAccount), 0.0);
@@ -184,6 +220,12 @@ GtkWidget *make_slip_view(Data_passer *data_passer) {
 	gtk_widget_set_halign(btnChecksAdd, GTK_ALIGN_CENTER);
 	gtk_widget_set_halign(btnChecksDelete, GTK_ALIGN_CENTER);
 	gtk_widget_set_halign(btnSlipPrint, GTK_ALIGN_CENTER);
+	gtk_widget_set_halign(btnSlipPrintAll, GTK_ALIGN_CENTER);
+	gtk_widget_set_halign(btnSlipExport, GTK_ALIGN_CENTER);
+	gtk_widget_set_halign(btnSlipSave, GTK_ALIGN_CENTER);
+	gtk_widget_set_halign(btnSlipOpen, GTK_ALIGN_CENTER);
+	gtk_widget_set_halign(btnSlipOpenAll, GTK_ALIGN_CENTER);
+	gtk_widget_set_halign(btnSlipReprint, GTK_ALIGN_CENTER);
 
 	/* Prevent btnGotoFirst and btnGotoLast from appearing when showing the application window. */
 	gtk_widget_set_no_show_all(btnGotoFirst, TRUE);
@@ -197,26 +239,36 @@ GtkWidget *make_slip_view(Data_passer *data_passer) {
 
 	GtkWidget *drawing_area = gtk_drawing_area_new();
 	data_passer->drawing_area = drawing_area;
+	/* Time each draw of the preview, shown with F12. Freed in `free_memory()`. */
+	data_passer->frame_stats = frame_stats_new();
+	/* Rasterize the preview on its own thread. Freed in `free_memory()`. */
+	data_passer->preview_renderer = preview_renderer_new(data_passer);
 
 	data_passer->checks_accounts_treeview = make_account_view(data_passer);
-
-	GtkListStore *checks_store = gtk_list_store_new(SLIP_COLUMNS, G_TYPE_STRING, G_TYPE_BOOLEAN);
-	GtkTreeIter trashiter;
-	gtk_list_store_append(checks_store, &trashiter);
-	gtk_list_store_set(checks_store, &trashiter,
-					   CHECK_AMOUNT, "1.00",
-					   CHECK_RADIO, FALSE,
-					   -1);
-
-	data_passer->checks_store = checks_store;
+	/* Rewrite the account fields of the slip whenever the user selects another account. */
+	g_signal_connect(gtk_tree_view_get_selection(GTK_TREE_VIEW(data_passer->checks_accounts_treeview)), "changed", G_CALLBACK(slip_account_changed), data_passer);
 
 	make_checks_view(data_passer);
+
+	/* Start the session with a deposit for the selected account. Selecting another account switches deposits; see slip_account_changed(). Freed in `free_memory()`. */
+	data_passer->session = deposit_session_new();
+	deposit_session_select(data_passer);
 	/* When clicking the add button, add a row to the view */
 	g_signal_connect(btnChecksAdd, "clicked", G_CALLBACK(add_check_row), data_passer);
 	/* When clicking the delete button, remove rows whose checkbox is marked. */
 	g_signal_connect(btnChecksDelete, "clicked", G_CALLBACK(delete_check_rows), data_passer);
 	/* When clicking the preint button, print the deposit slip. */
 	g_signal_connect(btnSlipPrint, "clicked", G_CALLBACK(print_deposit_slip), data_passer);
+	/* When clicking the print all button, print the deposit slips of every account in the session. */
+	g_signal_connect(btnSlipPrintAll, "clicked", G_CALLBACK(print_all_deposit_slips), data_passer);
+	/* When clicking the export button, save the deposit slip as PDF. */
+	g_signal_connect(btnSlipExport, "clicked", G_CALLBACK(export_deposit_slip), data_passer);
+	/* Save and reopen deposits in progress, so they survive closing the application. */
+	g_signal_connect(btnSlipSave, "clicked", G_CALLBACK(save_deposit), data_passer);
+	g_signal_connect(btnSlipOpen, "clicked", G_CALLBACK(open_deposit), data_passer);
+	g_signal_connect(btnSlipOpenAll, "clicked", G_CALLBACK(open_all_deposits), data_passer);
+	/* Bring back the checks of the account's last printed deposit from the history. */
+	g_signal_connect(btnSlipReprint, "clicked", G_CALLBACK(reprint_last_deposit), data_passer);
 
 	/* Make a scrolled window for the checks being deposited. */
 	GtkWidget *scrolled_window = gtk_scrolled_window_new(NULL, NULL);
@@ -239,7 +291,8 @@ GtkWidget *make_slip_view(Data_passer *data_passer) {
 	/* Third column of grid */
 	gtk_grid_attach(GTK_GRID(gridSlip), drawing_area, 3, 1, 1, 1);
 
-	gtk_widget_set_size_request(drawing_area, 500, 150);
+	/* Keep the preview in the slip's proportions. */
+	gtk_widget_set_size_request(drawing_area, 500, 500 * SLIP_HEIGHT / SLIP_WIDTH);
 
 	/* When the draw signal is fired on the drawing area (which can happen billions of times
 	from GTK's internal messaging), go redraw the deposit slip preview. */
@@ -251,6 +304,12 @@ GtkWidget *make_slip_view(Data_passer *data_passer) {
 	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnGotoFirst, FALSE, FALSE, 5);
 	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnGotoLast, FALSE, FALSE, 5);
 	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipPrint, TRUE, FALSE, 5);
+	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipPrintAll, FALSE, FALSE, 5);
+	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipExport, FALSE, FALSE, 5);
+	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipSave, FALSE, FALSE, 5);
+	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipOpen, FALSE, FALSE, 5);
+	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipOpenAll, FALSE, FALSE, 5);
+	gtk_box_pack_start(GTK_BOX(box_first_last_print), btnSlipReprint, FALSE, FALSE, 5);
 
 	gtk_grid_attach(GTK_GRID(gridSlip), box_first_last_print, 3, 3, 1, 1);
 
@@ -0,0 +1,161 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file text_metrics.c
+ * @brief Cache of text extents used while laying out the deposit slip.
+ *
+ * Extents are measured once per font family, weight, size, and string, and then served from a hash table. Single
+ * characters, such as the digits of amounts, are served from per-font tables indexed by the character, so measuring a digit
+ * is an array lookup.
+ */
+
+/** Largest key, in bytes, looked up without allocating. Longer keys are built on the heap. */
+#define TEXT_METRICS_KEY_SIZE 256
+
+/**
+ * Extents of every single-byte character in one font at one size.
+ */
+typedef struct Character_metrics {
+	gchar family[100]; /**< Font family. */
+	cairo_font_weight_t weight; /**< Font weight. */
+	gdouble font_size; /**< Font size in points. */
+	gboolean measured[128]; /**< Whether each character has been measured. */
+	cairo_text_extents_t extents[128]; /**< Extents of each character. */
+} Character_metrics;
+
+/**
+ * Cairo context on a 1×1 surface used for measuring. Measuring in an unscaled context gives extents in points, the unit of the layout.
+ */
+static cairo_t *measuring_context = NULL;
+
+/**
+ * Extents of strings, keyed by font, size, and string. Values are `cairo_text_extents_t`.
+ */
+static GHashTable *extents_cache = NULL;
+
+/**
+ * List of \ref Character_metrics, one per font and size in use. The slip uses only a handful, so a list is enough.
+ */
+static GSList *character_tables = NULL;
+
+/**
+ * Number of times text was actually measured since the cache was last cleared. Written with `g_debug` when the cache is cleared.
+ */
+static guint measurements = 0;
+
+/**
+ * Measures text in the measuring context.
+ * @param family Font family.
+ * @param weight Font weight.
+ * @param font_size Font size in points.
+ * @param text Text to measure.
+ * @param extents Receives the extents.
+ */
+static void measure(const gchar *family, cairo_font_weight_t weight, gdouble font_size, const gchar *text, cairo_text_extents_t *extents) {
+	if (measuring_context == NULL) {
+		cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_A8, 1, 1);
+		measuring_context = cairo_create(surface);
+		cairo_surface_destroy(surface); /* The context keeps the surface alive. */
+	}
+	cairo_select_font_face(measuring_context, family, CAIRO_FONT_SLANT_NORMAL, weight);
+	cairo_set_font_size(measuring_context, font_size);
+	cairo_text_extents(measuring_context, text, extents);
+	measurements++;
+}
+
+/**
+ * Returns the table of single-character extents for a font and size, creating it if needed.
+ * @param family Font family.
+ * @param weight Font weight.
+ * @param font_size Font size in points.
+ * @return Pointer to the table.
+ */
+static Character_metrics *character_table(const gchar *family, cairo_font_weight_t weight, gdouble font_size) {
+	for (GSList *current = character_tables; current != NULL; current = current->next) {
+		Character_metrics *table = current->data;
+		if (table->weight == weight && table->font_size == font_size && g_strcmp0(table->family, family) == 0) {
+			return table;
+		}
+	}
+	Character_metrics *table = g_new0(Character_metrics, 1);
+	g_strlcpy(table->family, family, sizeof(table->family));
+	table->weight = weight;
+	table->font_size = font_size;
+	character_tables = g_slist_prepend(character_tables, table);
+	return table;
+}
+
+/**
+ * Returns the extents of text, measuring it only the first time it is seen in a given font and size.
+ * @param family Font family.
+ * @param weight Font weight.
+ * @param font_size Font size in points.
+ * @param text Text to measure.
+ * @param extents Receives the extents in points.
+ */
+void text_metrics_extents(const gchar *family, cairo_font_weight_t weight, gdouble font_size, const gchar *text, cairo_text_extents_t *extents) {
+	/* Single ASCII characters come from the character table. */
+	if (text[0] != '\0' && text[1] == '\0' && (guchar)text[0] < 128) {
+		Character_metrics *table = character_table(family, weight, font_size);
+		guchar character = text[0];
+		if (!table->measured[character]) {
+			measure(family, weight, font_size, text, &table->extents[character]);
+			table->measured[character] = TRUE;
+		}
+		*extents = table->extents[character];
+		return;
+	}
+
+	if (extents_cache == NULL) {
+		extents_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+	}
+
+	gchar key_buffer[TEXT_METRICS_KEY_SIZE];
+	gchar *key = key_buffer;
+	gint key_length = g_snprintf(key_buffer, sizeof(key_buffer), "%s\x1f%d\x1f%g\x1f%s", family, weight, font_size, text);
+	if (key_length >= (gint)sizeof(key_buffer)) {
+		key = g_strdup_printf("%s\x1f%d\x1f%g\x1f%s", family, weight, font_size, text);
+	}
+
+	cairo_text_extents_t *cached = g_hash_table_lookup(extents_cache, key);
+	if (cached == NULL) {
+		cached = g_new(cairo_text_extents_t, 1);
+		measure(family, weight, font_size, text, cached);
+		g_hash_table_insert(extents_cache, (key == key_buffer) ? g_strdup(key) : key, cached);
+	} else if (key != key_buffer) {
+		g_free(key);
+	}
+	*extents = *cached;
+}
+
+/**
+ * Empties the cache, for example after the fonts or layout change. The cache is rebuilt as text is measured again.
+ */
+void text_metrics_clear(void) {
+	if (extents_cache != NULL) {
+		g_hash_table_remove_all(extents_cache);
+	}
+	g_slist_free_full(character_tables, g_free);
+	character_tables = NULL;
+
+	g_debug("Text metrics: %u measurements since last clear", measurements);
+	measurements = 0;
+}
+
+/**
+ * Frees the cache and the measuring context. Called from free_memory().
+ */
+void text_metrics_free(void) {
+	text_metrics_clear();
+	if (extents_cache != NULL) {
+		g_hash_table_destroy(extents_cache);
+		extents_cache = NULL;
+	}
+	if (measuring_context != NULL) {
+		cairo_destroy(measuring_context);
+		measuring_context = NULL;
+	}
+}
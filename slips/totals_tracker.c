@@ -0,0 +1,155 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <headers.h>
+
+/**
+ * @file totals_tracker.c
+ * @brief Keeps the totals of a checks store up to date from the store's signals.
+ *
+ * The tracker mirrors each row's amount in cents, so when a row changes or is deleted it knows the old amount without asking
+ * the model. Each edit updates the totals by the difference; nothing re-sums the store. The first two rows are on the front of
+ * the slip and the rest are on the back, so inserting or deleting one of the first two rows moves at most one amount across
+ * that boundary.
+ */
+
+/**
+ * Returns the side of the slip a row is on.
+ * @param row Row number.
+ * @return `TRUE` if the row is on the front.
+ */
+static gboolean on_front(gint row) {
+	return row < 2;
+}
+
+/**
+ * Adds an amount to the total of the side its row is on.
+ * @param tracker Pointer to the tracker.
+ * @param row Row number.
+ * @param cents Amount to add, negative to subtract.
+ */
+static void add_to_side(Totals_tracker *tracker, gint row, gint64 cents) {
+	if (on_front(row)) {
+		tracker->front_side += cents;
+	} else {
+		tracker->back_side += cents;
+	}
+	tracker->total += cents;
+}
+
+/**
+ * Callback fired when a row is inserted into the checks store. Shifts the mirrored amounts down one row; the amount that moves
+ * from the second row to the third crosses from the front to the back.
+ * @param model The checks store.
+ * @param path Path of the new row.
+ * @param iter Iterator of the new row.
+ * @param data Pointer to the tracker.
+ */
+static void row_inserted(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data) {
+	Totals_tracker *tracker = (Totals_tracker *)data;
+	gint row = gtk_tree_path_get_indices(path)[0];
+
+	if (tracker->n_rows >= MAXIMUM_CHECKS || row > tracker->n_rows) {
+		g_warning("Totals tracker: cannot track row %d of %d", row, tracker->n_rows);
+		return;
+	}
+
+	/* The amount in the second row moves to the back. */
+	if (on_front(row) && tracker->n_rows >= 2) {
+		tracker->front_side -= tracker->row_cents[1];
+		tracker->back_side += tracker->row_cents[1];
+	}
+	memmove(&tracker->row_cents[row + 1], &tracker->row_cents[row], (tracker->n_rows - row) * sizeof(gint64));
+	tracker->n_rows++;
+
+	gint64 cents;
+	gtk_tree_model_get(model, iter, CHECK_CENTS, &cents, -1);
+	tracker->row_cents[row] = cents;
+	add_to_side(tracker, row, cents);
+}
+
+/**
+ * Callback fired when a row in the checks store changes. Applies the difference between the new and the mirrored amount.
+ * @param model The checks store.
+ * @param path Path of the changed row.
+ * @param iter Iterator of the changed row.
+ * @param data Pointer to the tracker.
+ */
+static void row_changed(GtkTreeModel *model, GtkTreePath *path, GtkTreeIter *iter, gpointer data) {
+	Totals_tracker *tracker = (Totals_tracker *)data;
+	gint row = gtk_tree_path_get_indices(path)[0];
+
+	if (row >= tracker->n_rows) {
+		return;
+	}
+
+	gint64 cents;
+	gtk_tree_model_get(model, iter, CHECK_CENTS, &cents, -1);
+	add_to_side(tracker, row, cents - tracker->row_cents[row]);
+	tracker->row_cents[row] = cents;
+}
+
+/**
+ * Callback fired when a row is deleted from the checks store. Shifts the mirrored amounts up one row; the amount that moves
+ * from the third row to the second crosses from the back to the front.
+ * @param model The checks store.
+ * @param path Path the deleted row had.
+ * @param data Pointer to the tracker.
+ */
+static void row_deleted(GtkTreeModel *model, GtkTreePath *path, gpointer data) {
+	Totals_tracker *tracker = (Totals_tracker *)data;
+	gint row = gtk_tree_path_get_indices(path)[0];
+
+	if (row >= tracker->n_rows) {
+		return;
+	}
+
+	add_to_side(tracker, row, -tracker->row_cents[row]);
+	memmove(&tracker->row_cents[row], &tracker->row_cents[row + 1], (tracker->n_rows - row - 1) * sizeof(gint64));
+	tracker->n_rows--;
+
+	/* The amount now in the second row moves to the front. */
+	if (on_front(row) && tracker->n_rows >= 2) {
+		tracker->back_side -= tracker->row_cents[1];
+		tracker->front_side += tracker->row_cents[1];
+	}
+}
+
+/**
+ * Creates a tracker for a checks store and subscribes it to the store's signals. The store's current rows are summed once here.
+ * @param store Checks store to track. The tracker holds a reference to it.
+ * @return Pointer to the new tracker. Free with totals_tracker_free().
+ */
+Totals_tracker *totals_tracker_new(GtkListStore *store) {
+	Totals_tracker *tracker = g_new0(Totals_tracker, 1);
+	GtkTreeModel *model = GTK_TREE_MODEL(store);
+	GtkTreeIter iter;
+
+	tracker->store = g_object_ref(store);
+
+	gboolean valid = gtk_tree_model_get_iter_first(model, &iter);
+	while (valid && tracker->n_rows < MAXIMUM_CHECKS) {
+		gint64 cents;
+		gtk_tree_model_get(model, &iter, CHECK_CENTS, &cents, -1);
+		tracker->row_cents[tracker->n_rows] = cents;
+		add_to_side(tracker, tracker->n_rows, cents);
+		tracker->n_rows++;
+		valid = gtk_tree_model_iter_next(model, &iter);
+	}
+
+	g_signal_connect(store, "row-inserted", G_CALLBACK(row_inserted), tracker);
+	g_signal_connect(store, "row-changed", G_CALLBACK(row_changed), tracker);
+	g_signal_connect(store, "row-deleted", G_CALLBACK(row_deleted), tracker);
+
+	return tracker;
+}
+
+/**
+ * Disconnects a tracker from its store and frees it.
+ * @param tracker Pointer to the tracker.
+ */
+void totals_tracker_free(Totals_tracker *tracker) {
+	g_signal_handlers_disconnect_by_data(tracker->store, tracker);
+	g_object_unref(tracker->store);
+	g_free(tracker);
+}
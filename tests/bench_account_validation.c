@@ -0,0 +1,105 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file bench_account_validation.c
+ * @brief Benchmark of account_validation_run().
+ *
+ * Validates a table of \ref BENCH_ROWS accounts spread over \ref BENCH_BANKS routing numbers, one in every \ref BENCH_BAD_EVERY
+ * failing the checksum, and checks the same rows one at a time with routing_number_valid() for comparison. Fails if validating
+ * the table takes longer than \ref BENCH_MAXIMUM_USEC or if the problems found are not the rows made bad.
+ */
+
+/** Number of accounts in the table. */
+#define BENCH_ROWS 1000000
+
+/** Number of distinct routing numbers. */
+#define BENCH_BANKS 5000
+
+/** One row in this many has a routing number that fails the checksum. */
+#define BENCH_BAD_EVERY 1000
+
+/** Longest validation of the table accepted, in microseconds. */
+#define BENCH_MAXIMUM_USEC 250000
+
+/** Keeps the compiler from discarding results the benchmark does not otherwise use. */
+static volatile gsize sink;
+
+/**
+ * Writes a routing number that passes the checksum, or fails it if asked.
+ * @param bank Number of the bank, used for the first eight digits.
+ * @param valid Whether the routing number should pass.
+ * @param routing Buffer of at least ten bytes receiving the routing number.
+ */
+static void make_routing(guint bank, gboolean valid, gchar *routing) {
+	static const gint weights[8] = {3, 7, 1, 3, 7, 1, 3, 7};
+	g_snprintf(routing, 10, "%08u", 10000000 + bank * 7919);
+	gint sum = 0;
+	for (gint i = 0; i < 8; i++) {
+		sum += weights[i] * (routing[i] - '0');
+	}
+	/* The ninth digit has a weight of one, so it is whatever brings the sum to a multiple of ten. */
+	gint check_digit = (10 - sum % 10) % 10;
+	routing[8] = '0' + (valid ? check_digit : (check_digit + 1) % 10);
+	routing[9] = '\0';
+}
+
+/**
+ * Builds the table, times both passes, and compares the table's time with \ref BENCH_MAXIMUM_USEC.
+ * @return 0 if validation was fast enough and found exactly the bad rows, 1 otherwise.
+ */
+int main(void) {
+	Account_table *table = account_table_new();
+	for (guint row = 0; row < BENCH_ROWS; row++) {
+		gchar number[16];
+		gchar routing[10];
+		g_snprintf(number, sizeof(number), "%012u", 100000000 + row * 37);
+		make_routing(row % BENCH_BANKS, row % BENCH_BAD_EVERY != BENCH_BAD_EVERY - 1, routing);
+		account_table_add(table, number, "Holder", "Checking", routing);
+	}
+
+	gint64 start = g_get_monotonic_time();
+	GArray *problems = account_validation_run(table);
+	gint64 batched_usec = g_get_monotonic_time() - start;
+
+	/* One row at a time, as a loop over the list stores would check them. */
+	const Account *accounts = (const Account *)table->accounts->data;
+	gsize invalid = 0;
+	start = g_get_monotonic_time();
+	for (guint row = 0; row < BENCH_ROWS; row++) {
+		const gchar *number = account_table_string(table, accounts[row].number);
+		gboolean number_valid = strlen(number) >= 4 && strlen(number) <= 17;
+		for (const gchar *c = number; *c != '\0'; c++) {
+			number_valid = number_valid && g_ascii_isdigit(*c);
+		}
+		invalid += !number_valid + !routing_number_valid(account_table_string(table, accounts[row].routing));
+	}
+	gint64 single_usec = g_get_monotonic_time() - start;
+	sink = invalid;
+
+	g_print("account_validation_run             %7.1f ms for %d rows, %5.1f million rows/s\n", batched_usec / 1000.0, BENCH_ROWS,
+			(gdouble)BENCH_ROWS / MAX(batched_usec, 1));
+	g_print("row at a time (for comparison)     %7.1f ms for %d rows, %5.1f million rows/s\n", single_usec / 1000.0, BENCH_ROWS,
+			(gdouble)BENCH_ROWS / MAX(single_usec, 1));
+
+	gboolean found_bad_rows = problems->len == BENCH_ROWS / BENCH_BAD_EVERY;
+	for (guint i = 0; found_bad_rows && i < problems->len; i++) {
+		Account_problem *problem = &g_array_index(problems, Account_problem, i);
+		found_bad_rows = problem->row % BENCH_BAD_EVERY == BENCH_BAD_EVERY - 1 && problem->type == ACCOUNT_PROBLEM_ROUTING_CHECKSUM;
+	}
+	g_array_unref(problems);
+	account_table_free(table);
+
+	if (!found_bad_rows) {
+		g_print("FAIL: the problems found are not the rows with a bad checksum\n");
+		return 1;
+	}
+	if (batched_usec > BENCH_MAXIMUM_USEC) {
+		g_print("FAIL: validating %d rows takes longer than %d ms\n", BENCH_ROWS, BENCH_MAXIMUM_USEC / 1000);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,107 @@
+#include <gtk/gtk.h>
+#include <stdio.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file bench_amount_format.c
+ * @brief Benchmark of amount_format_cents(), amount_format_digits(), and amount_parse_cents().
+ *
+ * Formats and parses \ref BENCH_AMOUNTS amounts spread over the full range of `gint64`, and the same amounts with
+ * `g_snprintf()` and `g_ascii_strtod()` for comparison. Fails if any of the three functions handles fewer than
+ * \ref BENCH_MINIMUM_PER_SECOND amounts per second, or if a parsed amount differs from the one formatted.
+ */
+
+/** Number of amounts formatted and parsed in each pass. */
+#define BENCH_AMOUNTS 1000000
+
+/** Slowest rate accepted, in amounts per second. The batch and history code format millions of amounts. */
+#define BENCH_MINIMUM_PER_SECOND 5000000.0
+
+/** Keeps the compiler from discarding results the benchmark does not otherwise use. */
+static volatile gsize sink;
+
+/**
+ * Returns an amount from a spread of magnitudes, from cents to the largest `gint64`.
+ * @param i Index of the amount.
+ * @return The amount in cents.
+ */
+static gint64 amount_at(gint i) {
+	guint64 value = (guint64)i * 0x9E3779B97F4A7C15ull;
+	value >>= (i % 63) + 1;
+	return (i & 1) ? -(gint64)value : (gint64)value;
+}
+
+/**
+ * Prints one pass's rate.
+ * @param name Name of the pass.
+ * @param start When the pass started, from `g_get_monotonic_time()`.
+ * @return Amounts handled per second.
+ */
+static gdouble report(const gchar *name, gint64 start) {
+	gint64 elapsed = MAX(g_get_monotonic_time() - start, 1);
+	gdouble per_second = (gdouble)BENCH_AMOUNTS * G_USEC_PER_SEC / elapsed;
+	g_print("%-31s %6.1f million/s\n", name, per_second / 1e6);
+	return per_second;
+}
+
+/**
+ * Runs each pass and compares the rates with \ref BENCH_MINIMUM_PER_SECOND.
+ * @return 0 if every function was fast enough and every amount survived the round trip, 1 otherwise.
+ */
+int main(void) {
+	const Amount_separators grouped = {',', '.'};
+	gchar (*formatted)[AMOUNT_BUFFER_SIZE] = g_malloc(BENCH_AMOUNTS * AMOUNT_BUFFER_SIZE);
+	gchar buffer[AMOUNT_BUFFER_SIZE];
+	gsize total = 0;
+	gint mismatches = 0;
+
+	gint64 start = g_get_monotonic_time();
+	for (gint i = 0; i < BENCH_AMOUNTS; i++) {
+		total += amount_format_cents(amount_at(i), &grouped, formatted[i]);
+	}
+	gdouble format_rate = report("amount_format_cents", start);
+
+	start = g_get_monotonic_time();
+	for (gint i = 0; i < BENCH_AMOUNTS; i++) {
+		total += amount_format_digits(amount_at(i), 12, buffer);
+	}
+	gdouble digits_rate = report("amount_format_digits", start);
+
+	start = g_get_monotonic_time();
+	for (gint i = 0; i < BENCH_AMOUNTS; i++) {
+		gint64 cents = 0;
+		if (!amount_parse_cents(formatted[i], &grouped, &cents) || cents != amount_at(i)) {
+			mismatches++;
+		}
+	}
+	gdouble parse_rate = report("amount_parse_cents", start);
+
+	/* The calls the module replaced, on amounts small enough for a double to hold exactly. */
+	start = g_get_monotonic_time();
+	for (gint i = 0; i < BENCH_AMOUNTS; i++) {
+		total += g_snprintf(buffer, sizeof(buffer), "%3.2f", (amount_at(i) % 100000000000) / 100.0);
+	}
+	report("g_snprintf (for comparison)", start);
+
+	start = g_get_monotonic_time();
+	for (gint i = 0; i < BENCH_AMOUNTS; i++) {
+		total += (gsize)g_ascii_strtod(formatted[i], NULL);
+	}
+	report("g_ascii_strtod (for comparison)", start);
+
+	sink = total;
+	g_free(formatted);
+
+	if (mismatches > 0) {
+		g_print("FAIL: %d amounts did not parse back to the amount formatted\n", mismatches);
+		return 1;
+	}
+	if (format_rate < BENCH_MINIMUM_PER_SECOND || digits_rate < BENCH_MINIMUM_PER_SECOND ||
+		parse_rate < BENCH_MINIMUM_PER_SECOND) {
+		g_print("FAIL: slower than %.0f million amounts per second\n", BENCH_MINIMUM_PER_SECOND / 1e6);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,90 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file bench_deposit_file.c
+ * @brief Benchmark of opening a directory of saved deposits with deposit_file_open_directory().
+ *
+ * Saves \ref BENCH_DEPOSITS deposits of \ref BENCH_CHECKS checks each into a temporary directory, then opens the directory
+ * \ref BENCH_PASSES times and reads every amount, as Open All does before batch printing. Fails if the fastest pass takes
+ * longer than \ref BENCH_MAXIMUM_MSEC.
+ */
+
+/** Number of deposits saved. */
+#define BENCH_DEPOSITS 10000
+
+/** Number of checks in each deposit. */
+#define BENCH_CHECKS 5
+
+/** Number of times the directory is opened. */
+#define BENCH_PASSES 3
+
+/** Longest the fastest pass may take, in milliseconds. */
+#define BENCH_MAXIMUM_MSEC 200.0
+
+/**
+ * Saves the deposits, opens them, and removes them.
+ * @return 0 if every deposit opened within \ref BENCH_MAXIMUM_MSEC, 1 otherwise.
+ */
+int main(void) {
+	gchar *directory = g_dir_make_tmp("deposit-slips-bench-XXXXXX", NULL);
+	GtkListStore *checks = gtk_list_store_new(SLIP_COLUMNS, G_TYPE_STRING, G_TYPE_BOOLEAN, G_TYPE_INT64);
+	gdouble fastest_msec = G_MAXDOUBLE;
+	guint opened = 0;
+
+	for (gint i = 0; i < BENCH_CHECKS; i++) {
+		gtk_list_store_insert_with_values(checks, NULL, -1, CHECK_AMOUNT, "12.34", CHECK_RADIO, FALSE, CHECK_CENTS, (gint64)1234, -1);
+	}
+	for (gint i = 0; i < BENCH_DEPOSITS; i++) {
+		gchar account_number[16];
+		g_snprintf(account_number, sizeof(account_number), "%d", 100000 + i);
+		gchar *name = g_strconcat(account_number, ".dslip", NULL);
+		gchar *path = g_build_filename(directory, name, NULL);
+		deposit_file_save(path, account_number, GTK_TREE_MODEL(checks));
+		g_free(path);
+		g_free(name);
+	}
+
+	for (gint pass = 0; pass < BENCH_PASSES; pass++) {
+		gint64 total = 0;
+		gint64 start = g_get_monotonic_time();
+		GPtrArray *files = deposit_file_open_directory(directory);
+		for (guint i = 0; i < files->len; i++) {
+			const Deposit_file *file = g_ptr_array_index(files, i);
+			for (guint j = 0; j < file->n_checks; j++) {
+				total += file->cents[j];
+			}
+		}
+		gdouble msec = (g_get_monotonic_time() - start) / 1000.0;
+		opened = files->len;
+		g_ptr_array_unref(files);
+
+		g_print("opened %u deposits holding %" G_GINT64_FORMAT " cents in %.1f ms\n", opened, total, msec);
+		fastest_msec = MIN(fastest_msec, msec);
+	}
+
+	GDir *dir = g_dir_open(directory, 0, NULL);
+	const gchar *name;
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		gchar *path = g_build_filename(directory, name, NULL);
+		g_unlink(path);
+		g_free(path);
+	}
+	g_dir_close(dir);
+	g_rmdir(directory);
+	g_free(directory);
+	g_object_unref(checks);
+
+	if (opened != BENCH_DEPOSITS) {
+		g_print("FAIL: %u of %d deposits opened\n", opened, BENCH_DEPOSITS);
+		return 1;
+	}
+	if (fastest_msec > BENCH_MAXIMUM_MSEC) {
+		g_print("FAIL: opening %d deposits took more than %.0f ms\n", BENCH_DEPOSITS, BENCH_MAXIMUM_MSEC);
+		return 1;
+	}
+	return 0;
+}
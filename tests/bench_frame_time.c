@@ -0,0 +1,273 @@
+#include <gtk/gtk.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file bench_frame_time.c
+ * @brief Benchmark of the time the UI thread spends on a frame of the preview, with the render thread running.
+ *
+ * Creates the preview renderer with preview_renderer_new(), so its render thread rasterizes every snapshot, over a preview area
+ * \ref BENCH_WIDTH points wide in an offscreen window. `GDK_SCALE` is set to \ref BENCH_SCALE_FACTOR unless already set, so the
+ * area has the scale factor of a HiDPI screen. A frame after an edit costs the UI thread three things: rewriting the edited
+ * check's fields and handing a copy of the display list to the render thread with preview_renderer_invalidate(), taking the
+ * image back when the render thread is done, and painting it with draw_preview(). Each edit also discards the image of the
+ * side not shown, as redraw_scheduler.c does, so the render thread renders that side again once idle. The slip is shaped like
+ * the back of one holding \ref MAXIMUM_CHECKS checks.
+ *
+ * Two passes of \ref BENCH_FRAMES frames are timed. In the first, each edit waits for its image, as when typing is slower than
+ * rendering. The UI thread's time is the edit and the paint; the time from the edit to the image being ready and the render
+ * thread's own time are reported with it. In the second, edits follow one another without waiting, as when typing is faster, so
+ * the render thread is busy while the UI thread works and snapshots replace each other while they wait. The UI thread's time then
+ * also counts running the main loop's pending callbacks, which take images back and send the waiting snapshot. Replaying the list in the `draw` handler, as the preview did before the render
+ * thread, is timed alongside for comparison.
+ *
+ * Fails if the 99th percentile of the UI thread's time for a frame exceeds \ref BENCH_MAXIMUM_FRAME_USEC in either pass. GTK
+ * needs a display even for an offscreen window; on a machine without one, run `xvfb-run make bench`.
+ */
+
+/** Number of frames timed. */
+#define BENCH_FRAMES 5000
+
+/** Width of the preview area in points. */
+#define BENCH_WIDTH 1200
+
+/** Scale factor of the preview area, as on a HiDPI screen. */
+#define BENCH_SCALE_FACTOR 2
+
+/** Longest the UI thread may take for a frame, in microseconds. */
+#define BENCH_MAXIMUM_FRAME_USEC 2000
+
+/**
+ * Compiles a list shaped like the back of a slip holding every check: a grid of boxes, labels, and one digit field per check.
+ * @param list Pointer to the list.
+ */
+static void compile_list(Slip_display_list *list) {
+	g_strlcpy(list->font_families[SLIP_FONT_SANS], "Sans", sizeof(list->font_families[0]));
+	g_strlcpy(list->font_families[SLIP_FONT_MONO_BOLD], "Monospace", sizeof(list->font_families[0]));
+
+	for (gint check = 0; check < MAXIMUM_CHECKS; check++) {
+		slip_add_rectangle(list, 10, 10 + check * 9, 410, 9, 0.5, 0);
+		slip_add_text(list, SLIP_FONT_SANS, 6, 12, 17 + check * 9, "Check", 0);
+	}
+	slip_display_list_batch_strokes(list);
+	for (gint check = 0; check < MAXIMUM_CHECKS; check++) {
+		slip_reserve_field(list, SLIP_FIELD_CHECK_FIRST + check, SLIP_AMOUNT_FIELD_OPS);
+	}
+}
+
+/**
+ * Writes a check's amount into its digit field, as slip_update_check() does.
+ * @param list Pointer to the list.
+ * @param check Row of the check.
+ * @param cents Amount in cents.
+ */
+static void write_check(Slip_display_list *list, gint check, gint64 cents) {
+	gchar digits[AMOUNT_BUFFER_SIZE];
+	gint length = amount_format_digits(cents, 3, digits);
+
+	for (gint i = 0; i < SLIP_AMOUNT_FIELD_OPS; i++) {
+		gchar digit[2] = {i < length ? digits[length - 1 - i] : '\0', '\0'};
+		slip_set_text_op(slip_field_op(list, SLIP_FIELD_CHECK_FIRST + check, i), FALSE, SLIP_FONT_MONO_BOLD, 9, 400 - i * 8,
+						 17 + check * 9, digit, 0);
+	}
+}
+
+/**
+ * Compares two times for qsort().
+ * @param a Pointer to the first time.
+ * @param b Pointer to the second time.
+ * @return Negative, zero, or positive as the first time is shorter, equal, or longer.
+ */
+static int compare_usec(const void *a, const void *b) {
+	gint64 difference = *(const gint64 *)a - *(const gint64 *)b;
+	return (difference > 0) - (difference < 0);
+}
+
+/**
+ * Sorts frame times and prints their mean, 99th percentile, and worst.
+ * @param name Name of the pass.
+ * @param usec Time of each frame in microseconds, sorted in place.
+ * @return The 99th percentile, in microseconds.
+ */
+static gint64 report(const gchar *name, gint64 *usec) {
+	gint64 total = 0;
+	for (gint i = 0; i < BENCH_FRAMES; i++) {
+		total += usec[i];
+	}
+	qsort(usec, BENCH_FRAMES, sizeof(gint64), compare_usec);
+	gint64 percentile = usec[BENCH_FRAMES * 99 / 100];
+	g_print("%-34s mean %7.1f us, 99th percentile %6" G_GINT64_FORMAT " us, worst %6" G_GINT64_FORMAT " us\n", name,
+			(gdouble)total / BENCH_FRAMES, percentile, usec[BENCH_FRAMES - 1]);
+	return percentile;
+}
+
+/**
+ * Runs the main loop until the render thread has drawn the latest snapshot, nothing waits to be sent, and no image of the side
+ * not shown is waiting to be rendered.
+ * @param renderer Pointer to the renderer.
+ */
+static void wait_for_idle(Preview_renderer *renderer) {
+	while (renderer->in_flight || renderer->next != NULL || renderer->speculate_id != 0) {
+		g_main_context_iteration(NULL, TRUE);
+	}
+}
+
+/**
+ * Edits one check and hands the slip to the render thread, as the redraw scheduler does after an amount is edited.
+ * @param data_passer Pointer to user data.
+ * @param frame Number of the frame, which picks the check and its amount.
+ */
+static void edit_frame(Data_passer *data_passer, gint frame) {
+	write_check(data_passer->slip_back, frame % MAXIMUM_CHECKS, (gint64)frame * 1013);
+	preview_renderer_discard_hidden(data_passer->preview_renderer);
+	preview_renderer_invalidate(data_passer);
+}
+
+/**
+ * Paints the preview into the window surface through the preview area's `draw` handler.
+ * @param data_passer Pointer to user data.
+ * @param cr Cairo context of the window surface.
+ */
+static void paint_frame(Data_passer *data_passer, cairo_t *cr) {
+	draw_preview(data_passer->drawing_area, cr, data_passer);
+	cairo_surface_flush(cairo_get_target(cr));
+}
+
+/**
+ * Times the frames and compares the UI thread's time with \ref BENCH_MAXIMUM_FRAME_USEC.
+ * @param argc Number of command-line arguments, passed to GTK.
+ * @param argv Command-line arguments, passed to GTK.
+ * @return 0 if frames stayed within the budget, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+	gchar scale_factor_text[8];
+	g_snprintf(scale_factor_text, sizeof(scale_factor_text), "%d", BENCH_SCALE_FACTOR);
+	g_setenv("GDK_SCALE", scale_factor_text, FALSE);
+	if (!gtk_init_check(&argc, &argv)) {
+		g_print("FAIL: GTK could not open a display; run under xvfb-run\n");
+		return 1;
+	}
+
+	Data_passer *data_passer = g_new0(Data_passer, 1);
+	gint64 *cents = g_new(gint64, MAXIMUM_CHECKS);
+	gint64 *edit_usec = g_new(gint64, BENCH_FRAMES);
+	gint64 *frame_usec = g_new(gint64, BENCH_FRAMES);
+	gint64 *latency_usec = g_new(gint64, BENCH_FRAMES);
+	gint64 *render_usec = g_new(gint64, BENCH_FRAMES);
+	gint64 *burst_usec = g_new(gint64, BENCH_FRAMES);
+	gint64 *replay_usec = g_new(gint64, BENCH_FRAMES);
+
+	/* A full deposit, so the side not shown is rendered ahead as with a real back. */
+	for (gint check = 0; check < MAXIMUM_CHECKS; check++) {
+		cents[check] = 123456;
+	}
+	data_passer->deposit = g_new0(Deposit, 1);
+	data_passer->deposit->checks_store = checks_store_from_cents(cents, MAXIMUM_CHECKS);
+	data_passer->slip_back = slip_display_list_new();
+	data_passer->slip_front = data_passer->slip_back;
+	data_passer->front_slip_active = FALSE;
+	compile_list(data_passer->slip_back);
+	for (gint check = 0; check < MAXIMUM_CHECKS; check++) {
+		write_check(data_passer->slip_back, check, cents[check]);
+	}
+
+	GtkWidget *window = gtk_offscreen_window_new();
+	data_passer->drawing_area = gtk_drawing_area_new();
+	gtk_widget_set_size_request(data_passer->drawing_area, BENCH_WIDTH, (gint)ceil((gdouble)BENCH_WIDTH * SLIP_HEIGHT / SLIP_WIDTH));
+	gtk_container_add(GTK_CONTAINER(window), data_passer->drawing_area);
+	gtk_widget_show_all(window);
+	while (g_main_context_iteration(NULL, FALSE)) {
+	}
+	data_passer->frame_stats = frame_stats_new();
+	data_passer->preview_renderer = preview_renderer_new(data_passer);
+	Preview_renderer *renderer = data_passer->preview_renderer;
+
+	/* The window surface the preview area is painted into, at the size and scale factor GTK gave it. */
+	gint width = gtk_widget_get_allocated_width(data_passer->drawing_area);
+	gint height = (gint)ceil((gdouble)width * SLIP_HEIGHT / SLIP_WIDTH);
+	gint scale_factor = gtk_widget_get_scale_factor(data_passer->drawing_area);
+	cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width * scale_factor, height * scale_factor);
+	cairo_surface_set_device_scale(surface, scale_factor, scale_factor);
+	cairo_t *cr = cairo_create(surface);
+
+	/* The first draw sets the renderer's size and asks for the first image. */
+	paint_frame(data_passer, cr);
+	wait_for_idle(renderer);
+
+	for (gint frame = 0; frame < BENCH_FRAMES; frame++) {
+		gint64 start = g_get_monotonic_time();
+		edit_frame(data_passer, frame);
+		gint64 edited = g_get_monotonic_time();
+		while (renderer->in_flight || renderer->next != NULL) {
+			g_main_context_iteration(NULL, TRUE);
+		}
+		gint64 ready = g_get_monotonic_time();
+		paint_frame(data_passer, cr);
+		gint64 end = g_get_monotonic_time();
+		edit_usec[frame] = edited - start;
+		frame_usec[frame] = (edited - start) + (end - ready);
+		latency_usec[frame] = ready - start;
+		render_usec[frame] = data_passer->frame_stats->last_render_usec;
+		wait_for_idle(renderer);
+	}
+
+	guint allocations_before_burst = renderer->heap_allocations;
+	for (gint frame = 0; frame < BENCH_FRAMES; frame++) {
+		gint64 start = g_get_monotonic_time();
+		edit_frame(data_passer, frame);
+		while (g_main_context_iteration(NULL, FALSE)) {
+		}
+		paint_frame(data_passer, cr);
+		burst_usec[frame] = g_get_monotonic_time() - start;
+	}
+	wait_for_idle(renderer);
+	guint burst_allocations = renderer->heap_allocations - allocations_before_burst;
+
+	for (gint frame = 0; frame < BENCH_FRAMES; frame++) {
+		gint64 start = g_get_monotonic_time();
+		write_check(data_passer->slip_back, frame % MAXIMUM_CHECKS, (gint64)frame * 1013);
+		cairo_save(cr);
+		cairo_set_source_rgb(cr, 1, 1, 1);
+		cairo_paint(cr);
+		cairo_scale(cr, (gdouble)width / SLIP_WIDTH, (gdouble)width / SLIP_WIDTH);
+		slip_display_list_replay(data_passer->slip_back, cr);
+		cairo_restore(cr);
+		cairo_surface_flush(surface);
+		replay_usec[frame] = g_get_monotonic_time() - start;
+	}
+	cairo_destroy(cr);
+
+	g_print("preview area %d x %d points at scale factor %d\n", width, height, scale_factor);
+	report("edit and snapshot", edit_usec);
+	gint64 frame_percentile = report("UI thread frame (edit and paint)", frame_usec);
+	report("render thread image", render_usec);
+	report("edit to image ready", latency_usec);
+	gint64 burst_percentile = report("UI thread frame, edits not waiting", burst_usec);
+	report("replay in draw handler (before)", replay_usec);
+	g_print("snapshot heap allocations while edits did not wait: %u\n", burst_allocations);
+
+	preview_renderer_free(renderer);
+	gtk_widget_destroy(window);
+	cairo_surface_destroy(surface);
+	slip_display_list_free(data_passer->slip_back);
+	g_object_unref(data_passer->deposit->checks_store);
+	g_free(data_passer->deposit);
+	g_free(data_passer->frame_stats);
+	g_free(data_passer);
+	g_free(cents);
+	g_free(edit_usec);
+	g_free(frame_usec);
+	g_free(latency_usec);
+	g_free(render_usec);
+	g_free(burst_usec);
+	g_free(replay_usec);
+
+	if (frame_percentile > BENCH_MAXIMUM_FRAME_USEC || burst_percentile > BENCH_MAXIMUM_FRAME_USEC) {
+		g_print("FAIL: the UI thread takes more than %d us for 1 frame in 100\n", BENCH_MAXIMUM_FRAME_USEC);
+		return 1;
+	}
+	return 0;
+}
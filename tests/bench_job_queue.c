@@ -0,0 +1,102 @@
+#include <gtk/gtk.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file bench_job_queue.c
+ * @brief Throughput benchmark of job_queue.c.
+ *
+ * Hands \ref BENCH_HANDOFFS jobs from producer threads to consumer threads, first with one of each, as between the UI thread and
+ * the render thread, then with three producers and two consumers. Fails if either falls below \ref BENCH_MINIMUM_PER_SECOND
+ * handoffs per second.
+ */
+
+/** Number of jobs handed off in each pass. */
+#define BENCH_HANDOFFS 10000000
+
+/** Slowest rate accepted, in handoffs per second. */
+#define BENCH_MINIMUM_PER_SECOND 1000000.0
+
+/** Capacity of the queue, as used by the preview renderer. */
+#define BENCH_CAPACITY 256
+
+/** Queue shared by the threads. */
+static Job_queue *queue;
+
+/** Number of jobs each producer pushes in the current pass. */
+static guint jobs_per_producer;
+
+/**
+ * Pushes the producer's jobs, yielding while the queue is full.
+ * @param data Unused.
+ * @return `NULL`.
+ */
+static gpointer produce(gpointer data) {
+	for (guint job = 1; job <= jobs_per_producer; job++) {
+		while (!job_queue_push(queue, GUINT_TO_POINTER(job))) {
+			g_thread_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Pops jobs until the queue is closed and empty.
+ * @param data Unused.
+ * @return `NULL`.
+ */
+static gpointer consume(gpointer data) {
+	while (job_queue_pop_wait(queue) != NULL) {
+	}
+	return NULL;
+}
+
+/**
+ * Hands off \ref BENCH_HANDOFFS jobs and prints the rate.
+ * @param n_producers Number of producer threads.
+ * @param n_consumers Number of consumer threads.
+ * @return Handoffs per second.
+ */
+static gdouble run_pass(gint n_producers, gint n_consumers) {
+	GThread *producers[n_producers];
+	GThread *consumers[n_consumers];
+
+	queue = job_queue_new(BENCH_CAPACITY);
+	jobs_per_producer = BENCH_HANDOFFS / n_producers;
+	gint64 start = g_get_monotonic_time();
+	for (gint i = 0; i < n_consumers; i++) {
+		consumers[i] = g_thread_new("consumer", consume, NULL);
+	}
+	for (gint i = 0; i < n_producers; i++) {
+		producers[i] = g_thread_new("producer", produce, NULL);
+	}
+	for (gint i = 0; i < n_producers; i++) {
+		g_thread_join(producers[i]);
+	}
+	job_queue_close(queue);
+	for (gint i = 0; i < n_consumers; i++) {
+		g_thread_join(consumers[i]);
+	}
+	gint64 elapsed = MAX(g_get_monotonic_time() - start, 1);
+	job_queue_free(queue);
+
+	gdouble per_second = (gdouble)jobs_per_producer * n_producers * G_USEC_PER_SEC / elapsed;
+	g_print("%d producer(s), %d consumer(s): %5.1f million handoffs/s\n", n_producers, n_consumers, per_second / 1e6);
+	return per_second;
+}
+
+/**
+ * Runs both passes.
+ * @return 0 if both reached \ref BENCH_MINIMUM_PER_SECOND, 1 otherwise.
+ */
+int main(void) {
+	gdouble single = run_pass(1, 1);
+	gdouble multiple = run_pass(3, 2);
+
+	if (single < BENCH_MINIMUM_PER_SECOND || multiple < BENCH_MINIMUM_PER_SECOND) {
+		g_print("FAIL: fewer than %.0f million handoffs per second\n", BENCH_MINIMUM_PER_SECOND / 1e6);
+		return 1;
+	}
+	return 0;
+}
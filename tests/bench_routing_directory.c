@@ -0,0 +1,137 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file bench_routing_directory.c
+ * @brief Benchmark of routing_directory_open() and routing_directory_lookup().
+ *
+ * Writes a directory of \ref BENCH_BANKS banks in the Federal Reserve's fixed-width format to a temporary directory, times
+ * compiling its index and opening the index again once compiled, and then times \ref BENCH_LOOKUPS lookups, half of routing
+ * numbers in the directory and half of routing numbers that are not. Fails if a lookup finds the wrong bank or if lookups run
+ * slower than \ref BENCH_MINIMUM_PER_SECOND.
+ */
+
+/** Number of banks in the directory, about as many as in the Federal Reserve's. */
+#define BENCH_BANKS 20000
+
+/** Number of lookups timed. */
+#define BENCH_LOOKUPS 1000000
+
+/** Slowest rate accepted, in lookups per second. Validating an imported table looks up every row. */
+#define BENCH_MINIMUM_PER_SECOND 2000000.0
+
+/**
+ * Writes the routing number of a bank, with a check digit that passes the checksum.
+ * @param bank Number of the bank. Even numbers are in the directory, odd numbers are not.
+ * @param routing Buffer of at least ten bytes receiving the routing number.
+ */
+static void make_routing(guint bank, gchar *routing) {
+	static const gint weights[8] = {3, 7, 1, 3, 7, 1, 3, 7};
+	g_snprintf(routing, 10, "%08u", 1000000 + bank * 97);
+	gint sum = 0;
+	for (gint i = 0; i < 8; i++) {
+		sum += weights[i] * (routing[i] - '0');
+	}
+	routing[8] = '0' + (10 - sum % 10) % 10;
+	routing[9] = '\0';
+}
+
+/**
+ * Writes the directory, every even-numbered bank on a line of the fixed width read by routing_directory.c.
+ * @param path Path of the directory.
+ */
+static void write_directory(const gchar *path) {
+	GString *contents = g_string_sized_new(BENCH_BANKS * 156);
+	for (guint bank = 0; bank < 2 * BENCH_BANKS; bank += 2) {
+		gchar routing[10];
+		gchar line[156];
+		make_routing(bank, routing);
+		memset(line, ' ', 155);
+		line[155] = '\0';
+		memcpy(line, routing, 9);
+		line[9] = 'O';
+		line[19] = '0';
+		gchar name[37];
+		gint length = g_snprintf(name, sizeof(name), "BANK %u", bank);
+		memcpy(line + 35, name, length);
+		g_string_append(contents, line);
+		g_string_append_c(contents, '\n');
+	}
+	g_file_set_contents(path, contents->str, contents->len, NULL);
+	g_string_free(contents, TRUE);
+}
+
+/**
+ * Writes the directory, times opening it and looking up routing numbers, and compares the rate with \ref BENCH_MINIMUM_PER_SECOND.
+ * @return 0 if every lookup was right and lookups were fast enough, 1 otherwise.
+ */
+int main(void) {
+	gchar *directory = g_dir_make_tmp("deposit-slips-bench-XXXXXX", NULL);
+	gchar *directory_path = g_build_filename(directory, "FedACHdir.txt", NULL);
+	gchar *index_path = g_build_filename(directory, "routing_index.bin", NULL);
+	write_directory(directory_path);
+
+	gint64 start = g_get_monotonic_time();
+	routing_directory_open(directory_path, index_path);
+	gint64 compile_usec = g_get_monotonic_time() - start;
+	routing_directory_close();
+
+	start = g_get_monotonic_time();
+	routing_directory_open(directory_path, index_path);
+	gint64 open_usec = g_get_monotonic_time() - start;
+
+	/* Routing numbers are made before timing, so only the lookups are timed. */
+	gchar (*routing)[10] = g_malloc(BENCH_LOOKUPS * 10);
+	for (guint i = 0; i < BENCH_LOOKUPS; i++) {
+		make_routing((i * 7919u) % (2 * BENCH_BANKS), routing[i]);
+	}
+
+	gint wrong = 0;
+	start = g_get_monotonic_time();
+	for (guint i = 0; i < BENCH_LOOKUPS; i++) {
+		const Routing_entry *entry = routing_directory_lookup(routing[i]);
+		gboolean in_directory = ((i * 7919u) % (2 * BENCH_BANKS)) % 2 == 0;
+		if ((entry != NULL) != in_directory) {
+			wrong++;
+		}
+	}
+	gint64 lookup_usec = MAX(g_get_monotonic_time() - start, 1);
+	gdouble per_second = (gdouble)BENCH_LOOKUPS * G_USEC_PER_SEC / lookup_usec;
+
+	/* Spot-check that a found entry is the bank on that line. */
+	gchar expected_name[37];
+	g_snprintf(expected_name, sizeof(expected_name), "BANK %u", 2 * (BENCH_BANKS / 2));
+	gchar spot[10];
+	make_routing(2 * (BENCH_BANKS / 2), spot);
+	const Routing_entry *entry = routing_directory_lookup(spot);
+	if (entry == NULL || strcmp(entry->bank_name, expected_name) != 0 || entry->office_code != 'O') {
+		wrong++;
+	}
+
+	g_print("compile and map the index          %7.1f ms for %d banks\n", compile_usec / 1000.0, BENCH_BANKS);
+	g_print("map the compiled index             %7.1f ms\n", open_usec / 1000.0);
+	g_print("routing_directory_lookup           %7.1f million/s\n", per_second / 1e6);
+
+	routing_directory_close();
+	g_free(routing);
+	g_unlink(index_path);
+	g_unlink(directory_path);
+	g_rmdir(directory);
+	g_free(index_path);
+	g_free(directory_path);
+	g_free(directory);
+
+	if (wrong > 0) {
+		g_print("FAIL: %d lookups found the wrong bank or none\n", wrong);
+		return 1;
+	}
+	if (per_second < BENCH_MINIMUM_PER_SECOND) {
+		g_print("FAIL: slower than %.0f million lookups per second\n", BENCH_MINIMUM_PER_SECOND / 1e6);
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,257 @@
+#include <gtk/gtk.h>
+#include <cairo-pdf.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file soak_frame_memory.c
+ * @brief Soak test of the memory used to edit checks, draw preview frames, and print pages.
+ *
+ * Builds the Slip tab with make_slip_view() in an offscreen window, over real list stores of accounts, so each deposit has its
+ * real checks store, totals tracker, and selection set, and the preview has its render thread. Then runs \ref SOAK_ITERATIONS
+ * frames through the application's own callbacks: add_check_row() until the slip is full, deposit_amount_edited() on one check
+ * each frame, and check_toggle_clicked() and delete_check_rows() every fiftieth frame. After each edit the main loop runs until
+ * the edit is applied and the render thread has drawn it, and draw_preview() paints the preview onto an image surface. Every
+ * tenth frame draw_slip_pages() prints the slip onto a PDF surface, every hundredth compiles the slip again, as a reload of the
+ * layout does, and every two hundredth switches to the other account's deposit.
+ *
+ * After \ref SOAK_WARMUP frames, which let cairo, fontconfig, and GTK fill their caches, the heap in use, the frame arena's heap
+ * allocations, and the preview renderer's heap allocations are sampled. The test fails if any has grown by the end. The resident
+ * set size is printed alongside, for runs under valgrind or AddressSanitizer that change how the heap is counted.
+ *
+ * GTK needs a display even for an offscreen window; on a machine without one, run `xvfb-run make soak`.
+ */
+
+/** Number of frames drawn. */
+#define SOAK_ITERATIONS 20000
+
+/** Number of frames drawn before memory is first sampled. */
+#define SOAK_WARMUP 1000
+
+/** Growth of the heap in use, in bytes, tolerated between the first and last samples. */
+#define SOAK_HEAP_SLACK (64 * 1024)
+
+/** Width of the preview area, in points. */
+#define SOAK_PREVIEW_WIDTH 500
+
+/**
+ * Returns the number of bytes of heap in use.
+ * @return Bytes allocated with `malloc()` and not yet freed.
+ */
+static gsize heap_in_use(void) {
+	return mallinfo2().uordblks;
+}
+
+/**
+ * Returns the resident set size of the process.
+ * @return Resident set size in kilobytes, or 0 if it cannot be read.
+ */
+static glong resident_kilobytes(void) {
+	glong pages = 0;
+	FILE *statm = fopen("/proc/self/statm", "r");
+	if (statm != NULL) {
+		if (fscanf(statm, "%*ld %ld", &pages) != 1) {
+			pages = 0;
+		}
+		fclose(statm);
+	}
+	return pages * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+/**
+ * Discards the output of a PDF surface.
+ * @param closure Unused.
+ * @param data Output of the surface.
+ * @param length Number of bytes of output.
+ * @return `CAIRO_STATUS_SUCCESS`.
+ */
+static cairo_status_t discard_output(void *closure, const unsigned char *data, unsigned int length) {
+	return CAIRO_STATUS_SUCCESS;
+}
+
+/**
+ * Sets up user data the way on_app_activate() does, with two accounts and the default layout, and without reading the
+ * configuration file, the routing directory, the history, or the render cache.
+ * @return Pointer to user data. Freed by free_memory() when the window is destroyed.
+ */
+static Data_passer *make_data_passer(void) {
+	Data_passer *data_passer = g_new0(Data_passer, 1);
+
+	data_passer->front_slip_active = TRUE;
+	data_passer->frame_arena = frame_arena_new(4096);
+	data_passer->css_provider = gtk_css_provider_new();
+	data_passer->layout = slip_layout_new();
+	g_strlcpy(data_passer->font_family_sans, "Sans", sizeof(data_passer->font_family_sans));
+	g_strlcpy(data_passer->font_family_mono, "Monospace", sizeof(data_passer->font_family_mono));
+	g_strlcpy(data_passer->font_face_micr, "Monospace", sizeof(data_passer->font_face_micr));
+
+	data_passer->list_store_master = gtk_list_store_new(N_COLUMNS, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
+	data_passer->list_store_temporary = gtk_list_store_new(N_COLUMNS, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
+	data_passer->account_table = account_table_new();
+	account_table_add(data_passer->account_table, "10012345", "Account Holder", "Checking", "011000015");
+	account_table_add(data_passer->account_table, "20067890", "Second Holder", "Savings", "021000021");
+	build_list_store(data_passer->account_table, data_passer->list_store_master);
+	build_list_store(data_passer->account_table, data_passer->list_store_temporary);
+	return data_passer;
+}
+
+/**
+ * Runs the main loop until pending edits are applied to the display lists and the render thread has drawn them.
+ * @param data_passer Pointer to user data.
+ */
+static void settle(Data_passer *data_passer) {
+	Preview_renderer *renderer = data_passer->preview_renderer;
+
+	while (g_main_context_iteration(NULL, FALSE)) {
+	}
+	while (data_passer->redraw.idle_id != 0 || renderer->in_flight || renderer->next != NULL) {
+		g_main_context_iteration(NULL, TRUE);
+	}
+}
+
+/**
+ * Selects an account in the Slip tab, switching to its deposit through slip_account_changed().
+ * @param data_passer Pointer to user data.
+ * @param row Row of the account.
+ */
+static void select_account(Data_passer *data_passer, gint row) {
+	GtkTreePath *path = gtk_tree_path_new_from_indices(row, -1);
+	gtk_tree_view_set_cursor(GTK_TREE_VIEW(data_passer->checks_accounts_treeview), path, NULL, FALSE);
+	gtk_tree_path_free(path);
+}
+
+/**
+ * Edits the checks of the current deposit for one frame through the checks view's callbacks.
+ * @param data_passer Pointer to user data.
+ * @param frame Number of the frame, which varies the amounts and the rows edited.
+ */
+static void edit_checks(Data_passer *data_passer, gint frame) {
+	gchar path[16];
+	gchar amount[32];
+
+	if (number_of_checks(data_passer) < MAXIMUM_CHECKS) {
+		add_check_row(data_passer->btn_checks_add, data_passer);
+	}
+
+	g_snprintf(path, sizeof(path), "%d", frame % number_of_checks(data_passer));
+	g_snprintf(amount, sizeof(amount), "%d.%02d", (frame * 7919) % 100000, frame % 100);
+	deposit_amount_edited(NULL, path, amount, data_passer);
+
+	/* Mark every third check and delete them, as the user does with the Delete checkboxes and button. */
+	if (frame % 50 == 49) {
+		for (gint row = number_of_checks(data_passer) - 1; row >= 0; row -= 3) {
+			g_snprintf(path, sizeof(path), "%d", row);
+			check_toggle_clicked(NULL, path, data_passer);
+		}
+		delete_check_rows(data_passer->btn_checks_delete, data_passer);
+	}
+}
+
+/**
+ * Prints the slip as it stands onto a PDF surface whose output is discarded.
+ * @param data_passer Pointer to user data.
+ */
+static void print_to_pdf(Data_passer *data_passer) {
+	cairo_surface_t *pdf = cairo_pdf_surface_create_for_stream(discard_output, NULL, 612, 792);
+	cairo_t *cr = cairo_create(pdf);
+	draw_slip_pages(data_passer, cr, number_of_checks(data_passer) > 2, 612);
+	cairo_show_page(cr);
+	cairo_destroy(cr);
+	cairo_surface_finish(pdf);
+	cairo_surface_destroy(pdf);
+}
+
+/**
+ * Draws the frames and compares the memory in use after the warm-up with the memory in use at the end.
+ * @param argc Number of command-line arguments, passed to GTK.
+ * @param argv Command-line arguments, passed to GTK.
+ * @return 0 if memory stayed bounded, 1 otherwise.
+ */
+int main(int argc, char *argv[]) {
+	if (!gtk_init_check(&argc, &argv)) {
+		g_print("FAIL: GTK could not open a display; run under xvfb-run\n");
+		return 1;
+	}
+
+	Data_passer *data_passer = make_data_passer();
+	GtkWidget *window = gtk_offscreen_window_new();
+	gtk_container_add(GTK_CONTAINER(window), make_slip_view(data_passer));
+	gtk_widget_set_size_request(data_passer->drawing_area, SOAK_PREVIEW_WIDTH, SOAK_PREVIEW_WIDTH * SLIP_HEIGHT / SLIP_WIDTH);
+	/* free_memory() runs first, while the views it disconnects from still exist. */
+	g_signal_connect(window, "destroy", G_CALLBACK(free_memory), data_passer);
+	gtk_widget_show_all(window);
+
+	select_account(data_passer, 0);
+	slip_compile(data_passer);
+	slip_redraw_schedule(data_passer, SLIP_DIRTY_PREVIEW, REDRAW_SOURCE_APP);
+	/* Let the window lay itself out, so the preview area has its width. */
+	settle(data_passer);
+
+	gint width = gtk_widget_get_allocated_width(data_passer->drawing_area);
+	gint scale_factor = gtk_widget_get_scale_factor(data_passer->drawing_area);
+	cairo_surface_t *preview = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width * scale_factor,
+														 (width * SLIP_HEIGHT / SLIP_WIDTH + 1) * scale_factor);
+	cairo_surface_set_device_scale(preview, scale_factor, scale_factor);
+
+	gsize heap_at_warmup = 0;
+	guint arena_allocations_at_warmup = 0;
+	guint renderer_allocations_at_warmup = 0;
+	glong resident_at_warmup = 0;
+
+	for (gint frame = 0; frame < SOAK_ITERATIONS; frame++) {
+		if (frame == SOAK_WARMUP) {
+			heap_at_warmup = heap_in_use();
+			arena_allocations_at_warmup = data_passer->frame_arena->heap_allocations;
+			renderer_allocations_at_warmup = data_passer->preview_renderer->heap_allocations;
+			resident_at_warmup = resident_kilobytes();
+		}
+		if (frame % 200 == 199) {
+			select_account(data_passer, (frame / 200) % 2);
+		}
+		if (frame % 100 == 99) {
+			slip_compile(data_passer);
+			slip_redraw_schedule(data_passer, SLIP_DIRTY_PREVIEW, REDRAW_SOURCE_APP);
+		}
+
+		edit_checks(data_passer, frame);
+		settle(data_passer);
+
+		cairo_t *cr = cairo_create(preview);
+		draw_preview(data_passer->drawing_area, cr, data_passer);
+		cairo_destroy(cr);
+
+		if (frame % 10 == 0) {
+			print_to_pdf(data_passer);
+		}
+	}
+	settle(data_passer);
+
+	gsize heap_at_end = heap_in_use();
+	guint arena_allocations_at_end = data_passer->frame_arena->heap_allocations;
+	guint renderer_allocations_at_end = data_passer->preview_renderer->heap_allocations;
+	g_print("%d frames: heap in use %" G_GSIZE_FORMAT " -> %" G_GSIZE_FORMAT " bytes, arena heap allocations %u -> %u, "
+			"preview snapshot heap allocations %u -> %u, resident %ld -> %ld kB\n",
+			SOAK_ITERATIONS, heap_at_warmup, heap_at_end, arena_allocations_at_warmup, arena_allocations_at_end,
+			renderer_allocations_at_warmup, renderer_allocations_at_end, resident_at_warmup, resident_kilobytes());
+
+	cairo_surface_destroy(preview);
+	gtk_widget_destroy(window);
+
+	if (heap_at_end > heap_at_warmup + SOAK_HEAP_SLACK) {
+		g_print("FAIL: heap grew by %" G_GSIZE_FORMAT " bytes\n", heap_at_end - heap_at_warmup);
+		return 1;
+	}
+	if (arena_allocations_at_end != arena_allocations_at_warmup) {
+		g_print("FAIL: the arena kept allocating after the warm-up\n");
+		return 1;
+	}
+	if (renderer_allocations_at_end != renderer_allocations_at_warmup) {
+		g_print("FAIL: snapshots for the preview kept allocating after the warm-up\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,142 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_account_table.c
+ * @brief Tests of account_table.c: interning, list stores holding offsets, and rebuilding the table after the Accounts tab
+ * changes.
+ */
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Records a failed check.
+ * @param passed Whether the check passed.
+ * @param description What was checked.
+ */
+static void check(gboolean passed, const gchar *description) {
+	if (!passed) {
+		g_print("FAIL: %s\n", description);
+		failures++;
+	}
+}
+
+/**
+ * Returns one of the strings of a row of a store.
+ * @param data_passer Pointer to user data.
+ * @param store The store.
+ * @param row Row number.
+ * @param column Column of the string.
+ * @return The string, valid until the table changes.
+ */
+static const gchar *row_string(Data_passer *data_passer, GtkListStore *store, gint row, gint column) {
+	GtkTreeIter iter;
+	gchar path[16];
+	g_snprintf(path, sizeof(path), "%d", row);
+	if (!gtk_tree_model_get_iter_from_string(GTK_TREE_MODEL(store), &iter, path)) {
+		return NULL;
+	}
+	return account_table_column(data_passer->account_table, GTK_TREE_MODEL(store), &iter, column);
+}
+
+/**
+ * Reads the offsets of every row of a store into an array.
+ * @param store The store.
+ * @return Array of \ref Account. Free with `g_array_unref()`.
+ */
+static GArray *store_offsets(GtkListStore *store) {
+	GArray *offsets = g_array_new(FALSE, FALSE, sizeof(Account));
+	GtkTreeIter iter;
+	gboolean valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iter);
+	while (valid) {
+		Account account;
+		gtk_tree_model_get(GTK_TREE_MODEL(store), &iter,
+						   ACCOUNT_NUMBER, &account.number,
+						   ACCOUNT_NAME, &account.name,
+						   DESCRIPTION, &account.description,
+						   ROUTING_NUMBER, &account.routing,
+						   -1);
+		g_array_append_val(offsets, account);
+		valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store), &iter);
+	}
+	return offsets;
+}
+
+/**
+ * Replaces one string of a row of the temporary store, as an edit in the Accounts tab does, and rebuilds the table.
+ * @param data_passer Pointer to user data.
+ * @param row Row number.
+ * @param column Column of the string.
+ * @param text The new string.
+ */
+static void edit_row(Data_passer *data_passer, gint row, gint column, const gchar *text) {
+	GtkTreeIter iter;
+	gchar path[16];
+	g_snprintf(path, sizeof(path), "%d", row);
+	if (gtk_tree_model_get_iter_from_string(GTK_TREE_MODEL(data_passer->list_store_temporary), &iter, path)) {
+		gtk_list_store_set(data_passer->list_store_temporary, &iter, column,
+						   account_table_intern(data_passer->account_table, text), -1);
+		account_table_rebuild(data_passer);
+	}
+}
+
+/**
+ * Runs the checks.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	Data_passer *data_passer = g_new0(Data_passer, 1);
+	data_passer->list_store_master = gtk_list_store_new(N_COLUMNS, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
+	data_passer->list_store_temporary = gtk_list_store_new(N_COLUMNS, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT, G_TYPE_BOOLEAN);
+	data_passer->account_table = account_table_new();
+
+	Account_table *table = data_passer->account_table;
+	account_table_add(table, "1001", "Pat Doe", "Checking", "011000015");
+	account_table_add(table, "1002", "Pat Doe", "Savings", "011000015");
+	account_table_add(table, "1003", "Lee Roe", "Checking", "021000021");
+	const Account *accounts = (const Account *)table->accounts->data;
+	check(accounts[0].name == accounts[1].name && accounts[0].routing == accounts[1].routing &&
+		  accounts[0].description == accounts[2].description, "a repeated string was stored twice");
+	gsize loaded_length = table->strings_length;
+
+	build_list_store(table, data_passer->list_store_master);
+	build_list_store(table, data_passer->list_store_temporary);
+	check(g_strcmp0(row_string(data_passer, data_passer->list_store_master, 2, ACCOUNT_NAME), "Lee Roe") == 0 &&
+		  g_strcmp0(row_string(data_passer, data_passer->list_store_temporary, 1, DESCRIPTION), "Savings") == 0,
+		  "the stores do not read back the accounts loaded");
+
+	/* Editing the temporary store leaves the master store's offsets alone. */
+	GArray *master_before = store_offsets(data_passer->list_store_master);
+	edit_row(data_passer, 0, ACCOUNT_NAME, "Pat Smith");
+	edit_row(data_passer, 0, ACCOUNT_NAME, "Pat Jones");
+	GArray *master_after = store_offsets(data_passer->list_store_master);
+	check(master_before->len == master_after->len &&
+		  memcmp(master_before->data, master_after->data, master_before->len * sizeof(Account)) == 0,
+		  "rebuilding the table moved the master store's strings");
+	check(g_strcmp0(row_string(data_passer, data_passer->list_store_temporary, 0, ACCOUNT_NAME), "Pat Jones") == 0 &&
+		  g_strcmp0(row_string(data_passer, data_passer->list_store_master, 0, ACCOUNT_NAME), "Pat Doe") == 0,
+		  "an edit did not reach the temporary store alone");
+	check(g_strcmp0(row_string(data_passer, data_passer->list_store_temporary, 2, ROUTING_NUMBER), "021000021") == 0,
+		  "a row that was not edited lost its string");
+	check(data_passer->account_table->strings_length == loaded_length + strlen("Pat Jones") + 1,
+		  "the string replaced by the second edit was kept");
+	check(data_passer->account_table->accounts->len == 3, "the table's accounts are not the master store's rows");
+	g_array_unref(master_before);
+	g_array_unref(master_after);
+
+	/* Putting the master's name back leaves no string the edits added. */
+	edit_row(data_passer, 0, ACCOUNT_NAME, "Pat Doe");
+	check(data_passer->account_table->strings_length == loaded_length, "the strings of reverted edits were kept");
+
+	gtk_list_store_clear(data_passer->list_store_master);
+	gtk_list_store_clear(data_passer->list_store_temporary);
+	g_object_unref(data_passer->list_store_master);
+	g_object_unref(data_passer->list_store_temporary);
+	account_table_free(data_passer->account_table);
+	g_free(data_passer);
+	return failures > 0 ? 1 : 0;
+}
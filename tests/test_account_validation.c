@@ -0,0 +1,188 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_account_validation.c
+ * @brief Tests of account_validation.c: a non-digit in each byte of the eight-byte word, lengths on either side of a whole word,
+ * and bad checksums on either side of a batch boundary.
+ */
+
+/** A routing number that passes the ABA checksum. */
+#define TEST_ROUTING_VALID "011000015"
+
+/** The same routing number with the check digit changed, so it fails the checksum. */
+#define TEST_ROUTING_BAD "011000016"
+
+/** Number of accounts checksummed together, \ref VALIDATION_BATCH in account_validation.c. */
+#define TEST_BATCH 256
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Records a failed check.
+ * @param passed Whether the check passed.
+ * @param description What was checked.
+ */
+static void check(gboolean passed, const gchar *description) {
+	if (!passed) {
+		g_print("FAIL: %s\n", description);
+		failures++;
+	}
+}
+
+/**
+ * Validates a table of one account and checks the problems found.
+ * @param number Account number.
+ * @param routing Routing number.
+ * @param expected Problems expected, in order.
+ * @param n_expected Number of problems expected.
+ * @param description What was checked.
+ */
+static void check_account(const gchar *number, const gchar *routing, const Account_problem_type *expected, guint n_expected,
+						  const gchar *description) {
+	Account_table *table = account_table_new();
+	account_table_add(table, number, "Holder", "Checking", routing);
+	GArray *problems = account_validation_run(table);
+
+	gboolean passed = problems->len == n_expected;
+	for (guint i = 0; passed && i < n_expected; i++) {
+		Account_problem *problem = &g_array_index(problems, Account_problem, i);
+		passed = problem->row == 0 && problem->type == expected[i];
+	}
+	if (!passed) {
+		g_print("FAIL: %s: account `%s', routing `%s' gave %u problems, expected %u\n", description, number, routing,
+				problems->len, n_expected);
+		failures++;
+	}
+
+	g_array_unref(problems);
+	account_table_free(table);
+}
+
+/**
+ * Puts a character that is not a digit at every position of a two-word account number and of a routing number. The characters
+ * sit just below `0`, just above `9`, at the end of the row holding the digits, and at `0` and `9` with the high bit set, where
+ * a mistake in the word test would let them pass.
+ */
+static void check_each_lane(void) {
+	static const gchar not_digits[] = {'/', ':', 'a', ' ', (gchar)0xB0, (gchar)0xB9, '?'};
+	const Account_problem_type number_problem[] = {ACCOUNT_PROBLEM_NUMBER_NOT_DIGITS};
+	const Account_problem_type routing_problem[] = {ACCOUNT_PROBLEM_ROUTING_NOT_DIGITS};
+
+	for (gsize c = 0; c < sizeof(not_digits); c++) {
+		for (gint position = 0; position < 16; position++) {
+			gchar number[17];
+			memset(number, '5', 16);
+			number[16] = '\0';
+			number[position] = not_digits[c];
+			gchar *description = g_strdup_printf("byte 0x%02X in lane %d of word %d of the account number",
+												 (guchar)not_digits[c], position % 8, position / 8);
+			check_account(number, TEST_ROUTING_VALID, number_problem, 1, description);
+			g_free(description);
+		}
+		for (gint position = 0; position < 9; position++) {
+			gchar routing[] = TEST_ROUTING_VALID;
+			routing[position] = not_digits[c];
+			gchar *description = g_strdup_printf("byte 0x%02X at position %d of the routing number", (guchar)not_digits[c],
+												 position);
+			check_account("12345678", routing, routing_problem, 1, description);
+			g_free(description);
+		}
+	}
+}
+
+/**
+ * Checks lengths short of a word, a whole word, a word and a byte, and two words and a byte, which is the longest account number.
+ * A non-digit in the last byte is caught whether it falls in a word or in the remainder.
+ */
+static void check_lengths(void) {
+	static const gsize lengths[] = {7, 8, 9, 17};
+	const Account_problem_type number_not_digits[] = {ACCOUNT_PROBLEM_NUMBER_NOT_DIGITS};
+	const Account_problem_type number_length[] = {ACCOUNT_PROBLEM_NUMBER_LENGTH};
+	const Account_problem_type routing_length[] = {ACCOUNT_PROBLEM_ROUTING_LENGTH};
+
+	for (gsize i = 0; i < G_N_ELEMENTS(lengths); i++) {
+		gchar text[32];
+		memset(text, '1', lengths[i]);
+		text[lengths[i]] = '\0';
+		gchar *description = g_strdup_printf("%" G_GSIZE_FORMAT " digits", lengths[i]);
+		check_account(text, TEST_ROUTING_VALID, NULL, 0, description);
+
+		text[lengths[i] - 1] = 'x';
+		check_account(text, TEST_ROUTING_VALID, number_not_digits, 1, description);
+
+		/* Nine digits is the only valid routing number length. The first nine digits are a routing number that passes. */
+		memcpy(text, TEST_ROUTING_VALID, MIN(lengths[i], strlen(TEST_ROUTING_VALID)));
+		text[lengths[i] - 1] = (lengths[i] == 9) ? TEST_ROUTING_VALID[8] : '1';
+		check_account("12345678", text, lengths[i] == 9 ? NULL : routing_length, lengths[i] == 9 ? 0 : 1, description);
+		g_free(description);
+	}
+
+	check_account("123", TEST_ROUTING_VALID, number_length, 1, "3 digits");
+	check_account("123456789012345678", TEST_ROUTING_VALID, number_length, 1, "18 digits");
+}
+
+/**
+ * Validates a table whose routing numbers fail the checksum on the first and last rows and on either side of each batch
+ * boundary, and checks that exactly those rows are reported.
+ * @param n_rows Number of rows in the table.
+ */
+static void check_batch_boundaries(guint n_rows) {
+	Account_table *table = account_table_new();
+	gboolean *bad = g_new0(gboolean, n_rows);
+	bad[0] = TRUE;
+	bad[n_rows - 1] = TRUE;
+	for (guint boundary = TEST_BATCH; boundary < n_rows; boundary += TEST_BATCH) {
+		bad[boundary - 1] = TRUE;
+		bad[boundary] = TRUE;
+	}
+
+	guint n_bad = 0;
+	for (guint row = 0; row < n_rows; row++) {
+		gchar number[16];
+		g_snprintf(number, sizeof(number), "%08u", 10000000 + row);
+		account_table_add(table, number, "Holder", "Checking", bad[row] ? TEST_ROUTING_BAD : TEST_ROUTING_VALID);
+		n_bad += bad[row];
+	}
+
+	GArray *problems = account_validation_run(table);
+	gboolean passed = problems->len == n_bad;
+	for (guint i = 0; passed && i < problems->len; i++) {
+		Account_problem *problem = &g_array_index(problems, Account_problem, i);
+		passed = problem->row < n_rows && bad[problem->row] && problem->type == ACCOUNT_PROBLEM_ROUTING_CHECKSUM &&
+				 (i == 0 || problem->row > g_array_index(problems, Account_problem, i - 1).row);
+	}
+	if (!passed) {
+		g_print("FAIL: %u rows: %u checksum problems found, expected %u in row order\n", n_rows, problems->len, n_bad);
+		failures++;
+	}
+
+	g_array_unref(problems);
+	g_free(bad);
+	account_table_free(table);
+}
+
+/**
+ * Runs the checks.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	check_each_lane();
+	check_lengths();
+
+	const Account_problem_type both[] = {ACCOUNT_PROBLEM_NUMBER_NOT_DIGITS, ACCOUNT_PROBLEM_ROUTING_CHECKSUM};
+	check_account("(Number)", TEST_ROUTING_BAD, both, 2, "problems on one row are reported in order");
+	check(routing_number_valid(TEST_ROUTING_VALID) && !routing_number_valid(TEST_ROUTING_BAD),
+		  "routing_number_valid() disagrees with the batch checksum");
+
+	check_batch_boundaries(TEST_BATCH - 1);
+	check_batch_boundaries(TEST_BATCH);
+	check_batch_boundaries(TEST_BATCH + 1);
+	check_batch_boundaries(2 * TEST_BATCH + 1);
+
+	return failures > 0 ? 1 : 0;
+}
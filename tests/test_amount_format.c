@@ -0,0 +1,92 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_amount_format.c
+ * @brief Tests of amount_format_cents(), amount_format_digits(), and amount_parse_cents().
+ */
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Checks that an amount formats to the expected text.
+ * @param cents Amount in cents.
+ * @param separators Separators to format with.
+ * @param expected Expected text.
+ */
+static void check_format(gint64 cents, const Amount_separators *separators, const gchar *expected) {
+	gchar buffer[AMOUNT_BUFFER_SIZE];
+	gsize length = amount_format_cents(cents, separators, buffer);
+	if (g_strcmp0(buffer, expected) != 0 || length != strlen(expected)) {
+		g_print("FAIL: %" G_GINT64_FORMAT " formatted as `%s', expected `%s'\n", cents, buffer, expected);
+		failures++;
+	}
+}
+
+/**
+ * Checks that text parses to the expected amount, or fails to parse.
+ * @param text Text to parse.
+ * @param separators Separators to parse with.
+ * @param valid Whether the text should parse.
+ * @param expected Expected amount in cents if it should.
+ */
+static void check_parse(const gchar *text, const Amount_separators *separators, gboolean valid, gint64 expected) {
+	gint64 cents = 12345;
+	gboolean parsed = amount_parse_cents(text, separators, &cents);
+	if (parsed != valid || (valid && cents != expected) || (!valid && cents != 12345)) {
+		g_print("FAIL: `%s' parsed as %s %" G_GINT64_FORMAT "\n", text, parsed ? "valid" : "invalid", cents);
+		failures++;
+	}
+}
+
+/**
+ * Runs the checks.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	const Amount_separators grouped = {',', '.'};
+	const Amount_separators european = {'.', ','};
+	gchar buffer[AMOUNT_BUFFER_SIZE];
+
+	check_format(0, &grouped, "0.00");
+	check_format(7, &grouped, "0.07");
+	check_format(-7, &grouped, "-0.07");
+	check_format(99999, &grouped, "999.99");
+	check_format(100000, &grouped, "1,000.00");
+	check_format(123456700, &grouped, "1,234,567.00");
+	check_format(123456700, &AMOUNT_SEPARATORS_PLAIN, "1234567.00");
+	check_format(123456700, &european, "1.234.567,00");
+	check_format(G_MAXINT64, &grouped, "92,233,720,368,547,758.07");
+	check_format(G_MININT64, &grouped, "-92,233,720,368,547,758.08");
+
+	amount_format_digits(5100372, 0, buffer);
+	if (g_strcmp0(buffer, "5100372") != 0) {
+		g_print("FAIL: digits `%s'\n", buffer);
+		failures++;
+	}
+	amount_format_digits(12, 5, buffer);
+	if (g_strcmp0(buffer, "   12") != 0) {
+		g_print("FAIL: padded digits `%s'\n", buffer);
+		failures++;
+	}
+
+	check_parse("1,234.56", &grouped, TRUE, 123456);
+	check_parse("  -12.5 ", &grouped, TRUE, -1250);
+	check_parse("7", &grouped, TRUE, 700);
+	check_parse(".005", &grouped, TRUE, 1);
+	check_parse("-.005", &grouped, TRUE, -1);
+	check_parse("1.234,56", &european, TRUE, 123456);
+	check_parse("92,233,720,368,547,758.07", &grouped, TRUE, G_MAXINT64);
+	check_parse("-92,233,720,368,547,758.08", &grouped, TRUE, G_MININT64);
+	check_parse("92,233,720,368,547,758.08", &grouped, FALSE, 0);
+	check_parse("", &grouped, FALSE, 0);
+	check_parse("-", &grouped, FALSE, 0);
+	check_parse("12x", &grouped, FALSE, 0);
+	check_parse("1,234.56", &AMOUNT_SEPARATORS_PLAIN, FALSE, 0);
+
+	return failures > 0 ? 1 : 0;
+}
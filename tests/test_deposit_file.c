@@ -0,0 +1,88 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_deposit_file.c
+ * @brief Tests of deposit_file.c: account numbers that cannot name a file, deposits that cannot be saved, and a round trip.
+ */
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Records a failed check.
+ * @param passed Whether the check passed.
+ * @param description What was checked.
+ */
+static void check(gboolean passed, const gchar *description) {
+	if (!passed) {
+		g_print("FAIL: %s\n", description);
+		failures++;
+	}
+}
+
+/**
+ * Runs the checks in a temporary directory.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	gchar *directory = g_dir_make_tmp("deposit-slips-test-XXXXXX", NULL);
+	gchar *path = g_build_filename(directory, "12345.dslip", NULL);
+	GtkListStore *checks = gtk_list_store_new(SLIP_COLUMNS, G_TYPE_STRING, G_TYPE_BOOLEAN, G_TYPE_INT64);
+	gchar *saved_path;
+
+	check((saved_path = deposit_file_path("../x")) == NULL, "`../x' names a deposit file");
+	g_free(saved_path);
+	check((saved_path = deposit_file_path("12/34")) == NULL, "`12/34' names a deposit file");
+	g_free(saved_path);
+	check((saved_path = deposit_file_path("")) == NULL, "an empty account number names a deposit file");
+	g_free(saved_path);
+	check((saved_path = deposit_file_path("123456789012345678901234567890123")) == NULL, "a 33-digit account number names a deposit file");
+	g_free(saved_path);
+	saved_path = deposit_file_path("12345");
+	check(saved_path != NULL && g_str_has_prefix(saved_path, DEPOSITS_DIRECTORY), "`12345' is not saved in the deposits directory");
+	g_free(saved_path);
+
+	check(!deposit_file_save(path, "12345", GTK_TREE_MODEL(checks)), "a deposit with no checks was saved");
+	check(!g_file_test(path, G_FILE_TEST_EXISTS), "a file was left for a deposit with no checks");
+
+	gint64 amounts[] = {1, 99999, G_MAXINT64};
+	for (guint i = 0; i < G_N_ELEMENTS(amounts); i++) {
+		gtk_list_store_insert_with_values(checks, NULL, -1, CHECK_AMOUNT, "", CHECK_RADIO, FALSE, CHECK_CENTS, amounts[i], -1);
+	}
+	check(!deposit_file_save(path, "12a45", GTK_TREE_MODEL(checks)), "account number `12a45' was saved");
+	check(deposit_file_save(path, "12345", GTK_TREE_MODEL(checks)), "a deposit of three checks was not saved");
+
+	Deposit_file *file = deposit_file_open(path);
+	check(file != NULL, "the saved deposit did not open");
+	if (file != NULL) {
+		check(g_strcmp0(file->account_number, "12345") == 0, "the account number did not survive the round trip");
+		check(file->n_checks == G_N_ELEMENTS(amounts), "the number of checks did not survive the round trip");
+		for (guint i = 0; i < file->n_checks && i < G_N_ELEMENTS(amounts); i++) {
+			check(file->cents[i] == amounts[i], "an amount did not survive the round trip");
+		}
+		deposit_file_close(file);
+	}
+
+	/* A truncated file is refused. */
+	gchar *contents;
+	gsize length;
+	g_file_get_contents(path, &contents, &length, NULL);
+	g_file_set_contents(path, contents, length - 1, NULL);
+	g_free(contents);
+	file = deposit_file_open(path);
+	check(file == NULL, "a truncated deposit opened");
+	if (file != NULL) {
+		deposit_file_close(file);
+	}
+
+	g_unlink(path);
+	g_rmdir(directory);
+	g_free(path);
+	g_free(directory);
+	g_object_unref(checks);
+	return failures > 0 ? 1 : 0;
+}
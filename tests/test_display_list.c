@@ -0,0 +1,139 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_display_list.c
+ * @brief Tests of slip_set_text_op(): text that fits is kept whole, and longer text is cut at a whole UTF-8 character. Also tests
+ * slip_display_list_copy_into(), which the preview uses to snapshot the slip without allocating.
+ */
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Checks that text is stored in an operation as expected.
+ * @param text Text written into the operation.
+ * @param expected_length Number of bytes of `text` the operation should keep.
+ */
+static void check_text(const gchar *text, gsize expected_length) {
+	Slip_op op;
+	slip_set_text_op(&op, FALSE, SLIP_FONT_SANS, 9, 0, 0, text, 0);
+	if (strlen(op.text) != expected_length || strncmp(op.text, text, expected_length) != 0 ||
+		!g_utf8_validate(op.text, -1, NULL)) {
+		g_print("FAIL: kept %" G_GSIZE_FORMAT " bytes of a %" G_GSIZE_FORMAT "-byte text, expected %" G_GSIZE_FORMAT "\n",
+				strlen(op.text), strlen(text), expected_length);
+		failures++;
+	}
+}
+
+/**
+ * Compiles a list of boxes in two line widths, so they stroke in two batches, each with a label.
+ * @param list Pointer to the list.
+ * @param n_boxes Number of boxes.
+ */
+static void compile_boxes(Slip_display_list *list, gint n_boxes) {
+	slip_display_list_clear(list);
+	for (gint box = 0; box < n_boxes; box++) {
+		slip_add_rectangle(list, 10, 10 + box * 9, 400, 9, box % 2 ? 1.0 : 0.5, 0);
+		slip_add_text(list, SLIP_FONT_SANS, 6, 12, 17 + box * 9, "Check", 0);
+	}
+	slip_display_list_batch_strokes(list);
+}
+
+/**
+ * Returns the checksum of everything a list draws.
+ * @param list Pointer to the list.
+ * @return The checksum as hexadecimal digits. Free with `g_free()`.
+ */
+static gchar *list_checksum(const Slip_display_list *list) {
+	GChecksum *checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	slip_display_list_checksum(list, checksum);
+	gchar *digits = g_strdup(g_checksum_get_string(checksum));
+	g_checksum_free(checksum);
+	return digits;
+}
+
+/**
+ * Copies a list over an earlier copy and checks that the copy draws the same thing and that the expected number of arrays grew.
+ * @param copy Pointer to the earlier copy.
+ * @param list Pointer to the list copied.
+ * @param expect_growth Whether copying should report growing arrays.
+ * @param description What was checked.
+ */
+static void check_copy_into(Slip_display_list *copy, const Slip_display_list *list, gboolean expect_growth, const gchar *description) {
+	guint grown = slip_display_list_copy_into(copy, list);
+	gchar *expected = list_checksum(list);
+	gchar *copied = list_checksum(copy);
+
+	if (g_strcmp0(expected, copied) != 0 || (grown > 0) != expect_growth) {
+		g_print("FAIL: %s: %u arrays grew, and the copy %s the list\n", description, grown,
+				g_strcmp0(expected, copied) == 0 ? "matches" : "does not match");
+		failures++;
+	}
+	g_free(expected);
+	g_free(copied);
+}
+
+/**
+ * Runs the checks.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	gsize room = SLIP_OP_TEXT_SIZE - 1;
+	GString *text = g_string_new(NULL);
+
+	check_text("", 0);
+	check_text("Account Holder", strlen("Account Holder"));
+
+	/* ASCII exactly filling the buffer, and one byte too long. */
+	while (text->len < room) {
+		g_string_append_c(text, 'a');
+	}
+	check_text(text->str, room);
+	g_string_append_c(text, 'b');
+	check_text(text->str, room);
+
+	/* A two-, three-, and four-byte character straddling the end of the buffer at every offset. */
+	const gchar *characters[] = {"\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x92\xb0"};
+	for (guint c = 0; c < G_N_ELEMENTS(characters); c++) {
+		gsize width = strlen(characters[c]);
+		for (gsize offset = 0; offset < width; offset++) {
+			g_string_truncate(text, 0);
+			while (text->len < room - width + 1 + offset) {
+				g_string_append_c(text, 'a');
+			}
+			gsize before = text->len;
+			g_string_append(text, characters[c]);
+			g_string_append(text, "tail");
+			check_text(text->str, before + width <= room ? before + width : before);
+		}
+	}
+
+	/* A name made only of multibyte characters. */
+	g_string_truncate(text, 0);
+	while (text->len < 3 * SLIP_OP_TEXT_SIZE) {
+		g_string_append(text, "\xc3\xa9");
+	}
+	check_text(text->str, room - room % 2);
+
+	g_string_free(text, TRUE);
+
+	/* A snapshot reused for the same slip, or a smaller one, allocates nothing; a larger slip grows it. */
+	Slip_display_list *list = slip_display_list_new();
+	Slip_display_list *copy = slip_display_list_new();
+	compile_boxes(list, 10);
+	check_copy_into(copy, list, TRUE, "first copy into an empty list");
+	check_copy_into(copy, list, FALSE, "second copy of the same list");
+	compile_boxes(list, 4);
+	check_copy_into(copy, list, FALSE, "copy of a smaller list");
+	compile_boxes(list, 10);
+	check_copy_into(copy, list, TRUE, "copy of a list larger than the last copy");
+	compile_boxes(list, 1);
+	check_copy_into(copy, list, FALSE, "copy of a list with fewer batches");
+	slip_display_list_free(copy);
+	slip_display_list_free(list);
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_history_store.c
+ * @brief Tests of history_store.c: queries across a sealed segment and the active one, and indexes damaged on disk.
+ */
+
+/** Records in a full segment, \ref HISTORY_SEGMENT_RECORDS in history_store.c. */
+#define TEST_SEGMENT_RECORDS 65536
+
+/** Records appended: a full segment, which is sealed, and a few in the active segment. */
+#define TEST_RECORDS (TEST_SEGMENT_RECORDS + 100)
+
+/** Number of accounts the records are spread over. */
+#define TEST_ACCOUNTS 1000
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Checks the number of records found for one account and for a range of totals.
+ * @param store Pointer to the store.
+ * @param when Description of the store's state, for the failure message.
+ */
+static void check_queries(History_store *store, const gchar *when) {
+	/* Records i with i % TEST_ACCOUNTS == 7. */
+	guint expected_account = TEST_RECORDS / TEST_ACCOUNTS + (TEST_RECORDS % TEST_ACCOUNTS > 7 ? 1 : 0);
+	GArray *found = history_store_find_account(store, "1007", 20260101, 20261231);
+	if (found->len != expected_account) {
+		g_print("FAIL: %s: %u deposits of account 1007, expected %u\n", when, found->len, expected_account);
+		failures++;
+	}
+	g_array_unref(found);
+
+	/* Totals are i cents. */
+	found = history_store_find_amount(store, 1000, 1999);
+	if (found->len != 1000) {
+		g_print("FAIL: %s: %u deposits between $10.00 and $19.99, expected 1000\n", when, found->len);
+		failures++;
+	}
+	g_array_unref(found);
+}
+
+/**
+ * Points every entry of an index by account number and date past the last record, and cuts an index by total amount short.
+ * @param account_path Path of the index by account number and date.
+ * @param amount_path Path of the index by total amount.
+ */
+static void damage_indexes(const gchar *account_path, const gchar *amount_path) {
+	/* Entries are an account number of 32 bytes, a date, and the record number. */
+	const gsize entry_size = 32 + 2 * sizeof(guint32);
+	const guint32 out_of_range = G_MAXUINT32;
+	gchar *contents;
+	gsize length;
+
+	g_file_get_contents(account_path, &contents, &length, NULL);
+	for (gsize offset = 0; offset + entry_size <= length; offset += entry_size) {
+		memcpy(contents + offset + 32 + sizeof(guint32), &out_of_range, sizeof(out_of_range));
+	}
+	g_file_set_contents(account_path, contents, length, NULL);
+	g_free(contents);
+
+	g_file_get_contents(amount_path, &contents, &length, NULL);
+	g_file_set_contents(amount_path, contents, length / 2, NULL);
+	g_free(contents);
+}
+
+/**
+ * Fills a store, queries it, damages the sealed segment's indexes, and queries it again.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	gchar *directory = g_dir_make_tmp("deposit-slips-history-XXXXXX", NULL);
+	History_store *store = history_store_open(directory);
+
+	for (guint i = 0; i < TEST_RECORDS; i++) {
+		History_record record = {0};
+		record.date = 20260101 + (i % 28);
+		record.n_checks = 1;
+		record.total_cents = i;
+		record.cents[0] = i;
+		g_snprintf(record.account_number, sizeof(record.account_number), "%u", 1000 + i % TEST_ACCOUNTS);
+		history_store_append(store, &record);
+	}
+	if (store->segments->len != 1) {
+		g_print("FAIL: %u sealed segments, expected 1\n", store->segments->len);
+		failures++;
+	}
+	check_queries(store, "before closing");
+	history_store_close(store);
+
+	gchar *account_path = g_build_filename(directory, "000001.by_account", NULL);
+	gchar *amount_path = g_build_filename(directory, "000001.by_amount", NULL);
+	damage_indexes(account_path, amount_path);
+
+	store = history_store_open(directory);
+	check_queries(store, "after damaging the indexes");
+	history_store_close(store);
+
+	GDir *dir = g_dir_open(directory, 0, NULL);
+	const gchar *name;
+	while ((name = g_dir_read_name(dir)) != NULL) {
+		gchar *path = g_build_filename(directory, name, NULL);
+		g_unlink(path);
+		g_free(path);
+	}
+	g_dir_close(dir);
+	g_rmdir(directory);
+	g_free(account_path);
+	g_free(amount_path);
+	g_free(directory);
+	return failures > 0 ? 1 : 0;
+}
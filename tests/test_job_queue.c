@@ -0,0 +1,141 @@
+#include <gtk/gtk.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_job_queue.c
+ * @brief Stress test of job_queue.c with several producers and consumers.
+ *
+ * Three producer threads each push \ref TEST_JOBS_PER_PRODUCER numbered jobs through a small queue, so the queue is often full
+ * and often empty, while two consumer threads pop with job_queue_pop_wait() until the queue is closed. Every job must be popped
+ * exactly once. A second check pushes a batch through a \ref Job_queue_source and expects the main loop to drain it in a single
+ * dispatch.
+ */
+
+/** Number of producer threads. */
+#define TEST_PRODUCERS 3
+
+/** Number of consumer threads. */
+#define TEST_CONSUMERS 2
+
+/** Number of jobs each producer pushes. */
+#define TEST_JOBS_PER_PRODUCER 1000000
+
+/** Capacity of the queue, small enough to keep producers waiting on consumers. */
+#define TEST_CAPACITY 64
+
+/** Number of jobs pushed through the main loop source. */
+#define TEST_SOURCE_JOBS 100
+
+/** Queue shared by the threads. */
+static Job_queue *queue;
+
+/** Number of times each job was popped, indexed by job number. */
+static gint *times_popped;
+
+/**
+ * Pushes one producer's jobs, yielding while the queue is full. Jobs are numbered from 1, because `NULL` is not a job.
+ * @param data First job number minus one, as a pointer.
+ * @return `NULL`.
+ */
+static gpointer produce(gpointer data) {
+	guint first = GPOINTER_TO_UINT(data) + 1;
+	for (guint job = first; job < first + TEST_JOBS_PER_PRODUCER; job++) {
+		while (!job_queue_push(queue, GUINT_TO_POINTER(job))) {
+			g_thread_yield();
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Pops jobs until the queue is closed and empty, counting each job.
+ * @param data Unused.
+ * @return `NULL`.
+ */
+static gpointer consume(gpointer data) {
+	gpointer job;
+	while ((job = job_queue_pop_wait(queue)) != NULL) {
+		g_atomic_int_inc(&times_popped[GPOINTER_TO_UINT(job) - 1]);
+	}
+	return NULL;
+}
+
+/**
+ * Drains the source's queue, counting the dispatches and the jobs.
+ * @param data Pointer to two counters: dispatches and jobs.
+ * @return `G_SOURCE_CONTINUE`.
+ */
+static gboolean drain(gpointer data) {
+	guint *counts = (guint *)data;
+	counts[0]++;
+	while (job_queue_pop(((Job_queue_source *)g_main_current_source())->queue) != NULL) {
+		counts[1]++;
+	}
+	return G_SOURCE_CONTINUE;
+}
+
+/**
+ * Runs the stress test and the batching check.
+ * @return 0 if every job was popped exactly once and the batch took one dispatch, 1 otherwise.
+ */
+int main(void) {
+	GThread *producers[TEST_PRODUCERS];
+	GThread *consumers[TEST_CONSUMERS];
+	guint total = TEST_PRODUCERS * TEST_JOBS_PER_PRODUCER;
+	guint lost = 0;
+	guint duplicated = 0;
+
+	queue = job_queue_new(TEST_CAPACITY);
+	times_popped = g_new0(gint, total);
+	for (gint i = 0; i < TEST_CONSUMERS; i++) {
+		consumers[i] = g_thread_new("consumer", consume, NULL);
+	}
+	for (gint i = 0; i < TEST_PRODUCERS; i++) {
+		producers[i] = g_thread_new("producer", produce, GUINT_TO_POINTER(i * TEST_JOBS_PER_PRODUCER));
+	}
+	for (gint i = 0; i < TEST_PRODUCERS; i++) {
+		g_thread_join(producers[i]);
+	}
+	job_queue_close(queue);
+	for (gint i = 0; i < TEST_CONSUMERS; i++) {
+		g_thread_join(consumers[i]);
+	}
+
+	for (guint job = 0; job < total; job++) {
+		if (times_popped[job] == 0) {
+			lost++;
+		} else if (times_popped[job] > 1) {
+			duplicated++;
+		}
+	}
+	g_print("%u jobs from %d producers to %d consumers: %u lost, %u duplicated\n", total, TEST_PRODUCERS, TEST_CONSUMERS, lost,
+			duplicated);
+	g_free(times_popped);
+	job_queue_free(queue);
+
+	/* A batch pushed before the main loop runs is drained by one dispatch. */
+	guint counts[2] = {0, 0};
+	Job_queue *completions = job_queue_new(TEST_SOURCE_JOBS);
+	GSource *source = job_queue_source_new(completions, drain, counts);
+	for (guint job = 1; job <= TEST_SOURCE_JOBS; job++) {
+		job_queue_source_push(source, GUINT_TO_POINTER(job));
+	}
+	while (g_main_context_iteration(NULL, FALSE)) {
+	}
+	g_print("%d jobs through the main loop source in %u dispatches\n", TEST_SOURCE_JOBS, counts[0]);
+	g_source_destroy(source);
+	g_source_unref(source);
+	job_queue_free(completions);
+
+	if (lost > 0 || duplicated > 0) {
+		g_print("FAIL: jobs were lost or duplicated\n");
+		return 1;
+	}
+	if (counts[0] != 1 || counts[1] != TEST_SOURCE_JOBS) {
+		g_print("FAIL: the batch was not drained in one dispatch\n");
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+#include <constants.h>
+#include <headers.h>
+
+/**
+ * @file test_render_cache.c
+ * @brief Tests of render_cache.c: the path printing sends, eviction of the least recently used file, files removed behind the
+ * cache's back, and keys that tell paper sizes apart.
+ */
+
+/** Number of failed checks. */
+static gint failures = 0;
+
+/**
+ * Records a failed check.
+ * @param passed Whether the check passed.
+ * @param description What was checked.
+ */
+static void check(gboolean passed, const gchar *description) {
+	if (!passed) {
+		g_print("FAIL: %s\n", description);
+		failures++;
+	}
+}
+
+/**
+ * Checks that a key's file in the cache holds the expected output.
+ * @param cache Pointer to the cache.
+ * @param key The key.
+ * @param expected Expected contents of the file.
+ * @param description What was checked.
+ */
+static void check_file(Render_cache *cache, const gchar *key, const gchar *expected, const gchar *description) {
+	gchar *path = render_cache_lookup_path(cache, key);
+	gchar *contents = NULL;
+	check(path != NULL && g_file_get_contents(path, &contents, NULL, NULL) && g_strcmp0(contents, expected) == 0, description);
+	g_free(contents);
+	g_free(path);
+}
+
+/**
+ * Runs the checks in a temporary directory.
+ * @return 0 if every check passed, 1 otherwise.
+ */
+int main(void) {
+	gchar *directory = g_dir_make_tmp("deposit-slips-test-XXXXXX", NULL);
+	/* Room for two of the outputs below, not three. */
+	Render_cache *cache = render_cache_open(directory, 20);
+	GBytes *first = g_bytes_new_static("first page", 10);
+	GBytes *second = g_bytes_new_static("second pg.", 10);
+	GBytes *third = g_bytes_new_static("third page", 10);
+
+	check(render_cache_lookup_path(cache, "aa") == NULL, "an empty cache found a file");
+	check(render_cache_store(cache, "aa", first), "the first output was not stored");
+	g_usleep(2000);
+	check(render_cache_store(cache, "bb", second), "the second output was not stored");
+	check_file(cache, "aa", "first page", "the first output's file does not hold it");
+	check_file(cache, "bb", "second pg.", "the second output's file does not hold it");
+
+	/* Looking up the first output makes it the most recently used, so the third evicts the second. */
+	g_usleep(2000);
+	g_free(render_cache_lookup_path(cache, "aa"));
+	g_usleep(2000);
+	check(render_cache_store(cache, "cc", third), "the third output was not stored");
+	check(render_cache_lookup_path(cache, "bb") == NULL, "the least recently used output was not evicted");
+	check_file(cache, "aa", "first page", "the recently used output was evicted");
+	check_file(cache, "cc", "third page", "the third output's file does not hold it");
+
+	gchar *path = render_cache_lookup_path(cache, "aa");
+	g_unlink(path);
+	g_free(path);
+	check(render_cache_lookup_path(cache, "aa") == NULL, "a removed file was still found");
+	check(cache->total_bytes == 10, "the removed file is still counted in the cache's size");
+	GBytes *large = g_bytes_new_static("longer than the whole cache", 27);
+	check(!render_cache_store(cache, "dd", large), "an output larger than the cache was stored");
+	g_bytes_unref(large);
+
+	render_cache_close(cache);
+	cache = render_cache_open(directory, 20);
+	check_file(cache, "cc", "third page", "the output was not found after reopening the cache");
+	render_cache_close(cache);
+
+	/* The same slip on letter and A4 paper are different files. */
+	Slip_display_list *front = slip_display_list_new();
+	gchar *letter = render_cache_key(front, NULL, 612, 792);
+	gchar *letter_again = render_cache_key(front, NULL, 612, 792);
+	gchar *a4 = render_cache_key(front, NULL, 595.28, 841.89);
+	check(g_strcmp0(letter, letter_again) == 0, "the same slip on the same paper has two keys");
+	check(g_strcmp0(letter, a4) != 0, "the key does not depend on the paper size");
+	g_free(letter);
+	g_free(letter_again);
+	g_free(a4);
+	slip_display_list_free(front);
+
+	g_bytes_unref(first);
+	g_bytes_unref(second);
+	g_bytes_unref(third);
+	gchar *remaining = g_build_filename(directory, "cc.pdf", NULL);
+	g_unlink(remaining);
+	g_free(remaining);
+	g_rmdir(directory);
+	g_free(directory);
+	return failures > 0 ? 1 : 0;
+}
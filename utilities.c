@@ -17,14 +17,17 @@
 	if the child node is not found.
 */
 GtkWidget *get_child_from_parent(GtkWidget *parent, const gchar *child_name) {
-	GList *children_list = gtk_container_get_children(GTK_CONTAINER(parent));
+	GList *children_list = gtk_container_get_children(GTK_CONTAINER(parent)); /* Memory freed below. */
+	GtkWidget *child = NULL;
 
-	do {
-		if (g_strcmp0(gtk_widget_get_name(children_list->data), child_name) == 0) {
-			return children_list->data;
+	for (GList *current = children_list; current != NULL; current = g_list_next(current)) {
+		if (g_strcmp0(gtk_widget_get_name(current->data), child_name) == 0) {
+			child = current->data;
+			break;
 		}
-	} while ((children_list = g_list_next(children_list)) != NULL);
-	return NULL;
+	}
+	g_list_free(children_list);
+	return child;
 }
 
 /**
@@ -71,15 +74,6 @@ void set_boolean_value(JsonBuilder *builder, gchar *key, gboolean value) {
 	json_builder_add_boolean_value(builder, value);
 }
 
-/**
-Frees memory allocated to a GSList of accounts. Called from free_memory().
-* @param data Pointer to user data, which is to an Account entry in a GSList.
-*/
-void free_gslist_account(gpointer data) {
-	Account *account = (Account *)data;
-	g_free(account);
-}
-
 /**
  * Frees memory in the master and temporary account lists and other string data in a `Data_passer`. This callback fires after the user destroys the main application window.
  * @param window The parent node.
@@ -88,11 +82,56 @@ void free_gslist_account(gpointer data) {
 void free_memory(GtkWidget *window, gpointer data) {
 	Data_passer *data_passer = (Data_passer *)data;
 
+	/* Stop following the stores before clearing them, as the delete buttons may already be gone. Clearing the master store
+	changes the selection in the Slip tab's accounts list, so stop switching deposits first. */
+	if (GTK_IS_TREE_VIEW(data_passer->checks_accounts_treeview)) {
+		g_signal_handlers_disconnect_by_func(gtk_tree_view_get_selection(GTK_TREE_VIEW(data_passer->checks_accounts_treeview)),
+											 G_CALLBACK(slip_account_changed), data_passer);
+	}
+	if (data_passer->session != NULL) {
+		deposit_session_free(data_passer->session);
+		data_passer->session = NULL;
+		data_passer->deposit = NULL;
+	}
+	if (data_passer->account_selection != NULL) {
+		selection_set_free(data_passer->account_selection);
+	}
+
 	/* Free memory allocated to the master and temporary list stores. */
 	gtk_list_store_clear(data_passer->list_store_master);
 	gtk_list_store_clear(data_passer->list_store_temporary);
+	g_object_unref(data_passer->list_store_master);
+	g_object_unref(data_passer->list_store_temporary);
+	account_table_free(data_passer->account_table);
 	g_object_unref(data_passer->css_provider);
-	 g_object_unref( data_passer->application_icon);
+	if (data_passer->application_icon != NULL) {
+		g_object_unref(data_passer->application_icon);
+	}
+	if (data_passer->layout_monitor != NULL) {
+		g_file_monitor_cancel(data_passer->layout_monitor);
+		g_object_unref(data_passer->layout_monitor);
+	}
+	slip_redraw_cancel(data_passer);
+	/* Stop the render thread before freeing what it draws with. */
+	if (data_passer->preview_renderer != NULL) {
+		preview_renderer_free(data_passer->preview_renderer);
+	}
+	g_free(data_passer->frame_stats);
+	if (data_passer->slip_front != NULL) {
+		slip_display_list_free(data_passer->slip_front);
+		slip_display_list_free(data_passer->slip_back);
+	}
+	text_metrics_free();
+	routing_directory_close();
+	if (data_passer->history != NULL) {
+		history_store_close(data_passer->history);
+	}
+	if (data_passer->render_cache != NULL) {
+		render_cache_close(data_passer->render_cache);
+	}
+	frame_arena_free(data_passer->frame_arena);
+	slip_layout_unref(data_passer->layout);
+	slip_layout_unref(data_passer->layout_pending);
 	g_free(data_passer);
 }
 
@@ -101,5 +140,5 @@ void free_memory(GtkWidget *window, gpointer data) {
  * @param data_passer User data
  */
 gint number_of_checks(Data_passer *data_passer) {
-	return gtk_tree_model_iter_n_children(GTK_TREE_MODEL(data_passer->checks_store), NULL);
+	return gtk_tree_model_iter_n_children(GTK_TREE_MODEL(data_passer->deposit->checks_store), NULL);
 }